@@ -1098,6 +1098,24 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *ctx, const c
  */
 CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *context, const char *buffer, unsigned int buffer_len, cp_status_t *error) CP_GCC_NONNULL(1, 2);
 
+/**
+ * Loads the plug-in descriptor of the plug-in installed at the specified path
+ * from a copy of its descriptor file in memory, as if it had been loaded with
+ * ::cp_load_plugin_descriptor. This allows a caller that keeps the descriptors
+ * of unchanged plug-ins to skip reading them from disk. The plug-in is not
+ * installed to the context. The caller must release the returned information
+ * by calling ::cp_release_plugin_info when it does not need the information
+ * anymore.
+ * 
+ * @param ctx the plug-in context
+ * @param path the installation path of the plug-in, or NULL if it has none
+ * @param buffer the buffer containing the plug-in descriptor.
+ * @param buffer_len the length of the buffer.
+ * @param status a pointer to the location where status code is to be stored, or NULL
+ * @return pointer to the information structure or NULL if error occurs
+ */
+CP_C_API cp_plugin_info_t * cp_load_cached_plugin_descriptor(cp_context_t *context, const char *path, const char *buffer, unsigned int buffer_len, cp_status_t *error) CP_GCC_NONNULL(1, 3);
+
 /**
  * Installs the plug-in described by the specified plug-in information
  * structure to the specified plug-in context. The plug-in information
@@ -1186,8 +1186,11 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor(cp_context_t *context, con
 }
 
 CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *context, const char *buffer, unsigned int buffer_len, cp_status_t *error) {
+	return cp_load_cached_plugin_descriptor(context, NULL, buffer, buffer_len, error);
+}
+
+CP_C_API cp_plugin_info_t * cp_load_cached_plugin_descriptor(cp_context_t *context, const char *path, const char *buffer, unsigned int buffer_len, cp_status_t *error) {
 	char *file = NULL;
-  const char *path = "memory";
 	cp_status_t status = CP_OK;
 	XML_Parser parser = NULL;
 	ploader_context_t *plcontext = NULL;
@@ -1197,8 +1200,11 @@ CP_C_API cp_plugin_info_t * cp_load_plugin_descriptor_from_memory(cp_context_t *
 	CHECK_NOT_NULL(buffer);
 	cpi_lock_context(context);
 	cpi_check_invocation(context, CPI_CF_ANY, __func__);
+	if (path == NULL) {
+		path = "memory";
+	}
 	do {
-		int path_len = 6;
+		int path_len = strlen(path);
 		file = malloc((path_len + 1) * sizeof(char));
 		if (file == NULL) {
 			status = CP_ERR_RESOURCE;
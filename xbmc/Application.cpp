@@ -41,6 +41,7 @@
 #include "utils/LCDFactory.h"
 #endif
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUIFrameProfiler.h"
 #include "utils/LangCodeExpander.h"
 #include "GUIInfoManager.h"
 #include "playlists/PlayListFactory.h"
@@ -65,6 +66,7 @@
 #include "filesystem/StackDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "filesystem/DllLibCurl.h"
+#include "filesystem/HTTPFetchService.h"
 #include "filesystem/MythSession.h"
 #include "filesystem/PluginDirectory.h"
 #ifdef HAS_FILESYSTEM_SAP
@@ -2113,6 +2115,8 @@ void CApplication::Render()
   g_renderManager.UpdateResolution();
   g_renderManager.ManageCaptures();
 
+  CGUIFrameProfiler::Instance().FrameEnd();
+
   {
     CSingleLock lock(m_frameMutex);
     if(m_frameCount > 0 && decrement)
@@ -2625,6 +2629,8 @@ bool CApplication::OnAction(const CAction &action)
   {
     CGUIControlProfiler::Instance().SetOutputFile(_P("special://home/guiprofiler.xml"));
     CGUIControlProfiler::Instance().Start();
+    CGUIFrameProfiler::Instance().SetOutputFile(_P("special://home/guiprofiler.json"));
+    CGUIFrameProfiler::Instance().Start(CGUIControlProfiler::Instance().GetMaxFrameCount());
     return true;
   }
   if (action.GetID() == ACTION_SHOW_PLAYLIST)
@@ -3282,6 +3288,7 @@ void CApplication::Stop(int exitCode)
 
     // cancel any jobs from the jobmanager
     CJobManager::GetInstance().CancelJobs();
+    CHTTPFetchService::Get().Stop();
 
     g_alarmClock.StopThread();
 
@@ -3325,6 +3332,7 @@ void CApplication::Stop(int exitCode)
     if (videoScan)
       videoScan->StopScanning();
 
+    m_applicationMessenger.LogPostedStats();
     m_applicationMessenger.Cleanup();
 
     StopServices();
@@ -56,6 +56,8 @@
 #include "storage/MediaManager.h"
 #include "guilib/LocalizeStrings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Atomics.h"
 #ifdef HAS_PYTHON
 #include "interfaces/python/xbmcmodule/GUIPythonWindowDialog.h"
 #include "interfaces/python/xbmcmodule/GUIPythonWindowXMLDialog.h"
@@ -91,6 +93,19 @@ void CDelayedMessage::Process()
     g_application.getApplicationMessenger().SendMessage(m_msg, false);
 }
 
+CApplicationMessenger::CApplicationMessenger()
+{
+  m_postedHead = 0;
+  m_postedCount = 0;
+  m_sequence = 0;
+  memset(&m_postedStats, 0, sizeof(m_postedStats));
+  memset(&m_lastPostedStats, 0, sizeof(m_lastPostedStats));
+
+  m_critSection.set_name("CApplicationMessenger");
+  m_critBuffer.set_name("CApplicationMessenger buffer");
+  m_critPosted.set_name("CApplicationMessenger posted");
+}
+
 CApplicationMessenger::~CApplicationMessenger()
 {
   Cleanup();
@@ -102,7 +117,7 @@ void CApplicationMessenger::Cleanup()
 
   while (m_vecMessages.size() > 0)
   {
-    ThreadMessage* pMsg = m_vecMessages.front();
+    ThreadMessage* pMsg = m_vecMessages.front().second;
 
     if (pMsg->waitEvent)
       pMsg->waitEvent->Set();
@@ -111,6 +126,20 @@ void CApplicationMessenger::Cleanup()
     m_vecMessages.pop();
   }
 
+  // messages taken for the frame but not yet processed
+  while (m_batch.size() > 0)
+  {
+    ThreadMessage* pMsg = m_batch.front().sent;
+    m_batch.pop_front();
+    if (!pMsg)
+      continue;
+
+    if (pMsg->waitEvent)
+      pMsg->waitEvent->Set();
+
+    delete pMsg;
+  }
+
   while (m_vecWindowMessages.size() > 0)
   {
     ThreadMessage* pMsg = m_vecWindowMessages.front();
@@ -121,6 +150,10 @@ void CApplicationMessenger::Cleanup()
     delete pMsg;
     m_vecWindowMessages.pop();
   }
+  lock.Leave();
+
+  CSingleLock postedLock(m_critPosted);
+  m_postedCount = 0;
 }
 
 void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
@@ -165,7 +198,7 @@ void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
   if (msg->dwMessage == TMSG_DIALOG_DOMODAL)
     m_vecWindowMessages.push(msg);
   else
-    m_vecMessages.push(msg);
+    m_vecMessages.push(SequencedMessage(AtomicIncrement(&m_sequence), msg));
   lock.Leave();  // this releases the lock on the vec of messages and
                  //   allows the ProcessMessage to execute and therefore
                  //   delete the message itself. Therefore any accesss
@@ -181,29 +214,154 @@ void CApplicationMessenger::SendMessage(ThreadMessage& message, bool wait)
   }
 }
 
+void CApplicationMessenger::PostMessage(DWORD dwMessage, DWORD dwParam1, DWORD dwParam2, LPVOID lpVoid, bool coalesce)
+{
+  CSingleLock lock(m_critPosted);
+
+  if (g_application.m_bStop)
+    return;
+
+  m_postedStats.posted++;
+  if (coalesce)
+  {
+    for (unsigned int i = 0; i < m_postedCount; i++)
+    {
+      PostedMessage &waiting = m_posted[(m_postedHead + i) % POSTED_SLOTS];
+      if (waiting.dwMessage == dwMessage)
+      { // it keeps its place in the queue, and the time it was first posted
+        waiting.dwParam1 = dwParam1;
+        waiting.dwParam2 = dwParam2;
+        waiting.lpVoid = lpVoid;
+        m_postedStats.coalesced++;
+        return;
+      }
+    }
+  }
+
+  if (m_postedCount == POSTED_SLOTS)
+  {
+    m_postedStats.overflowed++;
+    lock.Leave();
+
+    ThreadMessage tMsg = {dwMessage, dwParam1, dwParam2};
+    tMsg.lpVoid = lpVoid;
+    SendMessage(tMsg, false);
+    return;
+  }
+
+  PostedMessage &slot = m_posted[(m_postedHead + m_postedCount++) % POSTED_SLOTS];
+  slot.dwMessage = dwMessage;
+  slot.dwParam1 = dwParam1;
+  slot.dwParam2 = dwParam2;
+  slot.lpVoid = lpVoid;
+  slot.posted = XbmcThreads::SystemClockMillis();
+  slot.sequence = AtomicIncrement(&m_sequence);
+}
+
+void CApplicationMessenger::GetPostedStats(PostedStats &stats)
+{
+  CSingleLock lock(m_critPosted);
+  stats = m_lastPostedStats;
+}
+
+void CApplicationMessenger::LogPostedStats()
+{
+  PostedStats stats;
+  GetPostedStats(stats);
+  LogPostedStats(stats, "last");
+}
+
+void CApplicationMessenger::LogPostedStats(const PostedStats &stats, const char *window)
+{
+  CLog::Log(LOGDEBUG, "CApplicationMessenger - %s %u frames: %u messages posted (%u coalesced, %u overflowed), "
+            "%u processed a frame on average and %u at most, waiting %u ms on average and %u ms at most",
+            window, stats.frames, stats.posted, stats.coalesced, stats.overflowed,
+            stats.frames ? stats.totalDepth / stats.frames : 0, stats.maxDepth,
+            stats.totalDepth ? stats.totalLatency / stats.totalDepth : 0, stats.maxLatency);
+}
+
 void CApplicationMessenger::ProcessMessages()
 {
-  // process threadmessages
-  CSingleLock lock (m_critSection);
-  while (m_vecMessages.size() > 0)
+  // a message might run a modal loop that calls us again, in which case it carries on
+  // with what's left of the frame's batch so that the messages keep their order.
+  if (m_batch.empty())
   {
-    ThreadMessage* pMsg = m_vecMessages.front();
-    //first remove the message from the queue, else the message could be processed more then once
-    m_vecMessages.pop();
+    // take the messages queued so far, the posted and sent together in the order
+    // they came in. m_critSection is always taken before m_critPosted.
+    CSingleLock lock (m_critSection);
+    CSingleLock postedLock(m_critPosted);
 
-    //Leave here as the message might make another
-    //thread call processmessages or sendmessage
+    unsigned int depth = m_postedCount;
+    while (m_vecMessages.size() > 0 || m_postedCount > 0)
+    {
+      BatchedMessage batched;
+      bool posted = m_postedCount > 0;
+      if (posted && m_vecMessages.size() > 0)
+        posted = (int)(m_posted[m_postedHead].sequence - m_vecMessages.front().first) < 0;
 
-    boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent; 
-    lock.Leave(); // <- see the large comment in SendMessage ^
+      if (posted)
+      {
+        batched.posted = m_posted[m_postedHead];
+        batched.sequence = batched.posted.sequence;
+        batched.sent = NULL;
+        m_postedHead = (m_postedHead + 1) % POSTED_SLOTS;
+        m_postedCount--;
+      }
+      else
+      {
+        batched.sequence = m_vecMessages.front().first;
+        batched.sent = m_vecMessages.front().second;
+        m_vecMessages.pop();
+      }
+      m_batch.push_back(batched);
+    }
 
-    ProcessMessage(pMsg);
-    if (waitEvent)
-      waitEvent->Set();
-    delete pMsg;
+    m_postedStats.frames++;
+    m_postedStats.totalDepth += depth;
+    if (depth > m_postedStats.maxDepth)
+      m_postedStats.maxDepth = depth;
+    if (m_postedStats.frames == STATS_FRAMES)
+    {
+      m_lastPostedStats = m_postedStats;
+      memset(&m_postedStats, 0, sizeof(m_postedStats));
+      postedLock.Leave();
+      lock.Leave();
 
-    lock.Enter();
+      if (m_lastPostedStats.posted > 0)
+        LogPostedStats(m_lastPostedStats, "over");
+    }
   }
+
+  // neither queue is locked while the batch is processed, as a message might post or send another
+  unsigned int latency = 0;
+  while (m_batch.size() > 0)
+  {
+    BatchedMessage batched = m_batch.front();
+    m_batch.pop_front();
+
+    if (!batched.sent)
+    {
+      unsigned int waited = XbmcThreads::SystemClockMillis() - batched.posted.posted;
+      latency += waited;
+      if (waited > m_postedStats.maxLatency)
+        m_postedStats.maxLatency = waited;
+
+      ThreadMessage msg = {batched.posted.dwMessage, batched.posted.dwParam1, batched.posted.dwParam2};
+      msg.lpVoid = batched.posted.lpVoid;
+      ProcessMessage(&msg);
+    }
+    else
+    {
+      ThreadMessage* pMsg = batched.sent;
+      boost::shared_ptr<CEvent> waitEvent = pMsg->waitEvent;
+
+      ProcessMessage(pMsg);
+      if (waitEvent)
+        waitEvent->Set();
+      delete pMsg;
+    }
+  }
+  m_postedStats.totalLatency += latency;
 }
 
 void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
@@ -233,14 +391,14 @@ void CApplicationMessenger::ProcessMessage(ThreadMessage *pMsg)
           case POWERSTATE_MINIMIZE:
             Minimize();
             break;
-
-          case TMSG_RENDERER_FLUSH:
-            g_renderManager.Flush();
-            break;
         }
       }
       break;
 
+    case TMSG_RENDERER_FLUSH:
+      g_renderManager.Flush();
+      break;
+
 case TMSG_POWERDOWN:
       {
         g_application.Stop(EXITCODE_POWERDOWN);
@@ -1086,8 +1244,7 @@ void CApplicationMessenger::RestartApp()
 
 void CApplicationMessenger::NetworkMessage(DWORD dwMessage, DWORD dwParam)
 {
-  ThreadMessage tMsg = {TMSG_NETWORKMESSAGE, dwMessage, dwParam};
-  SendMessage(tMsg);
+  PostMessage(TMSG_NETWORKMESSAGE, dwMessage, dwParam);
 }
 
 void CApplicationMessenger::SwitchToFullscreen()
@@ -1095,8 +1252,7 @@ void CApplicationMessenger::SwitchToFullscreen()
   /* FIXME: ideally this call should return upon a successfull switch but currently
      is causing deadlocks between the dvdplayer destructor and the rendermanager
   */
-  ThreadMessage tMsg = {TMSG_SWITCHTOFULLSCREEN};
-  SendMessage(tMsg, false);
+  PostMessage(TMSG_SWITCHTOFULLSCREEN, 0, 0, NULL, true);
 }
 
 void CApplicationMessenger::Minimize(bool wait)
@@ -1124,8 +1280,7 @@ void CApplicationMessenger::ExecOS(const CStdString command, bool waitExit)
 
 void CApplicationMessenger::UserEvent(int code)
 {
-  ThreadMessage tMsg = {code};
-  SendMessage(tMsg, false);
+  PostMessage(code);
 }
 
 void CApplicationMessenger::Show(CGUIDialog *pDialog)
@@ -1197,9 +1352,7 @@ void CApplicationMessenger::OpticalUnMount(CStdString device)
 
 void CApplicationMessenger::ShowVolumeBar(bool up)
 {
-  ThreadMessage tMsg = {TMSG_VOLUME_SHOW};
-  tMsg.dwParam1 = up ? ACTION_VOLUME_UP : ACTION_VOLUME_DOWN;
-  SendMessage(tMsg, false);
+  PostMessage(TMSG_VOLUME_SHOW, up ? ACTION_VOLUME_UP : ACTION_VOLUME_DOWN, 0, NULL, true);
 }
 
 void CApplicationMessenger::SetSplashMessage(const CStdString& message)
@@ -28,6 +28,7 @@
 #include "threads/Event.h"
 #include <boost/shared_ptr.hpp>
 
+#include <deque>
 #include <queue>
 
 class CFileItem;
@@ -122,6 +123,20 @@ class CDelayedMessage : public CThread
     ThreadMessage  m_msg;
 };
 
+/*! \brief A message posted with CApplicationMessenger::PostMessage().
+
+ It carries no strings and can't be waited on, so that it fits in a fixed slot.
+ */
+struct PostedMessage
+{
+  DWORD dwMessage;
+  DWORD dwParam1;
+  DWORD dwParam2;
+  LPVOID lpVoid;
+  unsigned int posted;   ///< SystemClockMillis() when it was posted
+  unsigned int sequence; ///< place in the order of all posted and sent messages
+};
+
 struct ThreadMessageCallback
 {
   void (*callback)(void *userptr);
@@ -132,12 +147,47 @@ class CApplicationMessenger
 {
 
 public:
+  /*! \brief Statistics of the posted messages over a window of frames, ie calls to ProcessMessages().
+   \sa GetPostedStats()
+   */
+  struct PostedStats
+  {
+    unsigned int frames;       ///< frames in the window
+    unsigned int posted;       ///< messages posted over the window
+    unsigned int coalesced;    ///< posted messages that replaced one already waiting
+    unsigned int overflowed;   ///< posted messages sent the slow way as the ring was full
+    unsigned int totalDepth;   ///< posted messages processed over the window
+    unsigned int maxDepth;     ///< most posted messages processed in one frame
+    unsigned int totalLatency; ///< total ms those messages waited to be processed
+    unsigned int maxLatency;   ///< longest ms one of them waited to be processed
+  };
+
+  CApplicationMessenger();
   ~CApplicationMessenger();
 
   void Cleanup();
   // if a message has to be send to the gui, use MSG_TYPE_WINDOW instead
   void SendMessage(ThreadMessage& msg, bool wait = false);
-  void ProcessMessages(); // only call from main thread.
+
+  /*! \brief Post a message to the application thread without waiting for it, or allocating.
+
+   Posted messages are held in a fixed ring of slots and are processed by the next
+   ProcessMessages(), in the order they were posted or sent along with the messages
+   sent with SendMessage(). A message that only ever puts
+   the application into the state given by its parameters can be coalesced, in which case
+   it replaces any of the same message that's still waiting rather than being queued again.
+   Should the ring be full the message is sent with SendMessage() instead.
+
+   \param coalesce whether to replace a waiting message of the same type
+   */
+  void PostMessage(DWORD dwMessage, DWORD dwParam1 = 0, DWORD dwParam2 = 0, LPVOID lpVoid = NULL, bool coalesce = false);
+  /*! \brief Process the messages posted and sent before the call, in the order they came in.
+
+   Both queues are taken as they stand at the start of the frame and the batch is processed
+   with neither locked, so a message posted or sent meanwhile waits for the next frame.
+   Only call from the main thread.
+   */
+  void ProcessMessages();
   void ProcessWindowMessages();
 
 
@@ -205,14 +255,46 @@ public:
   void SetSplashMessage(const CStdString& message);
   void SetSplashMessage(int stringID);
 
+  /*! \brief Get the statistics of the posted messages over the last complete window of frames.
+
+   The statistics of each window are also logged at debug level as it completes.
+   \sa LogPostedStats()
+   */
+  void GetPostedStats(PostedStats &stats);
+  void LogPostedStats();
+
 private:
   void ProcessMessage(ThreadMessage *pMsg);
 
+  static const unsigned int POSTED_SLOTS = 256;
+  static const unsigned int STATS_FRAMES = 1000; ///< frames in a window of the posted stats
 
-  std::queue<ThreadMessage*> m_vecMessages;
+  typedef std::pair<unsigned int, ThreadMessage*> SequencedMessage;
+
+  /*! \brief A posted or sent message taken from its queue for processing.
+   */
+  struct BatchedMessage
+  {
+    unsigned int   sequence;
+    ThreadMessage *sent;   ///< the sent message, or NULL if it was posted
+    PostedMessage  posted;
+  };
+
+  void LogPostedStats(const PostedStats &stats, const char *window);
+
+  std::queue<SequencedMessage> m_vecMessages; ///< sent messages, with their place in the order of all messages
+  std::deque<BatchedMessage> m_batch;         ///< the frame's messages still to process, only used by the main thread
   std::queue<ThreadMessage*> m_vecWindowMessages;
   CCriticalSection m_critSection;
   CCriticalSection m_critBuffer;
   CStdString bufferResponse;
 
+  PostedMessage    m_posted[POSTED_SLOTS]; ///< ring of posted messages, from m_postedHead for m_postedCount
+  unsigned int     m_postedHead;
+  unsigned int     m_postedCount;
+  PostedStats      m_postedStats;     ///< of the window in progress
+  PostedStats      m_lastPostedStats; ///< of the last complete window
+  CCriticalSection m_critPosted;
+  volatile long    m_sequence;        ///< taken by each message as it's queued, under the lock of its queue
+
 };
@@ -23,8 +23,11 @@
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 #include "utils/log.h"
 
+#include <algorithm>
+
 using namespace std;
 
 #define ITEMS_PER_THREAD 5
@@ -38,6 +41,7 @@ CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
   m_nRequestedThreads = nThreads;
   m_bStartCalled = false;
   m_nActiveThreads = 0;
+  m_visibleLoads = m_visibleLoadTime = m_visibleLoadMax = 0;
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
@@ -68,16 +72,10 @@ void CBackgroundInfoLoader::Run()
       while (!m_bStop)
       {
         CSingleLock lock(m_lock);
-        CFileItemPtr pItem;
-        vector<CFileItemPtr>::iterator iter = m_vecItems.begin();
-        if (iter != m_vecItems.end())
-        {
-          pItem = *iter;
-          m_vecItems.erase(iter);
-        }
-
-        if (pItem == NULL)
+        int item = NextItem();
+        if (item < 0)
           break;
+        CFileItemPtr pItem = m_vecItems[item];
 
         // Ask the callback if we should abort
         if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
@@ -93,12 +91,19 @@ void CBackgroundInfoLoader::Run()
         {
           CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
         }
+        lock.Enter();
+        ItemDone(item);
       }
     }
 
     CSingleLock lock(m_lock);
     if (m_nActiveThreads == 1)
+    {
+      if (m_visibleLoads)
+        CLog::Log(LOGDEBUG, "%s - %u items loaded while visible, %u ms on average and %u ms at most from coming into view",
+                  __FUNCTION__, m_visibleLoads, m_visibleLoadTime / m_visibleLoads, m_visibleLoadMax);
       OnLoaderFinish();
+    }
     m_nActiveThreads--;
 
   }
@@ -119,7 +124,14 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   CSingleLock lock(m_lock);
 
   for (int nItem=0; nItem < items.Size(); nItem++)
+  {
     m_vecItems.push_back(items[nItem]);
+    m_pending.insert(m_pending.end(), nItem);
+    m_indices[items[nItem].get()] = nItem;
+  }
+  m_visible.clear();
+  m_visibleSince.clear();
+  m_visibleLoads = m_visibleLoadTime = m_visibleLoadMax = 0;
 
   m_pVecItems = &items;
   m_bStop = false;
@@ -163,6 +175,10 @@ void CBackgroundInfoLoader::StopThread()
 
   m_workers.clear();
   m_vecItems.clear();
+  m_pending.clear();
+  m_indices.clear();
+  m_visible.clear();
+  m_visibleSince.clear();
   m_pVecItems = NULL;
   m_nActiveThreads = 0;
 }
@@ -172,6 +188,84 @@ bool CBackgroundInfoLoader::IsLoading()
   return m_nActiveThreads > 0;
 }
 
+void CBackgroundInfoLoader::SetVisibleRange(const CFileItemList &items, int first, int count)
+{
+  CSingleLock lock(m_lock);
+  if (m_vecItems.empty() || count <= 0)
+    return;
+
+  // the list may have been sorted or filtered since Load(), so find our own index of each
+  vector<int> visible;
+  first = std::max(0, first);
+  int last = std::min(first + count, items.Size());
+  for (int i = first; i < last; i++)
+  {
+    map<const CFileItem *, int>::const_iterator index = m_indices.find(items[i].get());
+    if (index != m_indices.end())
+      visible.push_back(index->second);
+  }
+  if (visible == m_visible)
+    return;
+
+  // items that have scrolled out of view are no longer timed
+  set<int> shown(visible.begin(), visible.end());
+  for (map<int, unsigned int>::iterator i = m_visibleSince.begin(); i != m_visibleSince.end();)
+  {
+    if (!shown.count(i->first))
+      m_visibleSince.erase(i++);
+    else
+      ++i;
+  }
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  for (vector<int>::const_iterator i = visible.begin(); i != visible.end(); ++i)
+  {
+    if (m_pending.count(*i))
+      m_visibleSince.insert(make_pair(*i, now));
+  }
+
+  m_visible.swap(visible);
+}
+
+int CBackgroundInfoLoader::NextItem()
+{
+  if (m_pending.empty())
+    return -1;
+
+  // the visible items first, in the order they're shown
+  for (vector<int>::const_iterator v = m_visible.begin(); v != m_visible.end(); ++v)
+  {
+    set<int>::iterator i = m_pending.find(*v);
+    if (i != m_pending.end())
+    {
+      m_pending.erase(i);
+      return *v;
+    }
+  }
+
+  // then those after the last visible item, wrapping around to those before it
+  set<int>::iterator i = m_pending.lower_bound(m_visible.empty() ? 0 : m_visible.back());
+  if (i == m_pending.end())
+    i = m_pending.begin();
+
+  int item = *i;
+  m_pending.erase(i);
+  return item;
+}
+
+void CBackgroundInfoLoader::ItemDone(int item)
+{
+  map<int, unsigned int>::iterator i = m_visibleSince.find(item);
+  if (i == m_visibleSince.end())
+    return;
+
+  unsigned int elapsed = XbmcThreads::SystemClockMillis() - i->second;
+  m_visibleLoads++;
+  m_visibleLoadTime += elapsed;
+  m_visibleLoadMax = std::max(m_visibleLoadMax, elapsed);
+  m_visibleSince.erase(i);
+}
+
 void CBackgroundInfoLoader::SetObserver(IBackgroundLoaderObserver* pObserver)
 {
   m_pObserver = pObserver;
@@ -26,6 +26,8 @@
 #include "threads/CriticalSection.h"
 
 #include <vector>
+#include <set>
+#include <map>
 #include "boost/shared_ptr.hpp"
 
 class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
@@ -56,14 +58,36 @@ public:
 
   void SetNumOfWorkers(int nThreads); // -1 means auto compute num of required threads
 
+  /*! \brief Set the items that are currently on screen.
+   Visible items are loaded first, in the order they're shown, continuing with the items that
+   follow the last of them in the list passed to Load() and then those before it. Items that
+   scroll out of view before being started are put back in line. The items are matched by
+   pointer, so the list may have been sorted or filtered since Load().
+   \param items the list as it's shown
+   \param first index of the first visible item in items
+   \param count number of visible items
+   */
+  void SetVisibleRange(const CFileItemList &items, int first, int count);
+
 protected:
   virtual void OnLoaderStart() {};
   virtual void OnLoaderFinish() {};
 
+  int  NextItem();
+  void ItemDone(int item);
+
   CFileItemList *m_pVecItems;
   std::vector<CFileItemPtr> m_vecItems; // FileItemList would delete the items and we only want to keep a reference.
+  std::set<int> m_pending;              // indices into m_vecItems yet to be loaded
+  std::map<const CFileItem *, int> m_indices; // of the items in m_vecItems
   CCriticalSection m_lock;
 
+  std::vector<int> m_visible;           // indices into m_vecItems of the visible items, in the order shown
+  std::map<int, unsigned int> m_visibleSince; // pending visible items, and when they became visible
+  unsigned int m_visibleLoads;
+  unsigned int m_visibleLoadTime;
+  unsigned int m_visibleLoadMax;
+
   bool m_bStartCalled;
   volatile bool m_bStop;
   int  m_nRequestedThreads;
@@ -22,6 +22,7 @@
 #include "FileItem.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/StringUtils.h"
+#include "utils/StringPool.h"
 #include "utils/URIUtils.h"
 #include "Util.h"
 #include "pictures/Picture.h"
@@ -410,6 +411,7 @@ void CFileItem::Archive(CArchive& ar)
 
     ar >> m_bCanQueue;
     ar >> m_mimetype;
+    m_mimetype = CStringPool::Intern(m_mimetype);
     ar >> m_extrainfo;
     ar >> temp;
     m_specialSort = (SPECIAL_SORT)temp;
@@ -1074,6 +1076,11 @@ bool CFileItem::IsParentFolder() const
   return m_bIsParentFolder;
 }
 
+void CFileItem::SetMimeType(const CStdString& mimetype)
+{
+  m_mimetype = CStringPool::Intern(mimetype);
+}
+
 const CStdString& CFileItem::GetMimeType(bool lookup /*= true*/) const
 {
   if( m_mimetype.IsEmpty() && lookup)
@@ -1106,6 +1113,7 @@ const CStdString& CFileItem::GetMimeType(bool lookup /*= true*/) const
     // if it's still empty set to an unknown type
     if( m_ref.IsEmpty() )
       m_ref = "application/octet-stream";
+    m_ref = CStringPool::Intern(m_ref);
   }
 
   // change protocol to mms for the following mome-type.  Allows us to create proper FileMMS.
@@ -1384,7 +1392,7 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_sortDetails = itemlist.m_sortDetails;
   m_replaceListing = itemlist.m_replaceListing;
   m_content = itemlist.m_content;
-  m_mapProperties = itemlist.m_mapProperties;
+  m_properties = itemlist.m_properties;
   m_cacheToDisc = itemlist.m_cacheToDisc;
 }
 
@@ -1396,7 +1404,7 @@ bool CFileItemList::Copy(const CFileItemList& items)
   // assign the rest of the CFileItemList properties
   m_replaceListing = items.m_replaceListing;
   m_content        = items.m_content;
-  m_mapProperties  = items.m_mapProperties;
+  m_properties  = items.m_properties;
   m_cacheToDisc    = items.m_cacheToDisc;
   m_sortDetails    = items.m_sortDetails;
   m_sortMethod     = items.m_sortMethod;
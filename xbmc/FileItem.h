@@ -281,7 +281,7 @@ public:
   const CStdString& GetMimeType(bool lookup = true) const;
 
   /* sets the mime-type if known beforehand */
-  void SetMimeType(const CStdString& mimetype) { m_mimetype = mimetype; } ;
+  void SetMimeType(const CStdString& mimetype);
 
   /* general extra info about the contents of the item, not for display */
   void SetExtraInfo(const CStdString& info) { m_extrainfo = info; };
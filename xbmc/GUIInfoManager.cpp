@@ -72,6 +72,7 @@
 #include "storage/MediaManager.h"
 #include "utils/TimeUtils.h"
 #include "threads/SingleLock.h"
+#include "guilib/GUIProcessPool.h"
 #include "utils/log.h"
 
 #include "addons/AddonManager.h"
@@ -109,6 +110,8 @@ CGUIInfoManager::~CGUIInfoManager(void)
 {
   delete m_currentFile;
   delete m_currentSlide;
+  for (unsigned int i = 0; i < m_threadBools.size(); ++i)
+    delete m_threadBools[i];
 }
 
 bool CGUIInfoManager::OnMessage(CGUIMessage &message)
@@ -1794,11 +1797,61 @@ bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWind
 
  Advantage is that we know this at creation time I think, so could perhaps signal it in IsDirty()?
  */
+#define BOOL_UNKNOWN 2
+
 bool CGUIInfoManager::GetBoolValue(unsigned int expression, const CGUIListItem *item)
 {
-  if (expression && --expression < m_bools.size())
-    return m_bools[expression]->Get(m_updateTime, item);
-  return false;
+  // the cached value is shared by all controls using this expression, and is only used by
+  // the application thread (or whoever else holds g_graphicsContext)
+  if (!g_graphicsContext.InProcessPass() || !CGUIProcessPool::Get().InTask())
+  {
+    if (expression && --expression < m_bools.size())
+      return m_bools[expression]->Get(m_updateTime, item);
+    return false;
+  }
+
+  INFO::InfoBool *info = NULL;
+  {
+    CSingleLock lock(m_critInfo);
+    if (expression && --expression < m_bools.size())
+      info = m_bools[expression];
+  }
+  if (!info)
+    return false;
+
+  // threads of the parallel process pass keep their own cache
+  if (item)
+    return info->Evaluate(item);
+
+  CThreadBools *bools = GetThreadBools();
+  if (bools->updateTime != m_updateTime)
+  {
+    bools->updateTime = m_updateTime;
+    bools->values.clear();
+  }
+  if (expression < bools->values.size() && bools->values[expression] != BOOL_UNKNOWN)
+    return bools->values[expression] != 0;
+
+  // evaluating may recurse into other expressions, so don't hold on to the vector
+  bool value = info->Evaluate(NULL);
+  if (expression >= bools->values.size())
+    bools->values.resize(expression + 1, BOOL_UNKNOWN);
+  bools->values[expression] = value ? 1 : 0;
+  return value;
+}
+
+CGUIInfoManager::CThreadBools *CGUIInfoManager::GetThreadBools()
+{
+  CThreadBools *bools = m_threadBoolsLocal.get();
+  if (!bools)
+  {
+    bools = new CThreadBools;
+    bools->updateTime = 0;
+    m_threadBoolsLocal.set(bools);
+    CSingleLock lock(m_critInfo);
+    m_threadBools.push_back(bools);
+  }
+  return bools;
 }
 
 // checks the condition and returns it as necessary.  Currently used
@@ -3699,6 +3752,8 @@ void CGUIInfoManager::Clear()
   for (unsigned int i = 0; i < m_bools.size(); ++i)
     delete m_bools[i];
   m_bools.clear();
+  for (unsigned int i = 0; i < m_threadBools.size(); ++i)
+    m_threadBools[i]->values.clear();
 
   m_skinVariableStrings.clear();
 }
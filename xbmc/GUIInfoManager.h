@@ -29,6 +29,7 @@
 
 #include "Temperature.h"
 #include "threads/CriticalSection.h"
+#include "threads/ThreadLocal.h"
 #include "guilib/IMsgTargetCallback.h"
 #include "inttypes.h"
 #include "XBDateTime.h"
@@ -544,6 +545,15 @@ private:
 /*!
  \ingroup strings
  \brief
+
+ Threading: with the parallel process pass enabled (see CGUIProcessPool), controls of
+ different windows and list items call GetBoolValue(), GetBool(), GetInt(), GetLabel()
+ and GetImage() concurrently. These only read state that the application thread changes
+ outside of CGUIWindowManager::Process(). The cached values of the registered boolean
+ expressions belong to the application thread; threads of the pass keep their own, so
+ that m_critInfo is never held while evaluating (which may take g_graphicsContext).
+ Everything that updates state (OnMessage, SetCurrentItem, ResetCache, SetContainerMoving, ...)
+ must only be called from the application thread, outside of the process pass.
  */
 class CGUIInfoManager : public IMsgTargetCallback
 {
@@ -773,6 +783,17 @@ protected:
   int m_prevWindowID;
 
   std::vector<INFO::InfoBool*> m_bools;
+
+  /*! \brief The values of m_bools as evaluated by a thread of the parallel process pass.
+   */
+  struct CThreadBools
+  {
+    unsigned int      updateTime;
+    std::vector<char> values;    ///< BOOL_UNKNOWN, or whether the expression was true
+  };
+  CThreadBools *GetThreadBools();
+  std::vector<CThreadBools *>              m_threadBools;  ///< owned, guarded by m_critInfo
+  XbmcThreads::ThreadLocal<CThreadBools>   m_threadBoolsLocal;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
   unsigned int m_updateTime;
 
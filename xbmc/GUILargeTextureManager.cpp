@@ -29,6 +29,7 @@
 #include "utils/TimeUtils.h"
 #include "utils/JobManager.h"
 #include "guilib/GraphicContext.h"
+#include "guilib/GUIFrameProfiler.h"
 #include "utils/log.h"
 #include "TextureCache.h"
 
@@ -48,6 +49,7 @@ CImageLoader::~CImageLoader()
 
 bool CImageLoader::DoWork()
 {
+  GUIPROFILER_SCOPE("LargeTextureManager::Load");
   CStdString texturePath = g_TextureManager.GetTexturePath(m_path);
   CStdString loadPath = CTextureCache::Get().CheckCachedImage(texturePath); 
   
@@ -44,6 +44,11 @@ public:
    */
   virtual bool DoWork();
 
+  /*!
+   \brief Decoding and scaling the image is what takes the time, so it runs with the compute jobs.
+   */
+  virtual CLASS GetClass() const { return CLASS_COMPUTE; };
+
   CStdString    m_path; ///< path of image to load
   CBaseTexture *m_texture; ///< Texture object to load the image into \sa CBaseTexture.
 };
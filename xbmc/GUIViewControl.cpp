@@ -175,6 +175,19 @@ int CGUIViewControl::GetSelectedItem() const
   return GetSelectedItem(m_visibleViews[m_currentView]);
 }
 
+bool CGUIViewControl::GetVisibleRange(int &first, int &count) const
+{
+  if (m_currentView < 0 || m_currentView >= (int)m_visibleViews.size())
+    return false; // no valid current view!
+
+  const CGUIControl *control = m_visibleViews[m_currentView];
+  if (!control->IsContainer())
+    return false;
+
+  ((const CGUIBaseContainer *)control)->GetVisibleRange(first, count);
+  return true;
+}
+
 void CGUIViewControl::SetSelectedItem(int item)
 {
   if (!m_fileItems || item < 0 || item >= m_fileItems->Size())
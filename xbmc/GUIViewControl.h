@@ -46,6 +46,12 @@ public:
   int GetSelectedItem() const;
   void SetFocused();
 
+  /*! \brief Get the items on screen in the current view
+   \return false if the current view isn't a container
+   \sa CGUIBaseContainer::GetVisibleRange
+   */
+  bool GetVisibleRange(int &first, int &count) const;
+
   bool HasControl(int controlID) const;
   int GetNextViewMode(int direction = 1) const;
   int GetViewModeNumber(int number) const;
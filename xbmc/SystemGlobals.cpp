@@ -32,6 +32,7 @@
 #include "GUIInfoManager.h"
 #include "filesystem/DllLibCurl.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/FileStatCache.h"
 #include "GUIPassword.h"
 #include "LangInfo.h"
 #include "utils/LangCodeExpander.h"
@@ -55,6 +56,7 @@
 
   CGUIWindowManager  g_windowManager;
   XFILE::CDirectoryCache g_directoryCache;
+  XFILE::CFileStatCache  g_fileStatCache;
 
   CGUITextureManager g_TextureManager;
   CGUILargeTextureManager g_largeTextureManager;
@@ -347,8 +347,9 @@ void CTextureCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
     CCacheJob *cacheJob = (CCacheJob *)job;
     AddCachedTexture(cacheJob->m_url, cacheJob->m_original, cacheJob->m_hash);
     // TODO: call back to the UI indicating that it can update it's image...
+    // the DDS version is made once the cache job is done, on a compute worker
     if (g_advancedSettings.m_useDDSFanart)
-      AddJob(new CDDSJob(GetCachedPath(cacheJob->m_original)));
+      AddContinuation(jobID, new CDDSJob(GetCachedPath(cacheJob->m_original)));
   }
   return CJobQueue::OnJobComplete(jobID, success, job);
 }
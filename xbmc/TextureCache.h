@@ -134,6 +134,7 @@ private:
     CDDSJob(const CStdString &original);
 
     virtual const char* GetType() const { return "ddscompress"; };
+    virtual CLASS GetClass() const { return CLASS_COMPUTE; };
     virtual bool operator==(const CJob *job) const;
     virtual bool DoWork();
 
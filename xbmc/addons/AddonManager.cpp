@@ -23,7 +23,11 @@
 #include "DllLibCPluff.h"
 #include "utils/StringUtils.h"
 #include "utils/JobManager.h"
+#include "utils/URIUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
 #include "FileItem.h"
 #include "LangInfo.h"
 #include "settings/Settings.h"
@@ -48,6 +52,7 @@
 #include "Service.h"
 
 using namespace std;
+using namespace XFILE;
 
 namespace ADDON
 {
@@ -184,6 +189,7 @@ bool CAddonMgr::CheckUserDirs(const cp_cfg_element_t *settings)
 CAddonMgr::CAddonMgr()
 {
   m_cpluff = NULL;
+  m_manifestCacheLoaded = false;
 }
 
 CAddonMgr::~CAddonMgr()
@@ -248,9 +254,12 @@ bool CAddonMgr::Init()
   // would allow partial unloading of addon framework
   m_cp_context = m_cpluff->create_context(&status);
   assert(m_cp_context);
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://home/addons"));
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://xbmc/addons"));
-  status = m_cpluff->register_pcollection(m_cp_context, _P("special://xbmcbin/addons"));
+  m_addonDirs.clear();
+  m_addonDirs.push_back(_P("special://home/addons"));
+  m_addonDirs.push_back(_P("special://xbmc/addons"));
+  m_addonDirs.push_back(_P("special://xbmcbin/addons"));
+  for (vector<CStdString>::const_iterator dir = m_addonDirs.begin(); dir != m_addonDirs.end(); ++dir)
+    status = m_cpluff->register_pcollection(m_cp_context, dir->c_str());
   if (status != CP_OK)
   {
     CLog::Log(LOGERROR, "ADDONS: Fatal Error, cp_register_pcollection() returned status: %i", status);
@@ -490,8 +499,127 @@ CStdString CAddonMgr::GetString(const CStdString &id, const int number)
 void CAddonMgr::FindAddons()
 {
   CSingleLock lock(m_critSection);
-  if (m_cpluff && m_cp_context)
+  if (!m_cpluff || !m_cp_context)
+    return;
+
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  if (!g_advancedSettings.m_addonManifestCache)
+  {
     m_cpluff->scan_plugins(m_cp_context, CP_SP_UPGRADE);
+    CLog::Log(LOGDEBUG, "ADDONS: scanned for addons in %u ms", XbmcThreads::SystemClockMillis() - start);
+    return;
+  }
+
+  if (!m_manifestCacheLoaded)
+  {
+    m_manifestCache.Load("special://temp/addonmanifests.cache");
+    m_manifestCacheLoaded = true;
+  }
+
+  // as cp_scan_plugins(), find the highest version of each addon in the collections, and install those
+  // newer than what's installed. Only addons whose addon.xml has changed since the last scan are read.
+  map<CStdString, cp_plugin_info_t *> available;
+  unsigned int fromCache = 0, read = 0, unchanged = 0;
+  m_manifestCache.BeginScan();
+  for (vector<CStdString>::const_iterator dir = m_addonDirs.begin(); dir != m_addonDirs.end(); ++dir)
+  {
+    CFileItemList items;
+    if (!CDirectory::GetDirectory(*dir, items, "/", false, false, DIR_CACHE_NEVER, false))
+      continue;
+
+    for (int i = 0; i < items.Size(); i++)
+    {
+      if (!items[i]->m_bIsFolder)
+        continue;
+      CStdString path = items[i]->GetPath();
+      URIUtils::RemoveSlashAtEnd(path);
+      if (URIUtils::GetFileName(path).Left(1) == ".")
+        continue;
+
+      CStdString manifest = URIUtils::AddFileToFolder(path, "addon.xml");
+      struct __stat64 st;
+      if (CFile::Stat(manifest, &st) != 0)
+        continue;
+
+      cp_status_t status;
+      cp_plugin_info_t *info = NULL;
+      const CAddonManifestCache::CEntry *entry = m_manifestCache.Find(path, st.st_mtime, st.st_size);
+      if (entry)
+      {
+        if (!IsNewerThanInstalled(entry->id, entry->version))
+        { // already installed from this (or a newer) descriptor
+          unchanged++;
+          continue;
+        }
+        info = m_cpluff->load_cached_plugin_descriptor(m_cp_context, path.c_str(), entry->descriptor.c_str(), entry->descriptor.size(), &status);
+        if (info)
+          fromCache++;
+        else
+          m_manifestCache.Remove(path);
+      }
+      if (!info)
+      {
+        CStdString descriptor;
+        CFile file;
+        if (!file.Open(manifest))
+          continue;
+        int64_t length = file.GetLength();
+        if (length > 0)
+        {
+          unsigned int bytes = file.Read(descriptor.GetBufferSetLength((int)length), length);
+          descriptor.ReleaseBuffer(bytes);
+        }
+        file.Close();
+
+        info = m_cpluff->load_cached_plugin_descriptor(m_cp_context, path.c_str(), descriptor.c_str(), descriptor.size(), &status);
+        if (!info)
+          continue;
+        read++;
+        m_manifestCache.Store(path, st.st_mtime, st.st_size, info->identifier, info->version, descriptor);
+      }
+
+      map<CStdString, cp_plugin_info_t *>::iterator it = available.find(info->identifier);
+      if (it == available.end())
+        available.insert(make_pair(CStdString(info->identifier), info));
+      else if (AddonVersion(it->second->version) < AddonVersion(info->version))
+      {
+        m_cpluff->release_info(m_cp_context, it->second);
+        it->second = info;
+      }
+      else
+        m_cpluff->release_info(m_cp_context, info);
+    }
+  }
+  m_manifestCache.EndScan();
+
+  for (map<CStdString, cp_plugin_info_t *>::iterator it = available.begin(); it != available.end(); ++it)
+  {
+    cp_plugin_info_t *info = it->second;
+    if (IsNewerThanInstalled(info->identifier, info->version))
+    {
+      m_cpluff->uninstall_plugin(m_cp_context, info->identifier);
+      cp_status_t status = m_cpluff->install_plugin(m_cp_context, info);
+      if (status != CP_OK)
+        CLog::Log(LOGERROR, "ADDONS: unable to install %s from %s, status: %i", info->identifier, info->plugin_path, status);
+    }
+    m_cpluff->release_info(m_cp_context, info);
+  }
+
+  m_manifestCache.Save();
+  CLog::Log(LOGDEBUG, "ADDONS: scanned for addons in %u ms (%u descriptors from cache, %u read, %u unchanged)",
+            XbmcThreads::SystemClockMillis() - start, fromCache, read, unchanged);
+}
+
+bool CAddonMgr::IsNewerThanInstalled(const CStdString &id, const CStdString &version)
+{
+  cp_status_t status;
+  cp_plugin_info_t *installed = m_cpluff->get_plugin_info(m_cp_context, id.c_str(), &status);
+  if (!installed)
+    return true;
+
+  bool newer = AddonVersion(installed->version) < AddonVersion(version);
+  m_cpluff->release_info(m_cp_context, installed);
+  return newer;
 }
 
 void CAddonMgr::RemoveAddon(const CStdString& ID)
@@ -26,6 +26,7 @@
 #include <map>
 #include <deque>
 #include "AddonDatabase.h"
+#include "AddonManifestCache.h"
 
 class DllLibCPluff;
 extern "C"
@@ -177,6 +178,14 @@ namespace ADDON
     DllLibCPluff *m_cpluff;
     VECADDONS    m_updateableAddons;
 
+    /*! \brief Whether the given version of an addon is newer than the installed one, if any.
+     */
+    bool IsNewerThanInstalled(const CStdString &id, const CStdString &version);
+
+    std::vector<CStdString> m_addonDirs;           ///< the plugin collections, as registered with libcpluff
+    CAddonManifestCache     m_manifestCache;
+    bool                    m_manifestCacheLoaded;
+
     /*! \brief Fetch a (single) addon from a plugin descriptor.
      Assumes that there is a single (non-trivial) extension point per addon.
      \param info the plugin descriptor
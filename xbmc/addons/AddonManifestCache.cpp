@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "AddonManifestCache.h"
+#include "filesystem/File.h"
+#include "utils/Archive.h"
+#include "utils/log.h"
+
+using namespace std;
+using namespace XFILE;
+
+namespace ADDON
+{
+
+CAddonManifestCache::CAddonManifestCache() : m_changed(false)
+{
+}
+
+bool CAddonManifestCache::Load(const CStdString &file)
+{
+  m_entries.clear();
+  m_file = file;
+  m_changed = false;
+
+  CFile cacheFile;
+  if (!cacheFile.Open(file))
+    return false;
+
+  CArchive ar(&cacheFile, CArchive::load);
+  int version = 0;
+  int count = 0;
+  ar >> version;
+  if (version == CACHE_VERSION)
+  {
+    ar >> count;
+    for (int i = 0; i < count; i++)
+    {
+      CStdString path;
+      ar >> path;
+      CEntry &entry = m_entries[path];
+      ar >> entry.mtime;
+      ar >> entry.size;
+      ar >> entry.id;
+      ar >> entry.version;
+      ar >> entry.descriptor;
+      entry.seen = false;
+    }
+  }
+  ar.Close();
+  cacheFile.Close();
+
+  if (version != CACHE_VERSION)
+  { // written by another version, so rebuild it
+    CLog::Log(LOGDEBUG, "%s - ignoring %s with version %d", __FUNCTION__, file.c_str(), version);
+    m_changed = true;
+    return false;
+  }
+  return true;
+}
+
+bool CAddonManifestCache::Save()
+{
+  if (!m_changed || m_file.IsEmpty())
+    return true;
+
+  CFile cacheFile;
+  if (!cacheFile.OpenForWrite(m_file, true))
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, m_file.c_str());
+    return false;
+  }
+
+  CArchive ar(&cacheFile, CArchive::store);
+  ar << CACHE_VERSION;
+  ar << (int)m_entries.size();
+  for (map<CStdString, CEntry>::const_iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+  {
+    ar << i->first;
+    ar << i->second.mtime;
+    ar << i->second.size;
+    ar << i->second.id;
+    ar << i->second.version;
+    ar << i->second.descriptor;
+  }
+  ar.Close();
+  cacheFile.Close();
+
+  m_changed = false;
+  return true;
+}
+
+void CAddonManifestCache::BeginScan()
+{
+  for (map<CStdString, CEntry>::iterator i = m_entries.begin(); i != m_entries.end(); ++i)
+    i->second.seen = false;
+}
+
+void CAddonManifestCache::EndScan()
+{
+  for (map<CStdString, CEntry>::iterator i = m_entries.begin(); i != m_entries.end();)
+  {
+    if (!i->second.seen)
+    { // the addon has been removed
+      m_entries.erase(i++);
+      m_changed = true;
+    }
+    else
+      ++i;
+  }
+}
+
+const CAddonManifestCache::CEntry *CAddonManifestCache::Find(const CStdString &path, int64_t mtime, int64_t size)
+{
+  map<CStdString, CEntry>::iterator i = m_entries.find(path);
+  if (i == m_entries.end() || i->second.mtime != mtime || i->second.size != size)
+    return NULL;
+
+  i->second.seen = true;
+  return &i->second;
+}
+
+void CAddonManifestCache::Store(const CStdString &path, int64_t mtime, int64_t size,
+                                const CStdString &id, const CStdString &version, const CStdString &descriptor)
+{
+  CEntry &entry = m_entries[path];
+  entry.mtime = mtime;
+  entry.size = size;
+  entry.id = id;
+  entry.version = version;
+  entry.descriptor = descriptor;
+  entry.seen = true;
+  m_changed = true;
+}
+
+void CAddonManifestCache::Remove(const CStdString &path)
+{
+  if (m_entries.erase(path))
+    m_changed = true;
+}
+
+}
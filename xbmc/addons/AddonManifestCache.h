@@ -0,0 +1,85 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <map>
+#include "system.h"
+#include "utils/StdString.h"
+
+namespace ADDON
+{
+  /*! \brief The addon.xml descriptors of installed addons, kept on disk between runs.
+
+   Entries are keyed by the path of the addon's directory and are only used while the
+   modification time and size of its addon.xml match those it was stored with, so an
+   addon that has been changed, upgraded or reinstalled is read again.
+
+   Not thread safe - CAddonMgr only uses it while holding its own lock.
+   */
+  class CAddonManifestCache
+  {
+  public:
+    struct CEntry
+    {
+      int64_t    mtime;
+      int64_t    size;
+      CStdString id;
+      CStdString version;
+      CStdString descriptor;  ///< the contents of addon.xml
+      bool       seen;        ///< whether the addon was found by the current scan
+    };
+
+    CAddonManifestCache();
+
+    /*! \brief Read the cache from the given file, replacing anything held.
+     \return true if it was read, false if there was no (usable) cache.
+     */
+    bool Load(const CStdString &file);
+
+    /*! \brief Write the cache back to the file it was loaded from, if it has changed.
+     */
+    bool Save();
+
+    /*! \brief Start a scan - entries not found or stored before EndScan() are dropped.
+     */
+    void BeginScan();
+    void EndScan();
+
+    /*! \brief Find the entry of an addon, if its addon.xml hasn't changed since it was stored.
+     \return the entry, or NULL if there is none or it is out of date.
+     */
+    const CEntry *Find(const CStdString &path, int64_t mtime, int64_t size);
+
+    void Store(const CStdString &path, int64_t mtime, int64_t size,
+               const CStdString &id, const CStdString &version, const CStdString &descriptor);
+
+    /*! \brief Drop the entry of an addon, eg if its cached descriptor could not be loaded.
+     */
+    void Remove(const CStdString &path);
+
+  private:
+    static const int CACHE_VERSION = 1;
+
+    std::map<CStdString, CEntry> m_entries;
+    CStdString                   m_file;
+    bool                         m_changed;
+  };
+}
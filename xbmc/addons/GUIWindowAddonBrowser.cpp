@@ -447,3 +447,8 @@ CStdString CGUIWindowAddonBrowser::GetStartFolder(const CStdString &dir)
     return dir;
   return CGUIMediaWindow::GetStartFolder(dir);
 }
+
+void CGUIWindowAddonBrowser::OnVisibleRange(int first, int count)
+{
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
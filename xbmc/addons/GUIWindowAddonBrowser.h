@@ -54,6 +54,7 @@ public:
   static int SelectAddonID(const std::vector<ADDON::TYPE> &types, CStdStringArray &addonIDs, bool showNone = false, bool multipleSelection = true);
   
 protected:
+  virtual void OnVisibleRange(int first, int count);
   /* \brief set label2 of an item based on the Addon.Status property
    \param item the item to update
    */
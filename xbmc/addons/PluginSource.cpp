@@ -35,17 +35,24 @@ CPluginSource::CPluginSource(const AddonProps &props)
   if (i != Props().extrainfo.end())
     provides = i->second;
   SetProvides(provides);
+  i = Props().extrainfo.find("reuseinterpreter");
+  m_reuseInterpreter = i != Props().extrainfo.end() && i->second.Equals("true");
 }
 
 CPluginSource::CPluginSource(const cp_extension_t *ext)
   : CAddon(ext)
 {
   CStdString provides;
+  m_reuseInterpreter = false;
   if (ext)
   {
     provides = CAddonMgr::Get().GetExtValue(ext->configuration, "provides");
     if (!provides.IsEmpty())
       Props().extrainfo.insert(make_pair("provides", provides));
+    CStdString reuse = CAddonMgr::Get().GetExtValue(ext->configuration, "@reuseinterpreter");
+    if (!reuse.IsEmpty())
+      Props().extrainfo.insert(make_pair("reuseinterpreter", reuse));
+    m_reuseInterpreter = reuse.Equals("true");
   }
   SetProvides(provides);
 }
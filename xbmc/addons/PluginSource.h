@@ -38,6 +38,12 @@ public:
   bool Provides(const Content& content) const {
     return content == UNKNOWN ? false : m_providedContent.count(content) > 0; }
 
+  /*! \brief Whether the plugin's python interpreter may be kept and reused for its next run
+   Set by reuseinterpreter="true" in the plugin's extension point. The plugin's modules then
+   stay loaded between runs, so they mustn't hold state of a single run, such as sys.argv.
+   */
+  bool ReuseInterpreter() const { return m_reuseInterpreter; }
+
   static Content Translate(const CStdString &content);
 private:
   /*! \brief Set the provided content for this plugin
@@ -46,6 +52,7 @@ private:
    */
   void SetProvides(const CStdString &content);
   std::set<Content> m_providedContent;
+  bool m_reuseInterpreter;
 };
 
 } /*namespace ADDON*/
@@ -377,7 +377,9 @@ bool CScraper::Load()
     }
   }
 
-  if (!result)
+  if (result)
+    m_parser.Compile();
+  else
     CLog::Log(LOGWARNING, "failed to load scraper XML");
   return m_fLoaded = result;
 }
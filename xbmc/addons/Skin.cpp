@@ -29,6 +29,7 @@
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "settings/GUISettings.h"
+#include "threads/SingleLock.h"
 
 // fallback for new skin resolution code
 #include "filesystem/Directory.h"
@@ -44,12 +45,12 @@ namespace ADDON
 {
 
 CSkinInfo::CSkinInfo(const AddonProps &props, const RESOLUTION_INFO &resolution)
-  : CAddon(props), m_defaultRes(resolution)
+  : CAddon(props), m_defaultRes(resolution), m_windowCacheUses(0)
 {
 }
 
 CSkinInfo::CSkinInfo(const cp_extension_t *ext)
-  : CAddon(ext)
+  : CAddon(ext), m_windowCacheUses(0)
 {
   ELEMENTS elements;
   if (CAddonMgr::Get().GetExtElements(ext->configuration, "res", elements))
@@ -178,11 +179,58 @@ void CSkinInfo::LoadIncludes()
   CLog::Log(LOGINFO, "Loading skin includes from %s", includesPath.c_str());
   m_includes.ClearIncludes();
   m_includes.LoadIncludes(includesPath);
+
+  CSingleLock lock(m_windowCacheSection);
+  m_windowCache.clear();
 }
 
-void CSkinInfo::ResolveIncludes(TiXmlElement *node)
+void CSkinInfo::ResolveIncludes(TiXmlElement *node, bool *conditional /* = NULL */)
 {
-  m_includes.ResolveIncludes(node);
+  m_includes.ResolveIncludes(node, conditional);
+}
+
+bool CSkinInfo::GetCachedWindowXML(const CStdString &path, TiXmlDocument &xmlDoc)
+{
+  CSingleLock lock(m_windowCacheSection);
+  map<CStdString, CCachedWindow>::iterator i = m_windowCache.find(path);
+  if (i == m_windowCache.end())
+    return false;
+
+  struct __stat64 st;
+  if (CFile::Stat(i->second.file, &st) != 0 || st.st_mtime != i->second.mtime)
+  { // the skinner has changed the file
+    m_windowCache.erase(i);
+    return false;
+  }
+
+  i->second.lastUsed = ++m_windowCacheUses;
+  xmlDoc = i->second.xmlDoc;
+  return true;
+}
+
+void CSkinInfo::CacheWindowXML(const CStdString &path, const CStdString &file, const TiXmlDocument &xmlDoc)
+{
+  struct __stat64 st;
+  if (CFile::Stat(file, &st) != 0)
+    return;
+
+  CSingleLock lock(m_windowCacheSection);
+  if (m_windowCache.size() >= MAX_CACHED_WINDOWS && m_windowCache.find(path) == m_windowCache.end())
+  { // make room by dropping the least recently used window
+    map<CStdString, CCachedWindow>::iterator oldest = m_windowCache.begin();
+    for (map<CStdString, CCachedWindow>::iterator i = m_windowCache.begin(); i != m_windowCache.end(); ++i)
+    {
+      if (i->second.lastUsed < oldest->second.lastUsed)
+        oldest = i;
+    }
+    m_windowCache.erase(oldest);
+  }
+
+  CCachedWindow &window = m_windowCache[path];
+  window.file = file;
+  window.mtime = st.st_mtime;
+  window.lastUsed = ++m_windowCacheUses;
+  window.xmlDoc = xmlDoc;
 }
 
 int CSkinInfo::GetStartWindow() const
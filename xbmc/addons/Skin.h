@@ -24,6 +24,7 @@
 #include "Addon.h"
 #include "guilib/GraphicContext.h" // needed for the RESOLUTION members
 #include "guilib/GUIIncludes.h"    // needed for the GUIInclude member
+#include "threads/CriticalSection.h"
 #define CREDIT_LINE_LENGTH 50
 
 class TiXmlNode;
@@ -93,7 +94,22 @@ public:
    */
   static bool TranslateResolution(const CStdString &name, RESOLUTION_INFO &res);
 
-  void ResolveIncludes(TiXmlElement *node);
+  void ResolveIncludes(TiXmlElement *node, bool *conditional = NULL);
+
+  /*! \brief Get a window's XML with its includes resolved, as previously given to CacheWindowXML()
+   \param path the path the window was loaded from
+   \param xmlDoc [out] a copy of the resolved window XML
+   \return true if the window was cached and the file it was read from hasn't changed since, false otherwise.
+   */
+  bool GetCachedWindowXML(const CStdString &path, TiXmlDocument &xmlDoc);
+
+  /*! \brief Keep a window's XML with its includes resolved, so that later loads of the window needn't
+   parse the file or resolve the includes again. The cache is dropped when the includes are reloaded.
+   \param path the path the window was loaded from
+   \param file the file that was actually read (as it may differ in case from path)
+   \param xmlDoc the resolved window XML
+   */
+  void CacheWindowXML(const CStdString &path, const CStdString &file, const TiXmlDocument &xmlDoc);
 
   float GetEffectsSlowdown() const { return m_effectsSlowDown; };
 
@@ -135,6 +151,18 @@ protected:
   float m_effectsSlowDown;
   CGUIIncludes m_includes;
 
+  struct CCachedWindow
+  {
+    CStdString    file;
+    int64_t       mtime;
+    unsigned int  lastUsed;
+    TiXmlDocument xmlDoc;
+  };
+  static const unsigned int MAX_CACHED_WINDOWS = 64;
+  std::map<CStdString, CCachedWindow> m_windowCache;
+  unsigned int     m_windowCacheUses;
+  CCriticalSection m_windowCacheSection;
+
   std::vector<CStartupWindow> m_startupWindows;
   bool m_onlyAnimateToHome;
   bool m_debugging;
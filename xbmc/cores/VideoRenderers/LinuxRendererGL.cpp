@@ -37,6 +37,7 @@
 #include "windowing/WindowingFactory.h"
 #include "dialogs/GUIDialogKaiToast.h"
 #include "guilib/Texture.h"
+#include "guilib/GUITexture.h"
 #include "threads/SingleLock.h"
 #include "DllSwScale.h"
 #include "utils/log.h"
@@ -579,6 +580,9 @@ void CLinuxRendererGL::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
 {
   int index = m_iYV12RenderBuffer;
 
+  // GUI textures must be rendered before the video goes on top of them
+  CGUITextureGL::FlushBatch();
+
   if (!ValidateRenderer())
   {
     if (clear) //if clear is set, we're expected to overwrite all backbuffer pixels, even if we have nothing to render
@@ -26,6 +26,7 @@
 #include "utils/MathUtils.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "guilib/GUIFrameProfiler.h"
 
 #include "Application.h"
 #include "settings/Settings.h"
@@ -352,9 +353,8 @@ bool CXBMCRenderManager::Flush()
   }
   else
   {
-    ThreadMessage msg = {TMSG_RENDERER_FLUSH};
     m_flushEvent.Reset();
-    g_application.getApplicationMessenger().SendMessage(msg, false);
+    g_application.getApplicationMessenger().PostMessage(TMSG_RENDERER_FLUSH, 0, 0, NULL, true);
     if (!m_flushEvent.WaitMSec(1000))
     {
       CLog::Log(LOGERROR, "%s - timed out waiting for renderer to flush", __FUNCTION__);
@@ -511,6 +511,7 @@ void CXBMCRenderManager::RemoveCapture(CRenderCapture* capture)
 
 void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0LL*/, int source /*= -1*/, EFIELDSYNC sync /*= FS_NONE*/)
 {
+  GUIPROFILER_SCOPE("RenderManager::FlipPage");
   if(timestamp - GetPresentTime() > MAXPRESENTDELAY)
     timestamp =  GetPresentTime() + MAXPRESENTDELAY;
 
@@ -27,6 +27,7 @@
 #endif
 #include "FileItem.h"
 #include "DirectoryCache.h"
+#include "FileStatCache.h"
 #include "settings/GUISettings.h"
 #include "utils/log.h"
 #include "utils/Job.h"
@@ -235,7 +236,10 @@ bool CDirectory::Create(const CStdString& strPath)
     auto_ptr<IDirectory> pDirectory(CFactoryDirectory::Create(realPath));
     if (pDirectory.get())
       if(pDirectory->Create(realPath.c_str()))
+      {
+        g_fileStatCache.InvalidateSubPaths(realPath);
         return true;
+      }
   }
 #ifndef _LINUX
   catch (const win32_exception &e)
@@ -282,7 +286,10 @@ bool CDirectory::Remove(const CStdString& strPath)
     auto_ptr<IDirectory> pDirectory(CFactoryDirectory::Create(realPath));
     if (pDirectory.get())
       if(pDirectory->Remove(realPath.c_str()))
+      {
+        g_fileStatCache.InvalidateSubPaths(realPath);
         return true;
+      }
   }
 #ifndef _LINUX
   catch (const win32_exception &e)
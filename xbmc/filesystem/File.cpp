@@ -22,6 +22,7 @@
 #include "FileFactory.h"
 #include "Application.h"
 #include "DirectoryCache.h"
+#include "FileStatCache.h"
 #include "Directory.h"
 #include "FileCache.h"
 #include "utils/log.h"
@@ -33,6 +34,19 @@
 #include "utils/Win32Exception.h"
 #endif
 #include "URL.h"
+#include "SpecialProtocol.h"
+#include "threads/Thread.h"
+#include "threads/Event.h"
+
+#if defined(TARGET_LINUX)
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#ifndef FICLONE
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#endif
 
 using namespace XFILE;
 using namespace std;
@@ -60,6 +74,8 @@ CFile::~CFile()
     SAFE_DELETE(m_pFile);
   if (m_pBuffer)
     SAFE_DELETE(m_pBuffer);
+  if (!m_writePath.IsEmpty())
+    g_fileStatCache.Invalidate(m_writePath);
   if (m_bitStreamStats)
     SAFE_DELETE(m_bitStreamStats);
 }
@@ -75,6 +91,288 @@ public:
   char* get() { return p; }
 };
 
+#define CACHE_BUFFER_SIZE (1024 * 1024)
+
+enum CacheResult
+{
+  CACHE_FAILED = 0,
+  CACHE_DONE,
+  CACHE_UNSUPPORTED
+};
+
+// Reports the progress of CFile::Cache to its callback, at most twice a second
+class CCacheProgress
+{
+public:
+  CCacheProgress(IFileCallback* pCallback, void* pContext, uint64_t llFileSize)
+    : m_pCallback(pCallback), m_pContext(pContext), m_llFileSize(llFileSize), m_start(0.0f)
+  {
+    m_timer.StartZero();
+  }
+
+  bool Update(uint64_t llPos)
+  {
+    g_application.ResetScreenSaver();
+
+    // calculate the current and average speeds
+    float end = m_timer.GetElapsedSeconds();
+    if (m_pCallback && end - m_start > 0.5 && end)
+    {
+      m_start = end;
+
+      float averageSpeed = llPos / end;
+      int ipercent = 0;
+      if (m_llFileSize)
+        ipercent = 100 * llPos / m_llFileSize;
+
+      if (!m_pCallback->OnFileCallback(m_pContext, ipercent, averageSpeed))
+      {
+        CLog::Log(LOGERROR, "CFile::Cache - User aborted copy");
+        return false;
+      }
+    }
+    return true;
+  }
+
+private:
+  IFileCallback* m_pCallback;
+  void* m_pContext;
+  uint64_t m_llFileSize;
+  CStopWatch m_timer;
+  float m_start;
+};
+
+// Reads the source of CFile::Cache into one buffer while the other is being written
+class CCacheReader : public CThread
+{
+public:
+  CCacheReader(CFile& file, unsigned int iBufferSize)
+    : CThread("FileCacheReader"), m_file(file), m_iBufferSize(iBufferSize), m_iCurrent(0)
+  {
+    for (int i = 0; i < 2; i++)
+    {
+      m_buffer[i] = (char*)malloc(iBufferSize);
+      m_iRead[i] = 0;
+      m_empty[i].Set();
+    }
+  }
+
+  ~CCacheReader()
+  {
+    m_bStop = true;
+    m_empty[0].Set();
+    m_empty[1].Set();
+    StopThread(true);
+    free(m_buffer[0]);
+    free(m_buffer[1]);
+  }
+
+  /*! \brief Wait for the next buffer to be read.
+   \return the number of bytes in the buffer, 0 at the end of the file and < 0 on error.
+   */
+  int Next(char*& data)
+  {
+    m_filled[m_iCurrent].Wait();
+    data = m_buffer[m_iCurrent];
+    return m_iRead[m_iCurrent];
+  }
+
+  /*! \brief Hand the buffer returned by Next() back to the reader.
+   */
+  void Release()
+  {
+    m_empty[m_iCurrent].Set();
+    m_iCurrent ^= 1;
+  }
+
+protected:
+  virtual void Process()
+  {
+    for (int i = 0; !m_bStop; i ^= 1)
+    {
+      m_empty[i].Wait();
+      if (m_bStop)
+        break;
+      m_iRead[i] = (int)m_file.Read(m_buffer[i], m_iBufferSize);
+      m_filled[i].Set();
+      if (m_iRead[i] <= 0)
+        break;
+    }
+  }
+
+private:
+  CFile& m_file;
+  unsigned int m_iBufferSize;
+  int m_iCurrent;
+  char* m_buffer[2];
+  int m_iRead[2];
+  CEvent m_empty[2];
+  CEvent m_filled[2];
+};
+
+static bool IsPlainLocalFile(const CStdString& strFileName)
+{
+  return URIUtils::IsHD(strFileName) && !URIUtils::IsInArchive(strFileName) && !URIUtils::IsStack(strFileName);
+}
+
+/* Copy between two local files within the kernel: a reflink where the filesystem can share
+   the data, otherwise copy_file_range or sendfile. Returns CACHE_UNSUPPORTED if nothing could
+   be copied this way, including when the kernel reports the end of a source that isn't empty
+   before copying anything. */
+static CacheResult CacheLocal(const CStdString& strFileName, const CStdString& strDest, uint64_t& llPos, CCacheProgress& progress)
+{
+#if defined(TARGET_LINUX)
+  int in = open(CSpecialProtocol::TranslatePath(strFileName).c_str(), O_RDONLY);
+  if (in < 0)
+    return CACHE_UNSUPPORTED;
+  int out = open(CSpecialProtocol::TranslatePath(strDest).c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (out < 0)
+  {
+    close(in);
+    return CACHE_UNSUPPORTED;
+  }
+
+  CacheResult result;
+  struct stat64 info;
+  if (fstat64(in, &info) != 0)
+    result = CACHE_UNSUPPORTED;
+  else if (ioctl(out, FICLONE, in) == 0 && fstat64(out, &info) == 0)
+  {
+    llPos = info.st_size;
+    result = CACHE_DONE;
+  }
+  else
+  {
+    bool bCopyRange = true;
+    while (true)
+    {
+      ssize_t iCopied = -1;
+#ifdef __NR_copy_file_range
+      if (bCopyRange)
+      {
+        iCopied = syscall(__NR_copy_file_range, in, NULL, out, NULL, CACHE_BUFFER_SIZE * 8, 0);
+        if (iCopied < 0 && llPos == 0)
+        { // not supported by the kernel or across these filesystems
+          bCopyRange = false;
+          continue;
+        }
+      }
+      else
+#endif
+        iCopied = sendfile(out, in, NULL, CACHE_BUFFER_SIZE * 8);
+
+      if (iCopied < 0)
+      {
+        result = llPos ? CACHE_FAILED : CACHE_UNSUPPORTED;
+        if (llPos)
+          CLog::Log(LOGERROR, "%s - Failed copy to file %s (%s)", __FUNCTION__, strDest.c_str(), strerror(errno));
+        break;
+      }
+      if (iCopied == 0)
+      {
+        if ((uint64_t)info.st_size == llPos)
+          result = CACHE_DONE;
+        else if (llPos)
+        {
+          CLog::Log(LOGERROR, "%s - Short copy to file %s (%"PRIu64" of %"PRIu64" bytes)", __FUNCTION__,
+                    strDest.c_str(), llPos, (uint64_t)info.st_size);
+          result = CACHE_FAILED;
+        }
+#ifdef __NR_copy_file_range
+        else if (bCopyRange)
+        { // some filesystems copy nothing rather than fail
+          bCopyRange = false;
+          continue;
+        }
+#endif
+        else
+          result = CACHE_UNSUPPORTED;
+        break;
+      }
+      llPos += iCopied;
+      if (!progress.Update(llPos))
+      {
+        result = CACHE_FAILED;
+        break;
+      }
+    }
+  }
+
+  close(in);
+  close(out);
+  return result;
+#else
+  return CACHE_UNSUPPORTED;
+#endif
+}
+
+static bool WriteAll(CFile& file, const char* data, int iSize)
+{
+  int iWrite = 0;
+  while (iWrite < iSize)
+  {
+    int iWrite2 = file.Write(data + iWrite, iSize - iWrite);
+    if (iWrite2 <= 0)
+      break;
+    iWrite += iWrite2;
+  }
+  return iWrite == iSize;
+}
+
+/* Copy through userspace. Sources that aren't local are read on a second thread so that the
+   network and the destination are kept busy at the same time. */
+static bool CacheBuffered(CFile& file, CFile& newFile, const CStdString& strFileName, const CStdString& strDest,
+                          uint64_t& llPos, CCacheProgress& progress)
+{
+  if (URIUtils::IsHD(strFileName))
+  {
+    CAutoBuffer buffer(CACHE_BUFFER_SIZE);
+    while (true)
+    {
+      int iRead = file.Read(buffer.get(), CACHE_BUFFER_SIZE);
+      if (iRead == 0)
+        return true;
+      else if (iRead < 0)
+      {
+        CLog::Log(LOGERROR, "%s - Failed read from file %s", __FUNCTION__, strFileName.c_str());
+        return false;
+      }
+      if (!WriteAll(newFile, buffer.get(), iRead))
+      {
+        CLog::Log(LOGERROR, "%s - Failed write to file %s", __FUNCTION__, strDest.c_str());
+        return false;
+      }
+      llPos += iRead;
+      if (!progress.Update(llPos))
+        return false;
+    }
+  }
+
+  CCacheReader reader(file, CACHE_BUFFER_SIZE);
+  reader.Create();
+  while (true)
+  {
+    char* data;
+    int iRead = reader.Next(data);
+    if (iRead == 0)
+      return true;
+    else if (iRead < 0)
+    {
+      CLog::Log(LOGERROR, "%s - Failed read from file %s", __FUNCTION__, strFileName.c_str());
+      return false;
+    }
+    if (!WriteAll(newFile, data, iRead))
+    {
+      CLog::Log(LOGERROR, "%s - Failed write to file %s", __FUNCTION__, strDest.c_str());
+      return false;
+    }
+    reader.Release();
+    llPos += iRead;
+    if (!progress.Update(llPos))
+      return false;
+  }
+}
+
 // This *looks* like a copy function, therefor the name "Cache" is misleading
 bool CFile::Cache(const CStdString& strFileName, const CStdString& strDest, XFILE::IFileCallback* pCallback, void* pContext)
 {
@@ -124,77 +422,36 @@ bool CFile::Cache(const CStdString& strFileName, const CStdString& strDest, XFIL
     }
     if (CFile::Exists(strDest))
       CFile::Delete(strDest);
-    if (!newFile.OpenForWrite(strDest, true))  // overwrite always
-    {
-      file.Close();
-      return false;
-    }
-
-    // 128k is optimal for xbox
-    int iBufferSize = 128 * 1024;
-
-    CAutoBuffer buffer(iBufferSize);
-    int iRead, iWrite;
 
-    UINT64 llFileSize = file.GetLength();
-    UINT64 llPos = 0;
+    uint64_t llFileSize = file.GetLength();
+    uint64_t llPos = 0;
+    CCacheProgress progress(pCallback, pContext, llFileSize);
 
-    CStopWatch timer;
-    timer.StartZero();
-    float start = 0.0f;
-    while (true)
+    CacheResult result = CACHE_UNSUPPORTED;
+    if (IsPlainLocalFile(strFileName) && IsPlainLocalFile(strDest))
     {
-      g_application.ResetScreenSaver();
-
-      iRead = file.Read(buffer.get(), iBufferSize);
-      if (iRead == 0) break;
-      else if (iRead < 0)
-      {
-        CLog::Log(LOGERROR, "%s - Failed read from file %s", __FUNCTION__, strFileName.c_str());
-        llFileSize = (uint64_t)-1;
-        break;
-      }
-
-      /* write data and make sure we managed to write it all */
-      iWrite = 0;
-      while(iWrite < iRead)
-      {
-        int iWrite2 = newFile.Write(buffer.get()+iWrite, iRead-iWrite);
-        if(iWrite2 <=0)
-          break;
-        iWrite+=iWrite2;
-      }
-
-      if (iWrite != iRead)
-      {
-        CLog::Log(LOGERROR, "%s - Failed write to file %s", __FUNCTION__, strDest.c_str());
-        llFileSize = (uint64_t)-1;
-        break;
+      result = CacheLocal(strFileName, strDest, llPos, progress);
+      if (result != CACHE_UNSUPPORTED)
+      { // as OpenForWrite() would have
+        g_directoryCache.AddFile(strDest);
+        g_fileStatCache.Invalidate(URIUtils::SubstitutePath(strDest));
       }
+    }
 
-      llPos += iRead;
-
-      // calculate the current and average speeds
-      float end = timer.GetElapsedSeconds();
-
-      if (pCallback && end - start > 0.5 && end)
+    if (result == CACHE_UNSUPPORTED)
+    {
+      llPos = 0;
+      if (!newFile.OpenForWrite(strDest, true))  // overwrite always
       {
-        start = end;
-
-        float averageSpeed = llPos / end;
-        int ipercent = 0;
-        if(llFileSize)
-          ipercent = 100 * llPos / llFileSize;
-
-        if(!pCallback->OnFileCallback(pContext, ipercent, averageSpeed))
-        {
-          CLog::Log(LOGERROR, "%s - User aborted copy", __FUNCTION__);
-          llFileSize = (uint64_t)-1;
-          break;
-        }
+        file.Close();
+        return false;
       }
+      result = CacheBuffered(file, newFile, strFileName, strDest, llPos, progress) ? CACHE_DONE : CACHE_FAILED;
     }
 
+    if (result == CACHE_FAILED)
+      llFileSize = (uint64_t)-1;
+
     /* close both files */
     newFile.Close();
     file.Close();
@@ -324,6 +581,9 @@ bool CFile::OpenForWrite(const CStdString& strFileName, bool bOverWrite)
     {
       // add this file to our directory cache (if it's stored)
       g_directoryCache.AddFile(strFileName);
+      // and forget its stat both now and once it's written
+      m_writePath = URIUtils::SubstitutePath(strFileName);
+      g_fileStatCache.Invalidate(m_writePath);
       return true;
     }
     return false;
@@ -351,6 +611,7 @@ bool CFile::Exists(const CStdString& strFileName, bool bUseCache /* = true */)
     if (strFileName.IsEmpty())
       return false;
 
+    CStdString path = URIUtils::SubstitutePath(strFileName);
     if (bUseCache)
     {
       bool bPathInCache;
@@ -358,14 +619,20 @@ bool CFile::Exists(const CStdString& strFileName, bool bUseCache /* = true */)
         return true;
       if (bPathInCache)
         return false;
+
+      bool exists;
+      if (g_fileStatCache.GetExists(path, exists))
+        return exists;
     }
 
-    url = URIUtils::SubstitutePath(strFileName);
+    url = path;
     auto_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
     if (!pFile.get())
       return false;
 
-    return pFile->Exists(url);
+    bool exists = pFile->Exists(url);
+    g_fileStatCache.SetExists(path, exists);
+    return exists;
   }
 #ifndef _LINUX
   catch (const win32_exception &e)
@@ -413,18 +680,24 @@ int CFile::Stat(struct __stat64 *buffer)
   return m_pFile->Stat(buffer);
 }
 
-int CFile::Stat(const CStdString& strFileName, struct __stat64* buffer)
+int CFile::Stat(const CStdString& strFileName, struct __stat64* buffer, bool bUseCache /* = true */)
 {
   CURL url;
   
   try
   {
-    url = URIUtils::SubstitutePath(strFileName);
-    
+    CStdString path = URIUtils::SubstitutePath(strFileName);
+    int result;
+    if (bUseCache && g_fileStatCache.GetStat(path, buffer, result))
+      return result;
+
+    url = path;
     auto_ptr<IFile> pFile(CFileFactory::CreateLoader(url));
     if (!pFile.get())
       return false;
-    return pFile->Stat(url, buffer);
+    result = pFile->Stat(url, buffer);
+    g_fileStatCache.SetStat(path, buffer, result);
+    return result;
   }
 #ifndef _LINUX
   catch (const win32_exception &e)
@@ -537,6 +810,13 @@ void CFile::Close()
   {
     SAFE_DELETE(m_pBuffer);
     SAFE_DELETE(m_pFile);
+
+    // anything stat'ed while it was being written is stale now
+    if (!m_writePath.IsEmpty())
+    {
+      g_fileStatCache.Invalidate(m_writePath);
+      m_writePath.Empty();
+    }
   }
 #ifndef _LINUX
   catch (const win32_exception &e)
@@ -751,6 +1031,7 @@ bool CFile::Delete(const CStdString& strFileName)
     if(pFile->Delete(url))
     {
       g_directoryCache.ClearFile(strFileName);
+      g_fileStatCache.Invalidate(URIUtils::SubstitutePath(strFileName));
       return true;
     }
   }
@@ -788,6 +1069,8 @@ bool CFile::Rename(const CStdString& strFileName, const CStdString& strNewFileNa
     {
       g_directoryCache.ClearFile(strFileName);
       g_directoryCache.ClearFile(strNewFileName);
+      g_fileStatCache.InvalidateSubPaths(URIUtils::SubstitutePath(strFileName));
+      g_fileStatCache.InvalidateSubPaths(URIUtils::SubstitutePath(strNewFileName));
       return true;
     }
   }
@@ -815,6 +1098,7 @@ bool CFile::SetHidden(const CStdString& fileName, bool hidden)
     if (!pFile.get())
       return false;
 
+    g_fileStatCache.Invalidate(URIUtils::SubstitutePath(fileName));
     return pFile->SetHidden(url, hidden);
   }
   catch(...)
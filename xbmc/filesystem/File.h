@@ -98,7 +98,9 @@ public:
   IFile *GetImplemenation() { return m_pFile; }
 
   static bool Exists(const CStdString& strFileName, bool bUseCache = true);
-  static int  Stat(const CStdString& strFileName, struct __stat64* buffer);
+  /*! \brief Stat a file, through the stat cache unless bUseCache is false.
+   */
+  static int  Stat(const CStdString& strFileName, struct __stat64* buffer, bool bUseCache = true);
   int Stat(struct __stat64 *buffer);
   static bool Delete(const CStdString& strFileName);
   static bool Rename(const CStdString& strFileName, const CStdString& strNewFileName);
@@ -110,6 +112,7 @@ private:
   IFile* m_pFile;
   CFileStreamBuffer* m_pBuffer;
   BitstreamStats* m_bitStreamStats;
+  CStdString m_writePath; ///< the file when opened for writing, to invalidate its cached stat on close
 };
 
 // streambuf for file io, only supports buffered input currently
@@ -30,6 +30,7 @@
 
 #include <vector>
 #include <climits>
+#include <algorithm>
 
 #ifdef _LINUX
 #include <errno.h>
@@ -44,6 +45,7 @@
 #include "SpecialProtocol.h"
 #include "utils/CharsetConverter.h"
 #include "utils/log.h"
+#include "threads/SystemClock.h"
 
 using namespace XFILE;
 using namespace XCURL;
@@ -199,6 +201,9 @@ CFileCurl::CReadState::CReadState()
   m_cancelled = false;
   m_bFirstLoop = true;
   m_headerdone = false;
+  m_segmented = false;
+  m_segmentSize = 0;
+  m_segmentPos = 0;
 }
 
 CFileCurl::CReadState::~CReadState()
@@ -285,6 +290,8 @@ long CFileCurl::CReadState::Connect(unsigned int size)
 
 void CFileCurl::CReadState::Disconnect()
 {
+  StopSegments();
+
   if(m_multiHandle && m_easyHandle)
     g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
 
@@ -328,6 +335,7 @@ CFileCurl::CFileCurl()
   m_httpauth = "";
   m_state = new CReadState();
   m_skipshout = false;
+  m_segments = 0;
 }
 
 //Has to be called before Open()
@@ -714,6 +722,8 @@ void CFileCurl::ParseAndCorrectUrl(CURL &url2)
           SetContentEncoding(value);
         else if (name.Equals("noshout") && value.Equals("true"))
           m_skipshout = true;
+        else if (name.Equals("segments"))
+          m_segments = atoi(value.c_str());
         else
           SetRequestHeader(name, value);
       }
@@ -892,6 +902,18 @@ bool CFileCurl::Open(const CURL& url)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_EFFECTIVE_URL,&efurl) && efurl)
     m_url = efurl;
 
+  // on high latency links a single connection may not keep up with the stream, so
+  // read ahead with several range requests if the server has told us it takes them
+  unsigned int segments = m_segments ? m_segments : g_advancedSettings.m_curlSegments;
+  if (segments > 1 && m_seekable && m_multisession
+  && m_contentencoding.IsEmpty() && m_postdata.IsEmpty()
+  && m_state->m_fileSize > g_advancedSettings.m_curlSegmentSize
+  && m_state->m_httpheader.GetValue("Accept-Ranges").Equals("bytes"))
+  {
+    if (m_state->StartSegments(m_url.c_str(), segments, g_advancedSettings.m_curlSegmentSize))
+      CLog::Log(LOGDEBUG, "FileCurl::Open(%p) reading with %u connections", (void*)this, segments);
+  }
+
   return true;
 }
 
@@ -991,6 +1013,9 @@ int64_t CFileCurl::Seek(int64_t iFilePosition, int iWhence)
   if(m_state->Seek(nextPos))
     return nextPos;
 
+  if(m_state->m_segmented)
+    return m_state->SeekSegments(nextPos) ? nextPos : -1;
+
   if(!m_seekable)
     return -1;
 
@@ -1190,6 +1215,9 @@ bool CFileCurl::CReadState::FillBuffer(unsigned int want)
   fd_set fdwrite;
   fd_set fdexcep;
 
+  if (m_segmented)
+    return FillSegments(want);
+
   // only attempt to fill buffer if transactions still running and buffer
   // doesnt exceed required size already
   while ((unsigned int)m_buffer.getMaxReadSize() < want && m_buffer.getMaxWriteSize() > 0 )
@@ -1333,6 +1361,380 @@ bool CFileCurl::CReadState::FillBuffer(unsigned int want)
   return true;
 }
 
+size_t CFileCurl::CReadState::SegmentWriteCallback(char *buffer, size_t size, size_t nitems, void *userp)
+{
+  CSegmentConnection *connection = (CSegmentConnection *)userp;
+  CSegment *segment = connection->segment;
+  size_t amount = size * nitems;
+  if (!segment)
+    return 0;
+
+  if (!connection->partial)
+  { // a server ignoring the range sends us the whole file, which is of no use here
+    long response = 0;
+    g_curlInterface.easy_getinfo(connection->easy, CURLINFO_RESPONSE_CODE, &response);
+    if (response != 206)
+      return 0;
+    connection->partial = true;
+  }
+
+  if (segment->start + (int64_t)(segment->data.size() + amount) > segment->end)
+    return 0;
+
+  segment->data.append(buffer, amount);
+  connection->bytes += amount;
+  return amount;
+}
+
+size_t CFileCurl::CReadState::SegmentHeaderCallback(void *ptr, size_t size, size_t nmemb, void *userp)
+{
+  // the headers of the segments are of no interest, we have those of the first request
+  return size * nmemb;
+}
+
+bool CFileCurl::CReadState::StartSegments(const char *url, unsigned int connections, unsigned int segmentSize)
+{
+  if (m_segmented || !m_easyHandle || !m_multiHandle)
+    return false;
+
+  m_connections.resize(connections);
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    CSegmentConnection &connection = m_connections[i];
+    connection.segment = NULL;
+    connection.partial = false;
+    connection.bytes = 0;
+    connection.segments = 0;
+    connection.busyTime = 0;
+    connection.started = 0;
+
+    // the copies share all options of the first request, apart from where the data goes
+    connection.easy = g_curlInterface.DllLibCurl::easy_duphandle(m_easyHandle);
+    if (!connection.easy)
+    {
+      CLog::Log(LOGERROR, "%s - unable to create connection %u", __FUNCTION__, i);
+      for (unsigned int j = 0; j < i; j++)
+        g_curlInterface.easy_cleanup(m_connections[j].easy);
+      m_connections.clear();
+      return false;
+    }
+    g_curlInterface.easy_setopt(connection.easy, CURLOPT_URL, url);
+    g_curlInterface.easy_setopt(connection.easy, CURLOPT_RESUME_FROM_LARGE, (int64_t)0);
+    g_curlInterface.easy_setopt(connection.easy, CURLOPT_WRITEDATA, &connection);
+    g_curlInterface.easy_setopt(connection.easy, CURLOPT_WRITEFUNCTION, SegmentWriteCallback);
+    g_curlInterface.easy_setopt(connection.easy, CURLOPT_WRITEHEADER, &connection);
+    g_curlInterface.easy_setopt(connection.easy, CURLOPT_HEADERFUNCTION, SegmentHeaderCallback);
+  }
+
+  // the segments carry on from where the first request has got to
+  g_curlInterface.multi_remove_handle(m_multiHandle, m_easyHandle);
+  m_segmentPos = m_filePos + m_buffer.getMaxReadSize() + m_overflowSize;
+  m_segmentSize = segmentSize;
+  m_segmented = true;
+  m_stillRunning = 1;
+  return true;
+}
+
+void CFileCurl::CReadState::StopSegments()
+{
+  if (!m_segmented)
+    return;
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    CSegmentConnection &connection = m_connections[i];
+    if (connection.segment)
+      StopSegment(i);
+    g_curlInterface.easy_cleanup(connection.easy);
+
+    CLog::Log(LOGDEBUG, "%s - connection %u read %u segments, %"PRId64" bytes in %u ms (%u KB/s)", __FUNCTION__,
+              i, connection.segments, connection.bytes, connection.busyTime,
+              connection.busyTime ? (unsigned int)(connection.bytes * 1000 / 1024 / connection.busyTime) : 0);
+  }
+  m_connections.clear();
+
+  while (!m_segments.empty())
+    DropSegment();
+
+  m_segmented = false;
+}
+
+bool CFileCurl::CReadState::StartSegment(unsigned int index, CSegment *segment)
+{
+  CSegmentConnection &connection = m_connections[index];
+
+  CStdString range;
+  range.Format("%"PRId64"-%"PRId64, segment->start + (int64_t)segment->data.size(), segment->end - 1);
+  g_curlInterface.easy_setopt(connection.easy, CURLOPT_RANGE, range.c_str());
+
+  connection.segment = segment;
+  connection.partial = false;
+  connection.started = XbmcThreads::SystemClockMillis();
+  segment->connection = index;
+
+  if (g_curlInterface.multi_add_handle(m_multiHandle, connection.easy) != CURLM_OK)
+  {
+    CLog::Log(LOGERROR, "%s - unable to start request for %s", __FUNCTION__, range.c_str());
+    connection.segment = NULL;
+    segment->connection = -1;
+    return false;
+  }
+  return true;
+}
+
+void CFileCurl::CReadState::StopSegment(unsigned int index)
+{
+  CSegmentConnection &connection = m_connections[index];
+  g_curlInterface.multi_remove_handle(m_multiHandle, connection.easy);
+  connection.busyTime += XbmcThreads::SystemClockMillis() - connection.started;
+  if (connection.segment)
+    connection.segment->connection = -1;
+  connection.segment = NULL;
+}
+
+void CFileCurl::CReadState::DropSegment()
+{
+  CSegment *segment = m_segments.front();
+  if (segment->connection >= 0)
+    StopSegment(segment->connection);
+  m_segments.pop_front();
+  delete segment;
+}
+
+bool CFileCurl::CReadState::RequestSegments()
+{
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    if (m_connections[i].segment)
+      continue;
+
+    // a segment that lost its connection goes first, as it's holding up those behind it
+    CSegment *segment = NULL;
+    for (std::deque<CSegment*>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+      if (!(*it)->done && (*it)->connection < 0)
+      {
+        segment = *it;
+        break;
+      }
+    }
+
+    if (!segment)
+    { // hold on to at most one segment per connection, plus the one being read from
+      if (m_segments.size() > m_connections.size() || m_segmentPos >= m_fileSize)
+        break;
+
+      segment = new CSegment;
+      segment->start = m_segmentPos;
+      segment->end = std::min(m_segmentPos + (int64_t)m_segmentSize, m_fileSize);
+      segment->data.reserve((size_t)(segment->end - segment->start));
+      segment->consumed = 0;
+      segment->connection = -1;
+      segment->done = false;
+      segment->retries = 0;
+      m_segments.push_back(segment);
+      m_segmentPos = segment->end;
+    }
+
+    if (!StartSegment(i, segment))
+      return false;
+  }
+  return true;
+}
+
+bool CFileCurl::CReadState::SegmentDone(unsigned int index, int result)
+{
+  CSegmentConnection &connection = m_connections[index];
+  CSegment *segment = connection.segment;
+  bool partial = connection.partial;
+  StopSegment(index);
+
+  if (result == CURLE_OK && segment->start + (int64_t)segment->data.size() == segment->end)
+  {
+    segment->done = true;
+    connection.segments++;
+    return true;
+  }
+
+  if (result == CURLE_WRITE_ERROR && !partial)
+  { // carry on with a single connection from the end of what we have buffered
+    CLog::Log(LOGWARNING, "%s - server doesn't honour range requests, using a single connection", __FUNCTION__);
+    int64_t pos = m_filePos + m_buffer.getMaxReadSize() + m_overflowSize;
+    StopSegments();
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RESUME_FROM_LARGE, pos);
+    g_curlInterface.multi_add_handle(m_multiHandle, m_easyHandle);
+    m_stillRunning = 1;
+    return true;
+  }
+
+  if (++segment->retries > g_advancedSettings.m_curlretries)
+  {
+    CLog::Log(LOGWARNING, "%s - request for %"PRId64"-%"PRId64" failed with code %i", __FUNCTION__, segment->start, segment->end - 1, result);
+    return false;
+  }
+
+  // RequestSegments() restarts it from where it got to
+  CLog::Log(LOGDEBUG, "%s - request for %"PRId64"-%"PRId64" failed with code %i, (re)try %i", __FUNCTION__, segment->start, segment->end - 1, result, segment->retries);
+  return true;
+}
+
+bool CFileCurl::CReadState::PerformSegments()
+{
+  if (!RequestSegments())
+    return false;
+
+  int running;
+  CURLMcode result;
+  while ((result = g_curlInterface.multi_perform(m_multiHandle, &running)) == CURLM_CALL_MULTI_PERFORM) {}
+  if (result != CURLM_OK)
+  {
+    CLog::Log(LOGERROR, "%s - curl multi perform failed with code %d, aborting", __FUNCTION__, result);
+    return false;
+  }
+
+  CURLMsg* msg;
+  int msgs;
+  while (m_segmented && (msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    CURL_HANDLE *easy = msg->easy_handle;
+    CURLcode code = msg->data.result;
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+      if (m_connections[i].easy == easy && m_connections[i].segment)
+      {
+        if (!SegmentDone(i, code))
+          return false;
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+bool CFileCurl::CReadState::FillSegments(unsigned int want)
+{
+  // keep all connections moving, even if the buffer already holds what's wanted
+  if (!PerformSegments())
+    return false;
+
+  while (m_segmented && (unsigned int)m_buffer.getMaxReadSize() < want && m_buffer.getMaxWriteSize() > 0)
+  {
+    if (m_cancelled)
+      return false;
+
+    /* anything left over from the first request comes before the segments */
+    if (m_overflowSize)
+    {
+      unsigned int amount = XMIN((unsigned int)m_buffer.getMaxWriteSize(), m_overflowSize);
+      m_buffer.WriteData(m_overflowBuffer, amount);
+
+      if (amount < m_overflowSize)
+        memmove(m_overflowBuffer, m_overflowBuffer + amount, m_overflowSize - amount);
+
+      m_overflowSize -= amount;
+      continue;
+    }
+
+    if (m_segments.empty())
+    {
+      if (m_segmentPos >= m_fileSize)
+      {
+        m_stillRunning = 0;
+        return true;
+      }
+    }
+    else
+    {
+      CSegment *segment = m_segments.front();
+      unsigned int amount = XMIN((unsigned int)m_buffer.getMaxWriteSize(), segment->data.size() - segment->consumed);
+      if (amount)
+      {
+        m_buffer.WriteData(&segment->data[segment->consumed], amount);
+        segment->consumed += amount;
+        continue;
+      }
+      if (segment->done)
+      {
+        DropSegment();
+        continue;
+      }
+    }
+
+    if (!PerformSegments())
+      return false;
+
+    if (!m_segmented || (!m_segments.empty() && m_segments.front()->data.size() > m_segments.front()->consumed))
+      continue;
+
+    fd_set fdread;
+    fd_set fdwrite;
+    fd_set fdexcep;
+    int maxfd = -1;
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+    g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+    long timeout = 0;
+    if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1 || timeout > 200)
+      timeout = 200;
+
+    struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+    if (SOCKET_ERROR == dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t))
+    {
+      CLog::Log(LOGERROR, "%s - curl failed with socket error", __FUNCTION__);
+      return false;
+    }
+  }
+
+  // we may have fallen back to a single connection
+  if (!m_segmented)
+    return FillBuffer(want);
+
+  return true;
+}
+
+bool CFileCurl::CReadState::SeekSegments(int64_t pos)
+{
+  m_buffer.Clear();
+  free(m_overflowBuffer);
+  m_overflowBuffer = NULL;
+  m_overflowSize = 0;
+
+  // cancel whatever is behind the new position
+  while (!m_segments.empty() && m_segments.front()->end <= pos)
+    DropSegment();
+
+  if (!m_segments.empty() && m_segments.front()->start <= pos)
+  {
+    CSegment *segment = m_segments.front();
+    if (segment->start + (int64_t)segment->data.size() >= pos)
+      segment->consumed = (unsigned int)(pos - segment->start);
+    else
+    { // not there yet, redirect it to the new position - those after it are still of use
+      if (segment->connection >= 0)
+        StopSegment(segment->connection);
+      segment->start = pos;
+      segment->data.clear();
+      segment->consumed = 0;
+      segment->retries = 0;
+    }
+  }
+  else
+  { // nothing we have is of use, start over at the new position
+    while (!m_segments.empty())
+      DropSegment();
+    m_segmentPos = pos;
+  }
+
+  m_filePos = pos;
+  m_stillRunning = 1;
+  return true;
+}
+
 void CFileCurl::ClearRequestHeaders()
 {
   m_requestheaders.clear();
@@ -23,6 +23,9 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <deque>
+#include <vector>
+#include <string>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -117,6 +120,52 @@ namespace XFILE
 
           long         Connect(unsigned int size);
           void         Disconnect();
+
+          /* segmented reads - several range requests are kept in flight ahead of the
+             read position and are moved into m_buffer in file order as they arrive */
+          struct CSegment
+          {
+            int64_t       start;
+            int64_t       end;          // one past the last byte of the segment
+            std::string   data;
+            unsigned int  consumed;     // bytes already moved into m_buffer
+            int           connection;   // index into m_connections while transferring, otherwise -1
+            bool          done;
+            int           retries;
+          };
+
+          struct CSegmentConnection
+          {
+            XCURL::CURL_HANDLE* easy;
+            CSegment*     segment;
+            bool          partial;      // whether the server answered the current request with partial content
+            int64_t       bytes;
+            unsigned int  segments;
+            unsigned int  busyTime;     // ms spent transferring
+            unsigned int  started;
+          };
+
+          bool            m_segmented;
+          unsigned int    m_segmentSize;
+          int64_t         m_segmentPos;   // start of the next segment to request
+          std::deque<CSegment*>           m_segments;     // contiguous, in file order, from the read position
+          std::vector<CSegmentConnection> m_connections;
+
+          static size_t SegmentWriteCallback(char *buffer, size_t size, size_t nitems, void *userp);
+          static size_t SegmentHeaderCallback(void *ptr, size_t size, size_t nmemb, void *userp);
+
+          bool         StartSegments(const char *url, unsigned int connections, unsigned int segmentSize);
+          void         StopSegments();
+          bool         SeekSegments(int64_t pos);
+          bool         FillSegments(unsigned int want);
+
+        private:
+          bool         RequestSegments();
+          bool         StartSegment(unsigned int index, CSegment *segment);
+          void         StopSegment(unsigned int index);
+          void         DropSegment();
+          bool         SegmentDone(unsigned int index, int result);
+          bool         PerformSegments();
       };
 
     protected:
@@ -154,6 +203,7 @@ namespace XFILE
       bool            m_seekable;
       bool            m_multisession;
       bool            m_skipshout;
+      unsigned int    m_segments;         // parallel range requests for reading, 0 to use the advanced setting
 
       CRingBuffer     m_buffer;           // our ringhold buffer
       char *          m_overflowBuffer;   // in the rare case we would overflow the above buffer
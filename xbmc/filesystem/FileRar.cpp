@@ -130,6 +130,8 @@ CFileRar::CFileRar()
   m_bUseFile = false;
   m_bOpen = false;
   m_bSeekable = true;
+  m_bDirect = false;
+  m_iCurrentPart = -1;
 }
 
 CFileRar::~CFileRar()
@@ -143,6 +145,8 @@ CFileRar::~CFileRar()
     m_File.Close();
     g_RarManager.ClearCachedFile(m_strRarPath,m_strPathInRar);
   }
+  else if (m_bDirect)
+    m_File.Close();
   else
   {
     CleanUp();
@@ -171,6 +175,14 @@ bool CFileRar::Open(const CURL& url)
   {
     if (items[i]->m_idepth == 0x30) // stored
     {
+      // no need for the unrar thread if we can read the data straight from the volumes
+      if (OpenDirect(items[i]->m_dwSize))
+      {
+        m_iFileSize = items[i]->m_dwSize;
+        m_bOpen = true;
+        return true;
+      }
+
       if (!OpenInArchive())
         return false;
 
@@ -270,6 +282,9 @@ unsigned int CFileRar::Read(void *lpBuf, int64_t uiBufSize)
   if (m_bUseFile)
     return m_File.Read(lpBuf,uiBufSize);
 
+  if (m_bDirect)
+    return ReadDirect(lpBuf,uiBufSize);
+
   if (m_iFilePosition >= GetLength()) // we are done
     return 0;
 
@@ -358,6 +373,14 @@ void CFileRar::Close()
     g_RarManager.ClearCachedFile(m_strRarPath,m_strPathInRar);
     m_bOpen = false;
   }
+  else if (m_bDirect)
+  {
+    m_File.Close();
+    m_parts.clear();
+    m_iCurrentPart = -1;
+    m_bDirect = false;
+    m_bOpen = false;
+  }
   else
   {
     CleanUp();
@@ -383,6 +406,27 @@ int64_t CFileRar::Seek(int64_t iFilePosition, int iWhence)
   if (m_bUseFile)
     return m_File.Seek(iFilePosition,iWhence);
 
+  if (m_bDirect)
+  { // the volume is positioned by the next read
+    switch (iWhence)
+    {
+      case SEEK_CUR:
+        iFilePosition += m_iFilePosition;
+        break;
+      case SEEK_END:
+        iFilePosition += GetLength();
+        break;
+      case SEEK_SET:
+        break;
+      default:
+        return -1;
+    }
+    if (iFilePosition < 0 || iFilePosition > GetLength())
+      return -1;
+    m_iFilePosition = iFilePosition;
+    return m_iFilePosition;
+  }
+
   if( !m_pExtract->GetDataIO().hBufferEmpty->WaitMSec(SEEKTIMOUT) )
   {
     CLog::Log(LOGERROR, "%s - Timeout waiting for buffer to empty", __FUNCTION__);
@@ -595,6 +639,149 @@ void CFileRar::CleanUp()
 #endif
 }
 
+bool CFileRar::OpenDirect(int64_t iFileSize)
+{
+#ifdef HAS_FILESYSTEM_RAR
+  m_parts.clear();
+  try
+  {
+    InitCRC();
+
+    Archive arc;
+    char strVolume[NM];
+    strncpy(strVolume, m_strRarPath.c_str(), NM - 1);
+    strVolume[NM - 1] = 0;
+
+    // walk the volumes collecting where each part of the file's data lives
+    int64_t iStart = 0;
+    bool bSplitAfter = true;
+    while (bSplitAfter)
+    {
+      if (!arc.WOpen(strVolume, NULL) || !arc.IsArchive(true))
+        break;
+
+      bool bFound = false;
+      while (arc.ReadHeader() > 0)
+      {
+        if (arc.GetHeaderType() == FILE_HEAD)
+        {
+          CStdString strFileName;
+          if (arc.NewLhd.FileNameW && wcslen(arc.NewLhd.FileNameW) > 0)
+            g_charsetConverter.wToUTF8(arc.NewLhd.FileNameW, strFileName);
+          else
+            g_charsetConverter.unknownToUTF8(arc.NewLhd.FileName, strFileName);
+          strFileName.Replace('\\', '/');
+
+          if (strFileName == m_strPathInRar)
+          {
+            bFound = true;
+            break;
+          }
+        }
+        arc.SeekToNext();
+      }
+      if (!bFound || (arc.NewLhd.Flags & LHD_PASSWORD) || arc.NewLhd.Method != 0x30)
+        break;
+
+      RarVolumePart part;
+      part.strVolume = strVolume;
+      part.iOffset = arc.NextBlockPos - arc.NewLhd.FullPackSize;
+      part.iStart = iStart;
+      part.iSize = arc.NewLhd.FullPackSize;
+      m_parts.push_back(part);
+      iStart += part.iSize;
+
+      bSplitAfter = (arc.NewLhd.Flags & LHD_SPLIT_AFTER) != 0;
+      if (bSplitAfter)
+      {
+        char strNext[NM];
+        strcpy(strNext, arc.FileName);
+        NextVolumeName(strNext, (arc.NewMhd.Flags & MHD_NEWNUMBERING) == 0 || arc.OldFormat);
+        if (!CFile::Exists(strNext))
+        { // as MergeArchive(), fall back to the old .rNN naming
+          strcpy(strNext, arc.FileName);
+          NextVolumeName(strNext, true);
+        }
+        strcpy(strVolume, strNext);
+      }
+      arc.Close();
+    }
+
+    // anything we can't account for is left to unrar
+    if (bSplitAfter || iStart != iFileSize)
+    {
+      m_parts.clear();
+      return false;
+    }
+  }
+  catch (int rarErrCode)
+  {
+    CLog::Log(LOGERROR,"filerar failed in UnrarXLib while CFileRar::OpenDirect with an UnrarXLib error code of %d",rarErrCode);
+    m_parts.clear();
+    return false;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR,"filerar failed in UnrarXLib while CFileRar::OpenDirect with an Unknown exception");
+    m_parts.clear();
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG,"filerar reading %s directly from %"PRIuS" volume(s)", m_strPathInRar.c_str(), m_parts.size());
+  m_bDirect = true;
+  m_bSeekable = true;
+  m_iCurrentPart = -1;
+  m_iFilePosition = 0;
+  return true;
+#else
+  return false;
+#endif
+}
+
+unsigned int CFileRar::ReadDirect(void *lpBuf, int64_t uiBufSize)
+{
+  byte* pBuf = (byte*)lpBuf;
+  int64_t uicBufSize = uiBufSize;
+  while (uicBufSize > 0 && m_iFilePosition < m_iFileSize)
+  {
+    // find the part holding the current position, usually the current or the next one
+    int iPart = m_iCurrentPart >= 0 ? m_iCurrentPart : 0;
+    while (iPart > 0 && m_iFilePosition < m_parts[iPart].iStart)
+      iPart--;
+    while (iPart + 1 < (int)m_parts.size() && m_iFilePosition >= m_parts[iPart].iStart + m_parts[iPart].iSize)
+      iPart++;
+    const RarVolumePart &part = m_parts[iPart];
+
+    if (iPart != m_iCurrentPart)
+    {
+      m_File.Close();
+      m_iCurrentPart = -1;
+      if (!m_File.Open(part.strVolume))
+      {
+        CLog::Log(LOGERROR,"filerar::ReadDirect failed to open volume %s",part.strVolume.c_str());
+        break;
+      }
+      m_iCurrentPart = iPart;
+    }
+
+    int64_t iVolumePos = part.iOffset + m_iFilePosition - part.iStart;
+    if (m_File.GetPosition() != iVolumePos && m_File.Seek(iVolumePos, SEEK_SET) != iVolumePos)
+      break;
+
+    int64_t iToRead = part.iStart + part.iSize - m_iFilePosition;
+    if (iToRead > uicBufSize)
+      iToRead = uicBufSize;
+    unsigned int iRead = m_File.Read(pBuf, iToRead);
+    if (iRead == 0)
+      break;
+
+    pBuf += iRead;
+    uicBufSize -= iRead;
+    m_iFilePosition += iRead;
+  }
+  return static_cast<unsigned int>(uiBufSize-uicBufSize);
+}
+
 bool CFileRar::OpenInArchive()
 {
 #ifdef HAS_FILESYSTEM_RAR
@@ -28,6 +28,7 @@
 #include "File.h"
 #include "threads/Thread.h"
 #include "threads/Event.h"
+#include <vector>
 
 class CmdExtract;
 class CommandData;
@@ -89,15 +90,30 @@ namespace XFILE
     void Init();
     void InitFromUrl(const CURL& url);
     bool OpenInArchive();
+    bool OpenDirect(int64_t iFileSize);
+    unsigned int ReadDirect(void* lpBuf, int64_t uiBufSize);
     void CleanUp();
 
+    /*! \brief Part of a stored file within one of the volumes of the archive.
+     */
+    struct RarVolumePart
+    {
+      CStdString strVolume; ///< path of the volume
+      int64_t iOffset;      ///< offset of the data within the volume
+      int64_t iStart;       ///< offset of the data within the stored file
+      int64_t iSize;
+    };
+
     int64_t m_iFilePosition;
     int64_t m_iFileSize;
     // rar stuff
     bool m_bUseFile;
     bool m_bOpen;
     bool m_bSeekable;
-    CFile m_File; // for packed source
+    CFile m_File; // for packed source, or the current volume when reading directly
+    bool m_bDirect; // stored file read straight from its volumes
+    std::vector<RarVolumePart> m_parts;
+    int m_iCurrentPart;
 #ifdef HAS_FILESYSTEM_RAR
     Archive* m_pArc;
     CommandData* m_pCmd;
@@ -35,8 +35,32 @@
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+// libsmbclient's context api allows files to be accessed through a context of their own
+#if defined(TARGET_POSIX) && defined(DEPRECATED_SMBC_INTERFACE)
+#define SMB_PRIVATE_CONTEXTS
+#endif
+
+// idle contexts kept per server/share
+#define SMB_MAX_IDLE_CONTEXTS 4
+
 using namespace XFILE;
 
+#ifdef SMB_PRIVATE_CONTEXTS
+/* libsmbclient only allows calls on different contexts to overlap once smbc_thread_posix()
+   has set it up for threads. Without that the private contexts are serialised on the CSMB lock. */
+class CSMBContextLock
+{
+public:
+#ifdef HAVE_SMBC_THREAD_POSIX
+  CSMBContextLock() {}
+#else
+  CSMBContextLock() : m_lock(smb) {}
+private:
+  CSingleLock m_lock;
+#endif
+};
+#endif
+
 void xb_smbc_log(const char* msg)
 {
   CLog::Log(LOGINFO, "%s%s", "smb: ", msg);
@@ -72,6 +96,7 @@ CSMB::~CSMB()
 void CSMB::Deinit()
 {
   CSingleLock lock(*this);
+  FreeIdleContexts();
 
   /* samba goes loco if deinited while it has some files opened */
   if (m_context)
@@ -154,6 +179,16 @@ void CSMB::Init()
     set_log_callback(xb_smbc_log);
 #endif
 
+#ifdef HAVE_SMBC_THREAD_POSIX
+    // let the private contexts be used from several threads at once
+    static bool threadsInitialized = false;
+    if (!threadsInitialized)
+    {
+      smbc_thread_posix();
+      threadsInitialized = true;
+    }
+#endif
+
     // setup our context
     m_context = smbc_new_context();
 #ifdef DEPRECATED_SMBC_INTERFACE
@@ -239,6 +274,95 @@ void CSMB::PurgeEx(const CURL& url)
   m_strLastHost = url.GetHostName();
 }
 
+CStdString CSMB::GetContextKey(const CURL &url)
+{
+  CStdString key = url.GetHostName() + "/" + url.GetShareName();
+  key.ToLower();
+  return key;
+}
+
+SMBCCTX *CSMB::CreateContext()
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  { // private contexts rely on the global setup done by Init() for the shared one
+    CSingleLock lock(*this);
+    if (!m_context)
+      return NULL;
+  }
+
+  CSMBContextLock lock;
+  SMBCCTX *context = smbc_new_context();
+  if (!context)
+    return NULL;
+
+  smbc_setDebug(context, g_advancedSettings.m_logLevel == LOG_LEVEL_DEBUG_SAMBA ? 10 : 0);
+  smbc_setFunctionAuthData(context, xb_smbc_auth);
+  smbc_setOptionOneSharePerServer(context, false);
+  smbc_setOptionBrowseMaxLmbCount(context, 0);
+  smbc_setTimeout(context, g_advancedSettings.m_sambaclienttimeout * 1000);
+
+  if (!smbc_init_context(context))
+  {
+    smbc_free_context(context, 1);
+    return NULL;
+  }
+  return context;
+#else
+  return NULL;
+#endif
+}
+
+SMBCCTX *CSMB::AcquireContext(const CURL &url)
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  CStdString key = GetContextKey(url);
+  {
+    CSingleLock lock(m_contextSection);
+    ContextMap::iterator it = m_idleContexts.find(key);
+    if (it != m_idleContexts.end())
+    {
+      SMBCCTX *context = it->second;
+      m_idleContexts.erase(it);
+      return context;
+    }
+  }
+  return CreateContext();
+#else
+  return NULL;
+#endif
+}
+
+void CSMB::ReleaseContext(const CURL &url, SMBCCTX *context)
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  if (!context)
+    return;
+
+  CStdString key = GetContextKey(url);
+  {
+    CSingleLock lock(m_contextSection);
+    if (m_idleContexts.count(key) < SMB_MAX_IDLE_CONTEXTS)
+    {
+      m_idleContexts.insert(std::make_pair(key, context));
+      return;
+    }
+  }
+  CSMBContextLock lock;
+  smbc_free_context(context, 1);
+#endif
+}
+
+void CSMB::FreeIdleContexts()
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  CSMBContextLock lock;
+  CSingleLock contextLock(m_contextSection);
+  for (ContextMap::iterator it = m_idleContexts.begin(); it != m_idleContexts.end(); ++it)
+    smbc_free_context(it->second, 1);
+  m_idleContexts.clear();
+#endif
+}
+
 CStdString CSMB::URLEncode(const CURL &url)
 {
   /* due to smb wanting encoded urls we have to build it manually */
@@ -305,7 +429,13 @@ void CSMB::CheckIfIdle()
   if (m_OpenConnections == 0)
   { /* I've set the the maxiumum IDLE time to be 1 min and 30 sec. */
     CSingleLock lock(*this);
-    if (m_OpenConnections == 0 /* check again - when locked */ && m_context != NULL)
+    bool idleContexts;
+    {
+      CSingleLock contextLock(m_contextSection);
+      idleContexts = !m_idleContexts.empty();
+    }
+    /* private contexts may be left over even when the shared one is gone */
+    if (m_OpenConnections == 0 /* check again - when locked */ && (m_context != NULL || idleContexts))
     {
       if (m_IdleTimeout > 0)
 	  {
@@ -350,6 +480,14 @@ CFileSMB::CFileSMB()
 {
   smb.Init();
   m_fd = -1;
+  m_context = NULL;
+  m_file = NULL;
+  m_position = 0;
+  m_serverPosition = 0;
+  m_readAhead = NULL;
+  m_readAheadSize = 0;
+  m_readAheadStart = 0;
+  m_readAheadLength = 0;
 #ifdef TARGET_POSIX
   smb.AddActiveConnection();
 #endif
@@ -365,6 +503,8 @@ CFileSMB::~CFileSMB()
 
 int64_t CFileSMB::GetPosition()
 {
+  if (m_file)
+    return m_position;
   if (m_fd == -1) return 0;
   smb.Init();
   CSingleLock lock(smb);
@@ -376,7 +516,7 @@ int64_t CFileSMB::GetPosition()
 
 int64_t CFileSMB::GetLength()
 {
-  if (m_fd == -1) return 0;
+  if (m_fd == -1 && !m_file) return 0;
   return m_fileSize;
 }
 
@@ -392,6 +532,14 @@ bool CFileSMB::Open(const CURL& url)
       return false;
   }
   m_url = url;
+  smb.Init();
+
+  // files on a context of their own don't need the global samba lock
+  if (OpenPrivate(url))
+  {
+    CLog::Log(LOGDEBUG,"CFileSMB::Open - opened %s on a private context",url.GetFileName().c_str());
+    return true;
+  }
 
   // opening a file to another computer share will create a new session
   // when opening smb://server xbms will try to find folder.jpg in all shares
@@ -440,6 +588,91 @@ bool CFileSMB::Open(const CURL& url)
 }
 
 
+bool CFileSMB::OpenPrivate(const CURL &url)
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  m_context = smb.AcquireContext(url);
+  if (!m_context)
+    return false;
+
+  CStdString strPath = GetAuthenticatedPath(url);
+  struct stat info;
+  CSMBContextLock lock;
+  m_file = smbc_getFunctionOpen(m_context)(m_context, strPath.c_str(), O_RDONLY, 0);
+  if (!m_file || smbc_getFunctionFstat(m_context)(m_context, m_file, &info) < 0)
+  { // leave anything else (eg prompting for credentials) to the shared context
+    if (m_file)
+      smbc_getFunctionClose(m_context)(m_context, m_file);
+    smb.ReleaseContext(url, m_context);
+    m_context = NULL;
+    m_file = NULL;
+    return false;
+  }
+
+  m_fileSize = info.st_size;
+  m_position = 0;
+  m_serverPosition = 0;
+  m_readAheadSize = g_advancedSettings.m_sambareadahead * 1024;
+  m_readAheadStart = 0;
+  m_readAheadLength = 0;
+  return true;
+#else
+  return false;
+#endif
+}
+
+int CFileSMB::StatPrivate(const CURL &url, struct stat *info)
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  SMBCCTX *context = smb.AcquireContext(url);
+  if (!context)
+    return -1;
+
+  CStdString strPath = GetAuthenticatedPath(url);
+  int iResult;
+  {
+    CSMBContextLock lock;
+    iResult = smbc_getFunctionStat(context)(context, strPath.c_str(), info);
+  }
+  int error = errno;
+  smb.ReleaseContext(url, context);
+  errno = error;
+  return iResult;
+#else
+  errno = ENOSYS;
+  return -1;
+#endif
+}
+
+int CFileSMB::ReadPrivate(int64_t position, char *buffer, unsigned int size)
+{
+#ifdef SMB_PRIVATE_CONTEXTS
+  CSMBContextLock lock;
+  if (position != m_serverPosition)
+  {
+    if (smbc_getFunctionLseek(m_context)(m_context, m_file, position, SEEK_SET) < 0)
+      return -1;
+    m_serverPosition = position;
+  }
+
+  // libsmbclient splits large reads into pipelined requests itself
+  unsigned int total = 0;
+  while (total < size)
+  {
+    ssize_t bytesRead = smbc_getFunctionRead(m_context)(m_context, m_file, buffer + total, size - total);
+    if (bytesRead < 0)
+      return total ? (int)total : -1;
+    if (bytesRead == 0)
+      break;
+    total += bytesRead;
+    m_serverPosition += bytesRead;
+  }
+  return (int)total;
+#else
+  return -1;
+#endif
+}
+
 /// \brief Checks authentication against SAMBA share. Reads password cache created in CSMBDirectory::OpenDir().
 /// \param strAuth The SMB style path
 /// \return SMB file descriptor
@@ -530,6 +763,10 @@ bool CFileSMB::Exists(const CURL& url)
   struct __stat64 info;
 #else
   struct stat info;
+  if (StatPrivate(url, &info) == 0)
+    return true;
+  if (errno == ENOENT)
+    return false;
 #endif
 
   CSingleLock lock(smb);
@@ -541,7 +778,7 @@ bool CFileSMB::Exists(const CURL& url)
 
 int CFileSMB::Stat(struct __stat64* buffer)
 {
-  if (m_fd == -1)
+  if (m_fd == -1 && !m_file)
     return -1;
 
 #ifdef TARGET_WINDOWS
@@ -550,8 +787,19 @@ int CFileSMB::Stat(struct __stat64* buffer)
   struct stat tmpBuffer = {0};
 #endif
 
-  CSingleLock lock(smb);
-  int iResult = smbc_fstat(m_fd, &tmpBuffer);
+  int iResult;
+#ifdef SMB_PRIVATE_CONTEXTS
+  if (m_file)
+  {
+    CSMBContextLock lock;
+    iResult = smbc_getFunctionFstat(m_context)(m_context, m_file, &tmpBuffer);
+  }
+  else
+#endif
+  {
+    CSingleLock lock(smb);
+    iResult = smbc_fstat(m_fd, &tmpBuffer);
+  }
 
   memset(buffer, 0, sizeof(struct __stat64));
   buffer->st_dev = tmpBuffer.st_dev;
@@ -573,14 +821,20 @@ int CFileSMB::Stat(const CURL& url, struct __stat64* buffer)
 {
   smb.Init();
   CStdString strFileName = GetAuthenticatedPath(url);
-  CSingleLock lock(smb);
 
 #ifdef TARGET_WINDOWS
   struct __stat64 tmpBuffer = {0};
+  int iResult;
 #else
   struct stat tmpBuffer = {0};
+  int iResult = StatPrivate(url, &tmpBuffer);
+  // fall back to the shared context unless the private one gave a definite answer
+  if (iResult < 0 && errno != ENOENT)
 #endif
-  int iResult = smbc_stat(strFileName, &tmpBuffer);
+  {
+    CSingleLock lock(smb);
+    iResult = smbc_stat(strFileName, &tmpBuffer);
+  }
 
   memset(buffer, 0, sizeof(struct __stat64));
   buffer->st_dev = tmpBuffer.st_dev;
@@ -600,6 +854,58 @@ int CFileSMB::Stat(const CURL& url, struct __stat64* buffer)
 
 unsigned int CFileSMB::Read(void *lpBuf, int64_t uiBufSize)
 {
+  if (m_file)
+  {
+#ifdef TARGET_POSIX
+    smb.SetActivityTime();
+#endif
+    if (m_position >= m_fileSize || uiBufSize <= 0)
+      return 0;
+
+    // serve what we can from the read-ahead buffer
+    if (m_position >= m_readAheadStart && m_position < m_readAheadStart + m_readAheadLength)
+    {
+      unsigned int offset = (unsigned int)(m_position - m_readAheadStart);
+      unsigned int size = m_readAheadLength - offset;
+      if (uiBufSize < size)
+        size = (unsigned int)uiBufSize;
+      memcpy(lpBuf, m_readAhead + offset, size);
+      m_position += size;
+      return size;
+    }
+
+    int bytesRead;
+    if (uiBufSize >= m_readAheadSize)
+    { // large requests gain nothing from the buffer
+      if (uiBufSize > INT_MAX)
+        uiBufSize = INT_MAX;
+      bytesRead = ReadPrivate(m_position, (char *)lpBuf, (unsigned int)uiBufSize);
+    }
+    else
+    {
+      if (!m_readAhead)
+        m_readAhead = new char[m_readAheadSize];
+      m_readAheadLength = 0;
+      bytesRead = ReadPrivate(m_position, m_readAhead, m_readAheadSize);
+      if (bytesRead > 0)
+      {
+        m_readAheadStart = m_position;
+        m_readAheadLength = bytesRead;
+        if (bytesRead > uiBufSize)
+          bytesRead = (int)uiBufSize;
+        memcpy(lpBuf, m_readAhead, bytesRead);
+      }
+    }
+
+    if (bytesRead < 0)
+    {
+      CLog::Log(LOGERROR, "%s - Error( %d, %d, %s )", __FUNCTION__, bytesRead, errno, strerror(errno));
+      return 0;
+    }
+    m_position += bytesRead;
+    return (unsigned int)bytesRead;
+  }
+
   if (m_fd == -1) return 0;
   CSingleLock lock(smb); // Init not called since it has to be "inited" by now
 #ifdef TARGET_POSIX
@@ -638,6 +944,22 @@ unsigned int CFileSMB::Read(void *lpBuf, int64_t uiBufSize)
 
 int64_t CFileSMB::Seek(int64_t iFilePosition, int iWhence)
 {
+  if (m_file)
+  { // the handle is only moved by the next read that misses the read-ahead buffer
+    int64_t pos;
+    switch (iWhence)
+    {
+    case SEEK_SET: pos = iFilePosition; break;
+    case SEEK_CUR: pos = m_position + iFilePosition; break;
+    case SEEK_END: pos = m_fileSize + iFilePosition; break;
+    default: return -1;
+    }
+    if (pos < 0)
+      return -1;
+    m_position = pos;
+    return m_position;
+  }
+
   if (m_fd == -1) return -1;
 
   CSingleLock lock(smb); // Init not called since it has to be "inited" by now
@@ -661,6 +983,21 @@ int64_t CFileSMB::Seek(int64_t iFilePosition, int iWhence)
 
 void CFileSMB::Close()
 {
+#ifdef SMB_PRIVATE_CONTEXTS
+  if (m_file)
+  {
+    {
+      CSMBContextLock lock;
+      smbc_getFunctionClose(m_context)(m_context, m_file);
+    }
+    smb.ReleaseContext(m_url, m_context);
+  }
+#endif
+  m_file = NULL;
+  m_context = NULL;
+  SAFE_DELETE_ARRAY(m_readAhead);
+  m_readAheadLength = 0;
+
   if (m_fd != -1)
   {
     CLog::Log(LOGDEBUG,"CFileSMB::Close closing fd %d", m_fd);
@@ -41,6 +41,7 @@
 #include "IFile.h"
 #include "URL.h"
 #include "threads/CriticalSection.h"
+#include <map>
 
 #define NT_STATUS_CONNECTION_REFUSED long(0xC0000000 | 0x0236)
 #define NT_STATUS_INVALID_HANDLE long(0xC0000000 | 0x0008)
@@ -52,6 +53,8 @@
 
 struct _SMBCCTX;
 typedef _SMBCCTX SMBCCTX;
+struct _SMBCFILE;
+typedef _SMBCFILE SMBCFILE;
 
 class CSMB : public CCriticalSection
 {
@@ -72,7 +75,26 @@ public:
   CStdString URLEncode(const CURL &url);
 
   DWORD ConvertUnixToNT(int error);
+
+  /*! \brief Get a libsmbclient context of its own for accessing a file on the given share.
+   Each context holds its own connection, so files opened through one are read without
+   taking the CSMB lock and in parallel with everything else. Released contexts are kept
+   per server/share for reuse until samba goes idle.
+   \param url the file that is going to be accessed.
+   \return the context, or NULL if they aren't supported, in which case the shared context is used.
+   \sa ReleaseContext
+   */
+  SMBCCTX *AcquireContext(const CURL &url);
+  void ReleaseContext(const CURL &url, SMBCCTX *context);
 private:
+  SMBCCTX *CreateContext();
+  void FreeIdleContexts();
+  static CStdString GetContextKey(const CURL &url);
+
+  typedef std::multimap<CStdString, SMBCCTX *> ContextMap;
+  ContextMap m_idleContexts;
+  CCriticalSection m_contextSection;
+
   SMBCCTX *m_context;
   CStdString m_strLastHost;
   CStdString m_strLastShare;
@@ -114,6 +136,21 @@ protected:
   CStdString GetAuthenticatedPath(const CURL &url);
   int64_t m_fileSize;
   int m_fd;
+
+private:
+  bool OpenPrivate(const CURL &url);
+  int StatPrivate(const CURL &url, struct stat *info);
+  int ReadPrivate(int64_t position, char *buffer, unsigned int size);
+
+  // files opened on a context of their own (see CSMB::AcquireContext) use these instead of m_fd
+  SMBCCTX  *m_context;
+  SMBCFILE *m_file;
+  int64_t   m_position;       ///< position the caller sees
+  int64_t   m_serverPosition; ///< position of the handle on the server
+  char     *m_readAhead;
+  unsigned int m_readAheadSize;
+  int64_t   m_readAheadStart; ///< file offset of the data in m_readAhead
+  unsigned int m_readAheadLength;
 };
 }
 
@@ -0,0 +1,222 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "FileStatCache.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <string.h>
+
+using namespace XFILE;
+using namespace std;
+
+CFileStatCache::CFileStatCache()
+{
+  ResetStats();
+}
+
+unsigned int CFileStatCache::GetTTL(const CStdString &path, bool exists) const
+{
+  size_t protocolEnd = path.find("://");
+  if (protocolEnd == CStdString::npos)
+    return 0; // local file
+
+  CStdString protocol = path.Left(protocolEnd);
+  protocol.ToLower();
+  map<CStdString, StatCacheTTL>::const_iterator i = g_advancedSettings.m_statCacheTTLs.find(protocol);
+  if (i == g_advancedSettings.m_statCacheTTLs.end())
+    return 0;
+
+  int ttl = exists ? i->second.ttl : i->second.negativettl;
+  return ttl > 0 ? ttl * 1000 : 0;
+}
+
+CFileStatCache::CEntry *CFileStatCache::Find(const CStdString &path)
+{
+  map<CStdString, CEntry>::iterator i = m_entries.find(path);
+  if (i == m_entries.end())
+    return NULL;
+
+  if ((int)(i->second.expires - XbmcThreads::SystemClockMillis()) <= 0)
+  {
+    m_entries.erase(i);
+    return NULL;
+  }
+  return &i->second;
+}
+
+CFileStatCache::CEntry *CFileStatCache::Store(const CStdString &path, bool exists)
+{
+  unsigned int ttl = GetTTL(path, exists);
+  if (!ttl)
+    return NULL;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_entries.size() >= MAX_ENTRIES)
+  { // drop what has expired, or everything if that doesn't make room
+    for (map<CStdString, CEntry>::iterator i = m_entries.begin(); i != m_entries.end();)
+    {
+      if ((int)(i->second.expires - now) <= 0)
+        m_entries.erase(i++);
+      else
+        ++i;
+    }
+    if (m_entries.size() >= MAX_ENTRIES)
+      m_entries.clear();
+  }
+
+  CEntry &entry = m_entries[path];
+  entry.expires = now + ttl;
+  entry.exists = exists;
+  entry.hasStat = false;
+  entry.result = -1;
+  return &entry;
+}
+
+bool CFileStatCache::GetExists(const CStdString &path, bool &exists)
+{
+  if (!GetTTL(path, true) && !GetTTL(path, false))
+    return false; // not a cached protocol, so not counted
+
+  CSingleLock lock(m_section);
+  CEntry *entry = Find(path);
+  if (!entry)
+  {
+    m_stats.misses++;
+    return false;
+  }
+
+  exists = entry->exists;
+  if (exists)
+    m_stats.hits++;
+  else
+    m_stats.negativeHits++;
+  return true;
+}
+
+bool CFileStatCache::GetStat(const CStdString &path, struct __stat64 *buffer, int &result)
+{
+  if (!GetTTL(path, true) && !GetTTL(path, false))
+    return false; // not a cached protocol, so not counted
+
+  CSingleLock lock(m_section);
+  CEntry *entry = Find(path);
+  if (entry && !entry->exists)
+  { // a missing file can't be stat'ed
+    m_stats.negativeHits++;
+    result = -1;
+    return true;
+  }
+  if (!entry || !entry->hasStat)
+  {
+    m_stats.misses++;
+    return false;
+  }
+
+  m_stats.hits++;
+  result = entry->result;
+  if (result == 0 && buffer)
+    memcpy(buffer, &entry->stat, sizeof(struct __stat64));
+  return true;
+}
+
+void CFileStatCache::SetExists(const CStdString &path, bool exists)
+{
+  CSingleLock lock(m_section);
+  CEntry *entry = Find(path);
+  if (entry && entry->exists == exists)
+    return; // keep any stat we have
+
+  Store(path, exists);
+}
+
+void CFileStatCache::SetStat(const CStdString &path, const struct __stat64 *buffer, int result)
+{
+  if (result == 0 && !buffer)
+    return;
+
+  CSingleLock lock(m_section);
+  // a failed stat doesn't mean the file is missing, as not every filesystem implements it
+  CEntry *entry = Find(path);
+  if (!entry)
+    entry = Store(path, true);
+  if (!entry || !entry->exists)
+    return;
+
+  entry->hasStat = true;
+  entry->result = result;
+  if (result == 0)
+    memcpy(&entry->stat, buffer, sizeof(struct __stat64));
+}
+
+void CFileStatCache::Invalidate(const CStdString &path)
+{
+  CSingleLock lock(m_section);
+  if (m_entries.erase(path))
+    m_stats.invalidations++;
+}
+
+void CFileStatCache::InvalidateSubPaths(const CStdString &path)
+{
+  CStdString prefix(path);
+  URIUtils::RemoveSlashAtEnd(prefix);
+
+  CSingleLock lock(m_section);
+  Invalidate(prefix);
+  URIUtils::AddSlashAtEnd(prefix);
+  map<CStdString, CEntry>::iterator i = m_entries.lower_bound(prefix);
+  while (i != m_entries.end() && i->first.compare(0, prefix.size(), prefix) == 0)
+  {
+    m_entries.erase(i++);
+    m_stats.invalidations++;
+  }
+}
+
+void CFileStatCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+}
+
+void CFileStatCache::GetStats(Stats &stats) const
+{
+  CSingleLock lock(m_section);
+  stats = m_stats;
+  stats.entries = m_entries.size();
+}
+
+void CFileStatCache::ResetStats()
+{
+  CSingleLock lock(m_section);
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+void CFileStatCache::LogStats(const char *context) const
+{
+  Stats stats;
+  GetStats(stats);
+  unsigned int lookups = stats.hits + stats.negativeHits + stats.misses;
+  CLog::Log(LOGDEBUG, "%s: file stat cache answered %u of %u lookups (%u for missing files), %u invalidations, %u entries",
+            context, stats.hits + stats.negativeHits, lookups, stats.negativeHits, stats.invalidations, stats.entries);
+}
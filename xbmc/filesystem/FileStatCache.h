@@ -0,0 +1,103 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <map>
+#include "system.h"
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+namespace XFILE
+{
+  /*! \brief Short lived cache of the results of CFile::Exists() and CFile::Stat() on remote filesystems.
+
+   Both files that exist and files that don't are cached, for the time given by the protocol's
+   entry in advancedsettings <statcache> - protocols without an entry (such as local files) are
+   never cached. CFile drops the entries of files it writes, deletes or renames.
+
+   Paths are expected to have been through URIUtils::SubstitutePath() already.
+   */
+  class CFileStatCache
+  {
+  public:
+    struct Stats
+    {
+      unsigned int hits;          ///< lookups answered from a cached file
+      unsigned int negativeHits;  ///< lookups answered from a cached missing file
+      unsigned int misses;        ///< lookups passed on to the filesystem
+      unsigned int invalidations;
+      unsigned int entries;
+    };
+
+    CFileStatCache();
+
+    /*! \brief Look up whether a file exists.
+     \return true if it was known, with exists set.
+     */
+    bool GetExists(const CStdString &path, bool &exists);
+
+    /*! \brief Look up the stat of a file.
+     \return true if it was known, with result set to the return value of the stat and buffer filled in on success.
+     */
+    bool GetStat(const CStdString &path, struct __stat64 *buffer, int &result);
+
+    void SetExists(const CStdString &path, bool exists);
+    void SetStat(const CStdString &path, const struct __stat64 *buffer, int result);
+
+    /*! \brief Drop the entry of a file that has been changed.
+     */
+    void Invalidate(const CStdString &path);
+
+    /*! \brief Drop the entries of a directory and everything within it.
+     */
+    void InvalidateSubPaths(const CStdString &path);
+
+    void Clear();
+
+    void GetStats(Stats &stats) const;
+    void ResetStats();
+    void LogStats(const char *context) const;
+
+  private:
+    struct CEntry
+    {
+      unsigned int    expires;
+      bool            exists;
+      bool            hasStat;   ///< whether result and stat hold the result of a stat call
+      int             result;
+      struct __stat64 stat;
+    };
+
+    static const unsigned int MAX_ENTRIES = 8192;
+
+    /*! \brief How long entries for the path are kept for, or 0 if it isn't cached.
+     */
+    unsigned int GetTTL(const CStdString &path, bool exists) const;
+    CEntry *Find(const CStdString &path);
+    CEntry *Store(const CStdString &path, bool exists);
+
+    std::map<CStdString, CEntry> m_entries;
+    mutable CCriticalSection     m_section;
+    Stats                        m_stats;
+  };
+}
+
+extern XFILE::CFileStatCache g_fileStatCache;
@@ -21,11 +21,17 @@
 
 #include "FileZip.h"
 #include "URL.h"
+#include "SpecialProtocol.h"
 #include "utils/URIUtils.h"
 
 #include <sys/stat.h>
+#ifdef TARGET_POSIX
+#include <sys/mman.h>
+#include <fcntl.h>
+#endif
 
 #define ZIP_CACHE_LIMIT 4*1024*1024
+#define ZIP_INFLATED_BLOCKS 8
 
 using namespace XFILE;
 using namespace std;
@@ -37,12 +43,18 @@ CFileZip::CFileZip()
   m_iDataInStringBuffer = 0;
   m_bCached = false;
   m_iRead = -1;
+  m_bKeepInflated = false;
+  m_iStreamPos = 0;
+  m_pMapped = NULL;
+  m_iMappedSize = 0;
+  m_pMappedData = NULL;
 }
 
 CFileZip::~CFileZip()
 {
   delete[] m_szStringBuffer;
   Close();
+  ClearInflated();
 }
 
 bool CFileZip::Open(const CURL&url)
@@ -84,13 +96,60 @@ bool CFileZip::Open(const CURL&url)
     return false;
   }
   mFile.Seek(mZipItem.offset,SEEK_SET);
-  return InitDecompress();
+  if (!InitDecompress())
+    return false;
+
+  if (mZipItem.method == 0)
+    MapStored(url.GetHostName());
+  else
+    m_bKeepInflated = true;
+  return true;
+}
+
+bool CFileZip::MapStored(const CStdString& strZip)
+{
+#ifdef TARGET_POSIX
+  if (!URIUtils::IsHD(strZip) || mZipItem.csize == 0)
+    return false;
+
+  int fd = open(CSpecialProtocol::TranslatePath(strZip).c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+
+  // mappings have to start on a page boundary
+  int64_t iPageSize = sysconf(_SC_PAGESIZE);
+  int64_t iMapStart = mZipItem.offset - mZipItem.offset % iPageSize;
+  size_t iMapSize = (size_t)(mZipItem.offset - iMapStart + mZipItem.csize);
+  void* pMapped = mmap(NULL, iMapSize, PROT_READ, MAP_SHARED, fd, iMapStart);
+  close(fd);
+  if (pMapped == MAP_FAILED)
+    return false;
+
+  m_pMapped = (char*)pMapped;
+  m_iMappedSize = iMapSize;
+  m_pMappedData = m_pMapped + (mZipItem.offset - iMapStart);
+  return true;
+#else
+  return false;
+#endif
+}
+
+void CFileZip::UnmapStored()
+{
+#ifdef TARGET_POSIX
+  if (m_pMapped)
+    munmap(m_pMapped, m_iMappedSize);
+#endif
+  m_pMapped = NULL;
+  m_iMappedSize = 0;
+  m_pMappedData = NULL;
 }
 
 bool CFileZip::InitDecompress()
 {
   m_iRead = 1;
   m_iFilePos = 0;
+  m_iStreamPos = 0;
   m_iZipFilePos = 0;
   m_iAvailBuffer = 0;
   m_bFlush = false;
@@ -129,6 +188,26 @@ int64_t CFileZip::Seek(int64_t iFilePosition, int iWhence)
 {
   if (m_bCached)
     return mFile.Seek(iFilePosition,iWhence);
+  if (m_pMappedData || mZipItem.method == 8)
+  { // the data is positioned by the next read
+    switch (iWhence)
+    {
+    case SEEK_SET:
+      break;
+    case SEEK_CUR:
+      iFilePosition += m_iFilePos;
+      break;
+    case SEEK_END:
+      iFilePosition += mZipItem.usize;
+      break;
+    default:
+      return -1;
+    }
+    if (iFilePosition > mZipItem.usize || iFilePosition < 0)
+      return -1;
+    m_iFilePos = iFilePosition;
+    return m_iFilePos;
+  }
   if (mZipItem.method == 0) // this is easy
   {
     int64_t iResult;
@@ -165,75 +244,34 @@ int64_t CFileZip::Seek(int64_t iFilePosition, int iWhence)
 
     }
   }
-  // here goes the stupid part..
-  if (mZipItem.method == 8)
-  {
-    char temp[131072];
-    switch (iWhence)
-    {
-    case SEEK_SET:
-      if (iFilePosition == m_iFilePos)
-        return m_iFilePos; // mp3reader does this lots-of-times
-      if (iFilePosition > mZipItem.usize || iFilePosition < 0)
-        return -1;
-      // read until position in 128k blocks.. only way to do it due to format.
-      // can't start in the middle of data since then we'd have no clue where
-      // we are in uncompressed data..
-      if (iFilePosition < m_iFilePos)
-      {
-        m_iFilePos = 0;
-        m_iZipFilePos = 0;
-        inflateEnd(&m_ZStream);
-        inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
-        mFile.Seek(mZipItem.offset,SEEK_SET);
-        m_ZStream.next_in = (Bytef*)m_szBuffer;
-        m_ZStream.avail_in = 0;
-        m_ZStream.total_out = 0;
-        while (m_iFilePos < iFilePosition)
-        {
-          unsigned int iToRead = (iFilePosition-m_iFilePos)>131072?131072:(int)(iFilePosition-m_iFilePos);
-          if (Read(temp,iToRead) != iToRead)
-            return -1;
-        }
-        return m_iFilePos;
-      }
-      else // seek forward
-        return Seek(iFilePosition-m_iFilePos,SEEK_CUR);
-      break;
-
-    case SEEK_CUR:
-      if (iFilePosition < 0)
-        return Seek(m_iFilePos+iFilePosition,SEEK_SET); // can't rewind stream
-      // read until requested position, drop data
-      if (m_iFilePos+iFilePosition > mZipItem.usize)
-        return -1;
-      iFilePosition += m_iFilePos;
-      while (m_iFilePos < iFilePosition)
-      {
-        unsigned int iToRead = (iFilePosition-m_iFilePos)>131072?131072:(int)(iFilePosition-m_iFilePos);
-        if (Read(temp,iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
-      break;
+  return -1;
+}
 
-    case SEEK_END:
-      // now this is a nasty bastard, possibly takes lotsoftime
-      // uncompress, minding m_ZStream.total_out
+bool CFileZip::SeekInflated(int64_t iFilePosition)
+{
+  // we can't start in the middle of the deflated data, so restart if we're past the position
+  if (iFilePosition < m_iStreamPos)
+  {
+    m_iZipFilePos = 0;
+    m_iStreamPos = 0;
+    m_bFlush = false;
+    inflateEnd(&m_ZStream);
+    inflateInit2(&m_ZStream,-MAX_WBITS); // simply restart zlib
+    mFile.Seek(mZipItem.offset,SEEK_SET);
+    m_ZStream.next_in = (Bytef*)m_szBuffer;
+    m_ZStream.avail_in = 0;
+    m_ZStream.total_out = 0;
+  }
 
-      while( (int)m_ZStream.total_out < mZipItem.usize+iFilePosition)
-      {
-        unsigned int iToRead = (mZipItem.usize+iFilePosition-m_ZStream.total_out > 131072)?131072:(int)(mZipItem.usize+iFilePosition-m_ZStream.total_out);
-        if (Read(temp,iToRead) != iToRead)
-          return -1;
-      }
-      return m_iFilePos;
-      break;
-    default:
-      return -1;
-    }
+  // inflate until the position in 128k blocks, keeping what we pass
+  char temp[131072];
+  while (m_iStreamPos < iFilePosition)
+  {
+    unsigned int iToRead = (iFilePosition-m_iStreamPos)>131072?131072:(int)(iFilePosition-m_iStreamPos);
+    if (Inflate(temp,iToRead) != iToRead)
+      return false;
   }
-  return -1;
+  return true;
 }
 
 bool CFileZip::Exists(const CURL& url)
@@ -289,47 +327,32 @@ unsigned int CFileZip::Read(void* lpBuf, int64_t uiBufSize)
     uiBufSize -= iMax;
     m_iDataInStringBuffer -= iMax;
   }
+  if (m_pMappedData) // stored in a local zip, copy straight from the mapping
+  {
+    if (uiBufSize+m_iFilePos > mZipItem.csize)
+      uiBufSize = mZipItem.csize-m_iFilePos;
+    if (uiBufSize <= 0)
+      return 0;
+    memcpy(lpBuf,m_pMappedData+m_iFilePos,(size_t)uiBufSize);
+    m_iFilePos += uiBufSize;
+    return static_cast<unsigned int>(uiBufSize);
+  }
   if (mZipItem.method == 8) // deflated
   {
-    uLong iDecompressed = 0;
-    uLong prevOut = m_ZStream.total_out;
-    while (((int)iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_bFlush)))
-    {
-      m_ZStream.next_out = (Bytef*)(lpBuf)+iDecompressed;
-      m_ZStream.avail_out = static_cast<uInt>(uiBufSize-iDecompressed);
-      if (m_bFlush) // need to flush buffer !
-      {
-        int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
-        m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false;
-        if (!m_ZStream.avail_out) // flush filled buffer, get out of here
-        {
-          iDecompressed = m_ZStream.total_out-prevOut;
-          break;
-        }
-      }
-
-      if (!m_ZStream.avail_in)
-      {
-        if (!FillBuffer()) // eof!
-        {
-          iDecompressed = m_ZStream.total_out-prevOut;
-          break;
-        }
-      }
-
-      int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
-      if (iMessage < 0)
+    if (m_iFilePos != m_iStreamPos)
+    { // we've seeked - use what was inflated before if we can
+      unsigned int iRead = ReadInflated(lpBuf,uiBufSize);
+      if (iRead)
       {
-        Close();
-        return 0; // READ ERROR
+        m_iFilePos += iRead;
+        return iRead;
       }
-
-      m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false; // more info in input buffer
-
-      iDecompressed = m_ZStream.total_out-prevOut;
+      if (!SeekInflated(m_iFilePos))
+        return 0;
     }
-    m_iFilePos += iDecompressed;
-    return static_cast<unsigned int>(iDecompressed);
+    unsigned int iRead = Inflate(lpBuf,uiBufSize);
+    m_iFilePos = m_iStreamPos;
+    return iRead;
   }
   else if (mZipItem.method == 0) // uncompressed. just read from file, but mind our boundaries.
   {
@@ -348,11 +371,132 @@ unsigned int CFileZip::Read(void* lpBuf, int64_t uiBufSize)
     return false; // shouldn't happen. compression method checked in open
 }
 
+unsigned int CFileZip::Inflate(void* lpBuf, int64_t uiBufSize)
+{
+  uLong iDecompressed = 0;
+  uLong prevOut = m_ZStream.total_out;
+  while (((int)iDecompressed < uiBufSize) && ((m_iZipFilePos < mZipItem.csize) || (m_bFlush)))
+  {
+    m_ZStream.next_out = (Bytef*)(lpBuf)+iDecompressed;
+    m_ZStream.avail_out = static_cast<uInt>(uiBufSize-iDecompressed);
+    if (m_bFlush) // need to flush buffer !
+    {
+      int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+      m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false;
+      if (!m_ZStream.avail_out) // flush filled buffer, get out of here
+      {
+        iDecompressed = m_ZStream.total_out-prevOut;
+        break;
+      }
+    }
+
+    if (!m_ZStream.avail_in)
+    {
+      if (!FillBuffer()) // eof!
+      {
+        iDecompressed = m_ZStream.total_out-prevOut;
+        break;
+      }
+    }
+
+    int iMessage = inflate(&m_ZStream,Z_SYNC_FLUSH);
+    if (iMessage < 0)
+    {
+      Close();
+      return 0; // READ ERROR
+    }
+
+    m_bFlush = ((iMessage == Z_OK) && (m_ZStream.avail_out == 0))?true:false; // more info in input buffer
+
+    iDecompressed = m_ZStream.total_out-prevOut;
+  }
+  if (m_bKeepInflated)
+    StoreInflated(m_iStreamPos,(const char*)lpBuf,iDecompressed);
+  m_iStreamPos += iDecompressed;
+  return static_cast<unsigned int>(iDecompressed);
+}
+
+void CFileZip::StoreInflated(int64_t iPosition, const char* lpBuf, unsigned int uiSize)
+{
+  const unsigned int iBlockSize = CInflatedBlock::BLOCK_SIZE;
+  while (uiSize > 0)
+  {
+    int64_t iStart = iPosition - iPosition % iBlockSize;
+    CInflatedBlock* block = NULL;
+    for (list<CInflatedBlock*>::iterator it = m_inflated.begin(); it != m_inflated.end(); ++it)
+    {
+      if ((*it)->iStart == iStart)
+      {
+        block = *it;
+        m_inflated.erase(it);
+        break;
+      }
+    }
+    if (!block)
+    {
+      if (m_inflated.size() >= ZIP_INFLATED_BLOCKS)
+      { // recycle the least recently used block
+        block = m_inflated.back();
+        m_inflated.pop_back();
+      }
+      else
+        block = new CInflatedBlock;
+      block->iStart = iStart;
+      block->iSize = 0;
+    }
+    m_inflated.push_front(block);
+
+    unsigned int iOffset = (unsigned int)(iPosition - iStart);
+    unsigned int iCopy = iBlockSize - iOffset;
+    if (iCopy > uiSize)
+      iCopy = uiSize;
+    if (iOffset <= block->iSize) // blocks only ever hold contiguous data from their start
+    {
+      memcpy(block->data + iOffset, lpBuf, iCopy);
+      if (iOffset + iCopy > block->iSize)
+        block->iSize = iOffset + iCopy;
+    }
+    iPosition += iCopy;
+    lpBuf += iCopy;
+    uiSize -= iCopy;
+  }
+}
+
+unsigned int CFileZip::ReadInflated(void* lpBuf, int64_t uiBufSize)
+{
+  for (list<CInflatedBlock*>::iterator it = m_inflated.begin(); it != m_inflated.end(); ++it)
+  {
+    CInflatedBlock* block = *it;
+    if (m_iFilePos >= block->iStart && m_iFilePos < block->iStart + block->iSize)
+    {
+      unsigned int iOffset = (unsigned int)(m_iFilePos - block->iStart);
+      unsigned int iCopy = block->iSize - iOffset;
+      if (iCopy > uiBufSize)
+        iCopy = (unsigned int)uiBufSize;
+      memcpy(lpBuf, block->data + iOffset, iCopy);
+      m_inflated.erase(it);
+      m_inflated.push_front(block);
+      return iCopy;
+    }
+  }
+  return 0;
+}
+
+void CFileZip::ClearInflated()
+{
+  for (list<CInflatedBlock*>::iterator it = m_inflated.begin(); it != m_inflated.end(); ++it)
+    delete *it;
+  m_inflated.clear();
+}
+
 void CFileZip::Close()
 {
   if (mZipItem.method == 8 && !m_bCached && m_iRead != -1)
     inflateEnd(&m_ZStream);
 
+  UnmapStored();
+  ClearInflated();
+  m_bKeepInflated = false;
   mFile.Close();
 }
 /* CHANGED: JM - moved to CFile
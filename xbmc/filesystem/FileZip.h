@@ -24,6 +24,7 @@
 
 #include "IFile.h"
 #include <zlib.h>
+#include <list>
 #include "utils/log.h"
 #include "File.h"
 #include "ZipManager.h"
@@ -52,6 +53,31 @@ namespace XFILE
     bool InitDecompress();
     bool FillBuffer();
     void DestroyBuffer(void* lpBuffer, int iBufSize);
+    unsigned int Inflate(void* lpBuf, int64_t uiBufSize);
+    bool SeekInflated(int64_t iFilePosition);
+    bool MapStored(const CStdString& strZip);
+    void UnmapStored();
+
+    /*! \brief Recently inflated data, kept so that seeking back doesn't restart the inflater.
+     */
+    struct CInflatedBlock
+    {
+      static const unsigned int BLOCK_SIZE = 65536;
+      int64_t iStart;
+      unsigned int iSize;
+      char data[BLOCK_SIZE];
+    };
+    void StoreInflated(int64_t iPosition, const char* lpBuf, unsigned int uiSize);
+    unsigned int ReadInflated(void* lpBuf, int64_t uiBufSize);
+    void ClearInflated();
+    std::list<CInflatedBlock*> m_inflated; // most recently used first
+    bool m_bKeepInflated;
+    int64_t m_iStreamPos; // position of the inflater in _uncompressed_ data
+
+    char* m_pMapped;        // mapping of a stored file in a local zip
+    size_t m_iMappedSize;
+    const char* m_pMappedData;
+
     CFile mFile;
     SZipEntry mZipItem;
     int64_t m_iFilePos; // position in _uncompressed_ data read
@@ -0,0 +1,379 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "system.h"
+#include "HTTPFetchService.h"
+#include "DllLibCurl.h"
+#include "URL.h"
+#include "SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/GUISettings.h"
+#include "settings/Settings.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+#include <algorithm>
+
+using namespace XFILE;
+using namespace XCURL;
+using namespace std;
+
+CHTTPFetchService::CHTTPFetchService()
+  : CThread("HTTPFetchService"), m_started(false), m_stopping(false), m_multi(NULL)
+{
+}
+
+CHTTPFetchService::~CHTTPFetchService()
+{
+  Stop();
+}
+
+CHTTPFetchService &CHTTPFetchService::Get()
+{
+  static CHTTPFetchService service;
+  return service;
+}
+
+bool CHTTPFetchService::CanFetch(const CStdString &url)
+{
+  CURL curl(url);
+  return (curl.GetProtocol().Equals("http") || curl.GetProtocol().Equals("https")) &&
+          curl.GetProtocolOptions().IsEmpty() && curl.GetUserName().IsEmpty();
+}
+
+bool CHTTPFetchService::Fetch(const CStdString &url, std::string &data, unsigned int timeoutMs)
+{
+  vector<CHTTPFetchRequest> requests;
+  requests.push_back(CHTTPFetchRequest(url));
+  Fetch(requests, timeoutMs);
+  data.swap(requests[0].m_data);
+  return requests[0].m_success;
+}
+
+void CHTTPFetchService::Fetch(vector<CHTTPFetchRequest> &requests, unsigned int timeoutMs)
+{
+  if (requests.empty())
+    return;
+
+  CBatch batch;
+  batch.pending = requests.size();
+  if (!Submit(requests, batch))
+    return;
+  if (!batch.done.WaitMSec(timeoutMs))
+  {
+    CLog::Log(LOGWARNING, "CHTTPFetchService: gave up on %ld of %u requests after %u ms", batch.pending, (unsigned int)requests.size(), timeoutMs);
+    Cancel(batch);
+  }
+}
+
+bool CHTTPFetchService::Submit(vector<CHTTPFetchRequest> &requests, CBatch &batch)
+{
+  CSingleLock lock(m_section);
+  if (!m_started)
+  {
+    if (m_stopping)
+      return false;
+    // reap a worker that exited on its own (it stops taking requests before it does)
+    StopThread(true);
+    m_started = true;
+    Create();
+  }
+
+  for (vector<CHTTPFetchRequest>::iterator i = requests.begin(); i != requests.end(); ++i)
+  {
+    // attach to a transfer of the same URL if there is one
+    map<CStdString, CTransfer *>::iterator it = m_transfers.find(i->m_url);
+    CTransfer *transfer;
+    if (it != m_transfers.end())
+      transfer = it->second;
+    else
+    {
+      transfer = new CTransfer;
+      transfer->url = i->m_url;
+      transfer->host = CURL(i->m_url).GetHostName();
+      transfer->easy = NULL;
+      m_transfers.insert(make_pair(i->m_url, transfer));
+      m_queue.push_back(transfer);
+    }
+    transfer->targets.push_back(make_pair(&(*i), &batch));
+  }
+  m_wakeup.Set();
+  return true;
+}
+
+void CHTTPFetchService::Cancel(CBatch &batch)
+{
+  // FinishTransfer() signals the batch under m_section, so once we have it nothing else refers to it
+  CSingleLock lock(m_section);
+  for (map<CStdString, CTransfer *>::iterator it = m_transfers.begin(); it != m_transfers.end();)
+  {
+    CTransfer *transfer = it->second;
+    for (vector< pair<CHTTPFetchRequest *, CBatch *> >::iterator i = transfer->targets.begin(); i != transfer->targets.end();)
+    {
+      if (i->second == &batch)
+        i = transfer->targets.erase(i);
+      else
+        ++i;
+    }
+    // active transfers are left to complete, while queued ones nobody waits for are dropped
+    if (transfer->targets.empty() && !transfer->easy)
+    {
+      m_queue.erase(find(m_queue.begin(), m_queue.end(), transfer));
+      m_transfers.erase(it++);
+      delete transfer;
+    }
+    else
+      ++it;
+  }
+}
+
+void CHTTPFetchService::Stop()
+{
+  {
+    CSingleLock lock(m_section);
+    m_stopping = true;
+  }
+
+  StopThread(true);
+
+  CSingleLock lock(m_section);
+  m_stopping = false;
+}
+
+size_t CHTTPFetchService::WriteCallback(char *buffer, size_t size, size_t nitems, void *userp)
+{
+  CTransfer *transfer = (CTransfer *)userp;
+  transfer->data.append(buffer, size * nitems);
+  return size * nitems;
+}
+
+bool CHTTPFetchService::StartTransfer(CTransfer *transfer)
+{
+  CURL_HANDLE *h;
+  if (m_idleHandles.size())
+  { // reusing the handle keeps its connection and dns caches
+    h = m_idleHandles.back();
+    m_idleHandles.pop_back();
+    g_curlInterface.easy_reset(h);
+  }
+  else
+    h = g_curlInterface.easy_init();
+  if (!h)
+    return false;
+
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, transfer->url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEDATA, transfer);
+  g_curlInterface.easy_setopt(h, CURLOPT_WRITEFUNCTION, WriteCallback);
+  g_curlInterface.easy_setopt(h, CURLOPT_FOLLOWLOCATION, TRUE);
+  g_curlInterface.easy_setopt(h, CURLOPT_MAXREDIRS, 5);
+  g_curlInterface.easy_setopt(h, CURLOPT_NOSIGNAL, TRUE);
+  g_curlInterface.easy_setopt(h, CURLOPT_FAILONERROR, 1);
+  g_curlInterface.easy_setopt(h, CURLOPT_ENCODING, "");
+  // never verify peer, we don't have any certificates to do this
+  g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
+  g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
+  g_curlInterface.easy_setopt(h, CURLOPT_USERAGENT, g_settings.m_userAgent.c_str());
+  if (g_advancedSettings.m_curlDisableIPV6)
+    g_curlInterface.easy_setopt(h, CURLOPT_IPRESOLVE, CURL_IPRESOLVE_V4);
+  g_curlInterface.easy_setopt(h, CURLOPT_CONNECTTIMEOUT, g_advancedSettings.m_curlconnecttimeout);
+  g_curlInterface.easy_setopt(h, CURLOPT_LOW_SPEED_LIMIT, 1);
+  g_curlInterface.easy_setopt(h, CURLOPT_LOW_SPEED_TIME, g_advancedSettings.m_curllowspeedtime);
+
+  // the same cookies and proxy as CFileCurl
+  if (m_cookieFile.IsEmpty())
+    URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath(g_advancedSettings.m_cachePath), "cookies.dat", m_cookieFile);
+  g_curlInterface.easy_setopt(h, CURLOPT_COOKIEFILE, m_cookieFile.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_COOKIEJAR, m_cookieFile.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_COOKIELIST, "FLUSH");
+
+  if (g_guiSettings.GetBool("network.usehttpproxy"))
+  {
+    transfer->proxy = "http://" + g_guiSettings.GetString("network.httpproxyserver");
+    transfer->proxy += ":" + g_guiSettings.GetString("network.httpproxyport");
+    g_curlInterface.easy_setopt(h, CURLOPT_PROXY, transfer->proxy.c_str());
+    if (g_guiSettings.GetString("network.httpproxyusername").length() > 0)
+    {
+      transfer->proxyUserPass = g_guiSettings.GetString("network.httpproxyusername");
+      transfer->proxyUserPass += ":" + g_guiSettings.GetString("network.httpproxypassword");
+      g_curlInterface.easy_setopt(h, CURLOPT_PROXYUSERPWD, transfer->proxyUserPass.c_str());
+    }
+  }
+
+  if (g_curlInterface.multi_add_handle(m_multi, h) != CURLM_OK)
+  {
+    g_curlInterface.easy_cleanup(h);
+    return false;
+  }
+  transfer->easy = h;
+  m_active.insert(make_pair(h, transfer));
+  m_hostTransfers[transfer->host]++;
+  return true;
+}
+
+void CHTTPFetchService::StartTransfers()
+{
+  CSingleLock lock(m_section);
+  for (deque<CTransfer *>::iterator i = m_queue.begin(); i != m_queue.end() && m_active.size() < MAX_TRANSFERS;)
+  {
+    CTransfer *transfer = *i;
+    if (m_hostTransfers[transfer->host] >= MAX_HOST_TRANSFERS)
+    { // leave it queued until a transfer to this host completes
+      ++i;
+      continue;
+    }
+    i = m_queue.erase(i);
+    if (!StartTransfer(transfer))
+    {
+      CLog::Log(LOGERROR, "CHTTPFetchService: unable to start transfer of %s", transfer->url.c_str());
+      FinishTransfer(transfer, false, 0);
+    }
+  }
+}
+
+void CHTTPFetchService::FinishTransfer(CTransfer *transfer, bool success, long responseCode)
+{
+  CSingleLock lock(m_section);
+  if (transfer->easy)
+  {
+    g_curlInterface.multi_remove_handle(m_multi, transfer->easy);
+    m_active.erase(transfer->easy);
+    if (--m_hostTransfers[transfer->host] == 0)
+      m_hostTransfers.erase(transfer->host);
+    if (m_idleHandles.size() < MAX_TRANSFERS)
+      m_idleHandles.push_back(transfer->easy);
+    else
+      g_curlInterface.easy_cleanup(transfer->easy);
+  }
+  m_transfers.erase(transfer->url);
+
+  for (unsigned int i = 0; i < transfer->targets.size(); i++)
+  {
+    CHTTPFetchRequest *request = transfer->targets[i].first;
+    CBatch *batch = transfer->targets[i].second;
+    request->m_success = success;
+    request->m_responseCode = responseCode;
+    if (success)
+    {
+      if (i + 1 < transfer->targets.size())
+        request->m_data = transfer->data;
+      else
+        request->m_data.swap(transfer->data);
+    }
+    if (AtomicDecrement(&batch->pending) == 0)
+      batch->done.Set();
+  }
+  delete transfer;
+}
+
+void CHTTPFetchService::FailAll()
+{
+  CSingleLock lock(m_section);
+  while (!m_active.empty())
+    FinishTransfer(m_active.begin()->second, false, 0);
+  while (!m_queue.empty())
+  {
+    CTransfer *transfer = m_queue.front();
+    m_queue.pop_front();
+    FinishTransfer(transfer, false, 0);
+  }
+  for (vector<CURL_HANDLE *>::iterator i = m_idleHandles.begin(); i != m_idleHandles.end(); ++i)
+    g_curlInterface.easy_cleanup(*i);
+  m_idleHandles.clear();
+}
+
+void CHTTPFetchService::Process()
+{
+  bool loaded = g_curlInterface.Load();
+  if (loaded)
+    m_multi = g_curlInterface.multi_init();
+  if (!m_multi)
+    CLog::Log(LOGERROR, "CHTTPFetchService: unable to initialize curl");
+
+  while (m_multi && !m_bStop)
+  {
+    StartTransfers();
+    if (m_active.empty())
+    {
+      AbortableWait(m_wakeup, 1000);
+      continue;
+    }
+
+    int running = 0;
+    while (g_curlInterface.multi_perform(m_multi, &running) == CURLM_CALL_MULTI_PERFORM) {}
+
+    CURLMsg *msg;
+    int remaining;
+    while ((msg = g_curlInterface.multi_info_read(m_multi, &remaining)))
+    {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      map<CURL_HANDLE *, CTransfer *>::iterator it = m_active.find(msg->easy_handle);
+      if (it == m_active.end())
+        continue;
+
+      long responseCode = 0;
+      g_curlInterface.easy_getinfo(msg->easy_handle, CURLINFO_RESPONSE_CODE, &responseCode);
+      if (msg->data.result != CURLE_OK)
+        CLog::Log(LOGDEBUG, "CHTTPFetchService: failed to fetch %s (%d, %ld)", it->second->url.c_str(), msg->data.result, responseCode);
+      FinishTransfer(it->second, msg->data.result == CURLE_OK, responseCode);
+    }
+
+    if (!running)
+      continue;
+
+    // wait for activity on any of the transfers, but not so long that new requests are held up
+    long timeout = 0;
+    g_curlInterface.multi_timeout(m_multi, &timeout);
+    if (timeout < 0 || timeout > 50)
+      timeout = 50;
+
+    fd_set fdread, fdwrite, fdexcep;
+    int maxfd = -1;
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+    g_curlInterface.multi_fdset(m_multi, &fdread, &fdwrite, &fdexcep, &maxfd);
+    if (maxfd >= 0)
+    {
+      struct timeval tv;
+      tv.tv_sec = 0;
+      tv.tv_usec = timeout * 1000;
+      select(maxfd + 1, &fdread, &fdwrite, &fdexcep, &tv);
+    }
+    else if (timeout > 0)
+      AbortableWait(m_wakeup, timeout);
+  }
+
+  { // stop taking requests before failing those we have, so none are left waiting on us
+    CSingleLock lock(m_section);
+    m_started = false;
+    FailAll();
+  }
+
+  if (m_multi)
+    g_curlInterface.multi_cleanup(m_multi);
+  m_multi = NULL;
+  if (loaded)
+    g_curlInterface.Unload();
+}
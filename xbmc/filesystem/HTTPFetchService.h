@@ -0,0 +1,140 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <map>
+#include <vector>
+#include <deque>
+#include <string>
+#include "utils/StdString.h"
+#include "threads/Thread.h"
+#include "threads/Event.h"
+#include "threads/CriticalSection.h"
+
+namespace XCURL
+{
+  typedef void CURL_HANDLE;
+  typedef void CURLM;
+}
+
+namespace XFILE
+{
+  /*! \brief A single HTTP GET handled by CHTTPFetchService.
+   */
+  class CHTTPFetchRequest
+  {
+  public:
+    CHTTPFetchRequest(const CStdString &url) : m_url(url), m_success(false), m_responseCode(0) {};
+
+    CStdString  m_url;
+    std::string m_data;
+    bool        m_success;
+    long        m_responseCode;
+  };
+
+  /*! \brief Fetches plain HTTP(S) URLs concurrently on a single curl multi handle.
+
+   Requests are run on one thread with at most MAX_TRANSFERS in flight, and at most
+   MAX_HOST_TRANSFERS of those to the same host. Connections are kept alive and reused
+   by later requests to the same host. Requests for a URL that is already queued or being
+   transferred are attached to that transfer instead of fetching the URL again.
+
+   Only plain URLs are handled - anything carrying protocol options ("url|option=value"),
+   credentials or POST data should go through CFileCurl.
+   */
+  class CHTTPFetchService : public CThread
+  {
+  public:
+    static CHTTPFetchService &Get();
+
+    /*! \brief Whether the given URL can be fetched by the service.
+     */
+    static bool CanFetch(const CStdString &url);
+
+    static const unsigned int DEFAULT_TIMEOUT = 60000; ///< ms a Fetch() waits for its batch by default
+
+    /*! \brief Fetch a batch of requests, returning once all of them have completed.
+     Requests that haven't completed within the timeout are abandoned and fail.
+     \param timeoutMs how long to wait for the batch in milliseconds.
+     */
+    void Fetch(std::vector<CHTTPFetchRequest> &requests, unsigned int timeoutMs = DEFAULT_TIMEOUT);
+
+    /*! \brief Fetch a single URL.
+     \return true if it was fetched successfully.
+     */
+    bool Fetch(const CStdString &url, std::string &data, unsigned int timeoutMs = DEFAULT_TIMEOUT);
+
+    /*! \brief Stop the service, failing anything still outstanding. It's restarted by the next Fetch().
+     Requests made while it's stopping fail immediately.
+     */
+    void Stop();
+
+  protected:
+    virtual void Process();
+
+  private:
+    CHTTPFetchService();
+    virtual ~CHTTPFetchService();
+    CHTTPFetchService(const CHTTPFetchService&);
+    CHTTPFetchService const& operator=(CHTTPFetchService const&);
+
+    static const unsigned int MAX_TRANSFERS = 16;
+    static const unsigned int MAX_HOST_TRANSFERS = 4;
+
+    struct CBatch
+    {
+      CEvent        done;
+      volatile long pending;
+    };
+
+    struct CTransfer
+    {
+      CStdString  url;
+      CStdString  host;
+      std::string data;
+      CStdString  proxy;          ///< kept for the handle, as CFileCurl does
+      CStdString  proxyUserPass;
+      XCURL::CURL_HANDLE *easy;
+      std::vector< std::pair<CHTTPFetchRequest *, CBatch *> > targets;
+    };
+
+    static size_t WriteCallback(char *buffer, size_t size, size_t nitems, void *userp);
+    bool Submit(std::vector<CHTTPFetchRequest> &requests, CBatch &batch);
+    void Cancel(CBatch &batch);
+    void StartTransfers();
+    bool StartTransfer(CTransfer *transfer);
+    void FinishTransfer(CTransfer *transfer, bool success, long responseCode);
+    void FailAll();
+
+    CCriticalSection m_section;
+    CEvent           m_wakeup;
+    bool             m_started;   ///< the worker is running and taking requests
+    bool             m_stopping;  ///< Stop() is waiting for the worker to exit
+    CStdString       m_cookieFile;  ///< shared with CFileCurl
+    XCURL::CURLM    *m_multi;
+
+    std::map<CStdString, CTransfer *>            m_transfers;  ///< queued and active transfers by URL
+    std::deque<CTransfer *>                      m_queue;
+    std::map<XCURL::CURL_HANDLE *, CTransfer *>  m_active;
+    std::map<CStdString, unsigned int>           m_hostTransfers;
+    std::vector<XCURL::CURL_HANDLE *>            m_idleHandles;
+  };
+}
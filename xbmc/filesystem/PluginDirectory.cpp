@@ -27,6 +27,7 @@
 #include "addons/AddonManager.h"
 #include "addons/AddonInstaller.h"
 #include "addons/IAddon.h"
+#include "addons/PluginSource.h"
 #ifdef HAS_PYTHON
 #include "interfaces/python/XBPython.h"
 #endif
@@ -48,6 +49,7 @@ vector<CPluginDirectory *> CPluginDirectory::globalHandles;
 CCriticalSection CPluginDirectory::m_handleLock;
 
 CPluginDirectory::CPluginDirectory()
+  : m_fetchComplete(true)
 {
   m_listItems = new CFileItemList;
   m_fileResult = new CFileItem;
@@ -118,10 +120,16 @@ bool CPluginDirectory::StartScript(const CStdString& strPath, bool retrievingDir
   bool success = false;
 #ifdef HAS_PYTHON
   CStdString file = m_addon->LibPath();
-  if (g_pythonParser.evalFile(file, argv,m_addon) >= 0)
+  boost::shared_ptr<CPluginSource> plugin = boost::dynamic_pointer_cast<CPluginSource>(m_addon);
+  bool reuseInterpreter = plugin && plugin->ReuseInterpreter();
+  unsigned int startTime = XbmcThreads::SystemClockMillis();
+  int scriptId = g_pythonParser.evalFile(file, argv, m_addon, reuseInterpreter);
+  if (scriptId >= 0)
   { // wait for our script to finish
     CStdString scriptName = m_addon->Name();
-    success = WaitOnScriptResult(file, scriptName, retrievingDir);
+    success = WaitOnScriptResult(scriptId, scriptName, retrievingDir);
+    CLog::Log(LOGDEBUG, "%s - plugin %s took %u ms%s", __FUNCTION__, scriptName.c_str(),
+              XbmcThreads::SystemClockMillis() - startTime, reuseInterpreter ? " (reusing interpreters)" : "");
   }
   else
 #endif
@@ -444,21 +452,35 @@ bool CPluginDirectory::RunScriptWithParams(const CStdString& strPath)
   return false;
 }
 
-bool CPluginDirectory::WaitOnScriptResult(const CStdString &scriptPath, const CStdString &scriptName, bool retrievingDir)
+bool CPluginDirectory::WaitOnScriptResult(int scriptId, const CStdString &scriptName, bool retrievingDir)
 {
   const unsigned int timeBeforeProgressBar = 1500;
   const unsigned int timeToKillScript = 1000;
+  const unsigned int progressInterval = 20;
 
   unsigned int startTime = XbmcThreads::SystemClockMillis();
   CGUIDialogProgress *progressBar = NULL;
 
+  // wake as soon as the plugin either returns or exits, and otherwise only to keep the progress dialog going
+  boost::shared_ptr<CEvent> scriptDone;
+#ifdef HAS_PYTHON
+  scriptDone = g_pythonParser.getDoneEvent(scriptId);
+#endif
+  CEvent neverDone;
+  XbmcThreads::CEventGroup events(&m_fetchComplete, scriptDone ? scriptDone.get() : &neverDone, NULL);
+
   CLog::Log(LOGDEBUG, "%s - waiting on the %s plugin...", __FUNCTION__, scriptName.c_str());
   while (true)
   {
     {
       CSingleExit ex(g_graphicsContext);
+      unsigned int elapsed = XbmcThreads::SystemClockMillis() - startTime;
+      unsigned int timeout = progressInterval;
+      if (!progressBar && elapsed < timeBeforeProgressBar)
+        timeout = timeBeforeProgressBar - elapsed;
+      events.wait(timeout);
       // check if the python script is finished
-      if (m_fetchComplete.WaitMSec(20))
+      if (m_fetchComplete.WaitMSec(0))
       { // python has returned
         CLog::Log(LOGDEBUG, "%s- plugin returned %s", __FUNCTION__, m_success ? "successfully" : "failure");
         break;
@@ -466,7 +488,7 @@ bool CPluginDirectory::WaitOnScriptResult(const CStdString &scriptPath, const CS
     }
     // check our script is still running
 #ifdef HAS_PYTHON
-    if (!g_pythonParser.isRunning(g_pythonParser.getScriptId(scriptPath.c_str())))
+    if (!g_pythonParser.isRunning(scriptId))
 #endif
     { // check whether we exited normally
       if (!m_fetchComplete.WaitMSec(0))
@@ -526,11 +548,10 @@ bool CPluginDirectory::WaitOnScriptResult(const CStdString &scriptPath, const CS
         if (m_cancelled && XbmcThreads::SystemClockMillis() - startTime > timeToKillScript)
         { // cancel our script
 #ifdef HAS_PYTHON
-          int id = g_pythonParser.getScriptId(scriptPath.c_str());
-          if (id != -1 && g_pythonParser.isRunning(id))
+          if (g_pythonParser.isRunning(scriptId))
           {
             CLog::Log(LOGDEBUG, "%s- cancelling plugin %s", __FUNCTION__, scriptName.c_str());
-            g_pythonParser.stopScript(id);
+            g_pythonParser.stopScript(scriptId);
             break;
           }
 #endif
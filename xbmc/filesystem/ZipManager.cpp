@@ -27,7 +27,9 @@
 #include "utils/log.h"
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
+#include "utils/Crc32.h"
 #include "SpecialProtocol.h"
+#include "Directory.h"
 
 
 #ifndef min
@@ -39,6 +41,16 @@ using namespace std;
 
 CZipManager g_ZipManager;
 
+// the index is this header, the path of the archive, the entry count and the raw entries
+struct SZipIndexHeader
+{
+  uint32_t version;
+  uint32_t entrySize;
+  int64_t  size;
+  int64_t  mtime;
+  uint32_t pathLength;
+};
+
 CZipManager::CZipManager()
 {
 }
@@ -78,6 +90,13 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
       mZipDate.erase(it2);
   }
 
+  if (LoadIndex(strFile, m_StatData.st_size, m_StatData.st_mtime, items))
+  {
+    mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
+    mZipMap.insert(make_pair(strFile,items));
+    return true;
+  }
+
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -165,15 +184,27 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
   mFile.Read(&cdirOffset,4);
   cdirOffset = Endian_SwapLE32(cdirOffset);
 
-  // Go to the start of central directory
+  // Read the whole central directory at once
+  if (cdirOffset + (int64_t)cdirSize > fileSize)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+    mFile.Close();
+    return false;
+  }
+  std::vector<char> cdir(cdirSize);
   mFile.Seek(cdirOffset,SEEK_SET);
+  if (cdirSize && mFile.Read(&cdir[0],cdirSize) != cdirSize)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: unable to read central directory of %s!",strFile.c_str());
+    mFile.Close();
+    return false;
+  }
 
-  char temp[CHDR_SIZE];
-  while (mFile.GetPosition() < cdirOffset + cdirSize)
+  unsigned int pos = 0;
+  while (pos + CHDR_SIZE <= cdirSize)
   {
-    mFile.Read(temp,CHDR_SIZE);
-    readCHeader(temp, ze);
-    if (ze.header != ZIP_CENTRAL_HEADER)
+    readCHeader(&cdir[pos], ze);
+    if (ze.header != ZIP_CENTRAL_HEADER || pos + CHDR_SIZE + ze.flength > cdirSize)
     {
       CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
       mFile.Close();
@@ -181,16 +212,11 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
     }
 
     // Get the filename just after the central file header
-    CStdString strName;
-    mFile.Read(strName.GetBuffer(ze.flength), ze.flength);
-    strName.ReleaseBuffer();
+    CStdString strName(&cdir[pos + CHDR_SIZE], ze.flength);
     g_charsetConverter.unknownToUTF8(strName);
     ZeroMemory(ze.name, 255);
     strncpy(ze.name, strName.c_str(), strName.size()>254 ? 254 : strName.size());
 
-    // Save the current position
-    int64_t savePos = mFile.GetPosition();
-
     // Go to the local file header to get the extra field length
     // !! local header extra field length != central file header extra field length !!
     mFile.Seek(ze.lhdrOffset+28,SEEK_SET);
@@ -201,16 +227,100 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
     ze.offset = ze.lhdrOffset + LHDR_SIZE + ze.flength + ze.elength;
 
     // Jump after central file header extra field and file comment
-    mFile.Seek(savePos + ze.eclength + ze.clength,SEEK_SET);
-	
+    pos += CHDR_SIZE + ze.flength + ze.eclength + ze.clength;
+
     items.push_back(ze);
   }
 
   mZipMap.insert(make_pair(strFile,items));
   mFile.Close();
+
+  SaveIndex(strFile, m_StatData.st_size, m_StatData.st_mtime, items);
   return true;
 }
 
+CStdString CZipManager::GetIndexPath(const CStdString& strFile)
+{
+  Crc32 crc;
+  crc.Compute(strFile);
+  CStdString strIndex;
+  strIndex.Format("%s%08x.idx", ZIP_INDEX_PATH, (unsigned int)crc);
+  return strIndex;
+}
+
+bool CZipManager::LoadIndex(const CStdString& strFile, int64_t size, int64_t mtime, vector<SZipEntry>& items)
+{
+  CFile file;
+  if (!file.Open(GetIndexPath(strFile)))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length <= 0 || length > 64*1024*1024)
+    return false;
+  std::vector<char> data((size_t)length);
+  if (file.Read(&data[0], length) != length)
+    return false;
+  file.Close();
+
+  SZipIndexHeader header;
+  if (data.size() < sizeof(header))
+    return false;
+  memcpy(&header, &data[0], sizeof(header));
+  if (header.version != ZIP_INDEX_VERSION || header.entrySize != sizeof(SZipEntry) ||
+      header.size != size || header.mtime != mtime)
+    return false;
+
+  size_t pos = sizeof(header);
+  uint32_t count;
+  if (data.size() < pos + header.pathLength + sizeof(count) ||
+      strFile != CStdString(&data[pos], header.pathLength))
+    return false;
+  pos += header.pathLength;
+  memcpy(&count, &data[pos], sizeof(count));
+  pos += sizeof(count);
+  if (data.size() != pos + (size_t)count * sizeof(SZipEntry))
+    return false;
+
+  items.reserve(items.size() + count);
+  for (uint32_t i = 0; i < count; i++, pos += sizeof(SZipEntry))
+  {
+    SZipEntry ze;
+    memcpy(&ze, &data[pos], sizeof(SZipEntry));
+    ze.name[254] = '\0';
+    items.push_back(ze);
+  }
+  CLog::Log(LOGDEBUG,"ZipManager: loaded %u entries of %s from the index", count, strFile.c_str());
+  return true;
+}
+
+void CZipManager::SaveIndex(const CStdString& strFile, int64_t size, int64_t mtime, const vector<SZipEntry>& items)
+{
+  if (!CDirectory::Exists(ZIP_INDEX_PATH))
+    CDirectory::Create(ZIP_INDEX_PATH);
+
+  SZipIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  header.version = ZIP_INDEX_VERSION;
+  header.entrySize = sizeof(SZipEntry);
+  header.size = size;
+  header.mtime = mtime;
+  header.pathLength = strFile.size();
+  uint32_t count = items.size();
+
+  std::string data;
+  data.reserve(sizeof(header) + strFile.size() + sizeof(count) + items.size() * sizeof(SZipEntry));
+  data.append((const char *)&header, sizeof(header));
+  data.append(strFile.c_str(), strFile.size());
+  data.append((const char *)&count, sizeof(count));
+  for (vector<SZipEntry>::const_iterator it = items.begin(); it != items.end(); ++it)
+    data.append((const char *)&(*it), sizeof(SZipEntry));
+
+  CFile file;
+  if (!file.OpenForWrite(GetIndexPath(strFile), true) ||
+      file.Write(data.c_str(), data.size()) != (int)data.size())
+    CLog::Log(LOGDEBUG,"ZipManager: unable to write index for %s", strFile.c_str());
+}
+
 bool CZipManager::GetZipEntry(const CStdString& strPath, SZipEntry& item)
 {
   CURL url(strPath);
@@ -218,18 +328,20 @@ bool CZipManager::GetZipEntry(const CStdString& strPath, SZipEntry& item)
   CStdString strFile = url.GetHostName();
 
   map<CStdString,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  vector<SZipEntry> items;
   if (it == mZipMap.end()) // we need to list the zip
   {
-    GetZipList(strPath,items);
-  }
-  else
-  {
-    items = it->second;
+    vector<SZipEntry> items;
+    if (!GetZipList(strPath,items))
+      return false;
+    it = mZipMap.find(strFile);
+    if (it == mZipMap.end())
+      return false;
   }
 
+  // search the cached list in place rather than copying it
+  const vector<SZipEntry> &items = it->second;
   CStdString strFileName = url.GetFileName();
-  for (vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
+  for (vector<SZipEntry>::const_iterator it2=items.begin();it2 != items.end();++it2)
   {
     if (CStdString(it2->name) == strFileName)
     {
@@ -30,6 +30,10 @@
 #define CHDR_SIZE 46
 #define ECDREC_SIZE 22
 
+// persistent copies of the parsed central directories
+#define ZIP_INDEX_PATH "special://temp/zipindex/"
+#define ZIP_INDEX_VERSION 1
+
 #include  "utils/StdString.h"
 
 #include <memory.h>
@@ -109,6 +113,13 @@ public:
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
+  /*! \brief Load the entries of a zip from its on-disk index.
+   The index is only used if the archive still has the size and modification time it had when indexed.
+   */
+  bool LoadIndex(const CStdString& strFile, int64_t size, int64_t mtime, std::vector<SZipEntry>& items);
+  void SaveIndex(const CStdString& strFile, int64_t size, int64_t mtime, const std::vector<SZipEntry>& items);
+  static CStdString GetIndexPath(const CStdString& strFile);
+
   std::map<CStdString,std::vector<SZipEntry> > mZipMap;
   std::map<CStdString,int64_t> mZipDate;
 };
@@ -28,6 +28,7 @@
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "GUIStaticItem.h"
+#include "GUIProcessPool.h"
 #include "Key.h"
 #include "utils/MathUtils.h"
 #include "tinyXML/tinyxml.h"
@@ -74,6 +75,26 @@ void CGUIBaseContainer::DoProcess(unsigned int currentTime, CDirtyRegionList &di
   m_wasReset = false;
 }
 
+class CGUIBaseContainer::CProcessItemTask : public IGUIProcessTask
+{
+public:
+  CProcessItemTask(CGUIBaseContainer *container, const CGUIListItemPtr &item, float posX, float posY, unsigned int currentTime)
+  : m_container(container), m_item(item), m_posX(posX), m_posY(posY), m_currentTime(currentTime) {};
+
+  virtual void Process()
+  {
+    m_container->ProcessItem(m_posX, m_posY, m_item.get(), false, m_currentTime, m_dirtyRegions);
+  }
+
+  CDirtyRegionList m_dirtyRegions;
+private:
+  CGUIBaseContainer *m_container;
+  CGUIListItemPtr m_item;
+  float m_posX;
+  float m_posY;
+  unsigned int m_currentTime;
+};
+
 void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   ValidateOffset();
@@ -106,6 +127,11 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   pos += drawOffset;
   end += cacheAfter * m_layout->Size(m_orientation);
 
+  // during the parallel process pass the unfocused items are processed as separate tasks.
+  // the focused item stays with us, as it updates our focus state.
+  bool parallel = CGUIProcessPool::Get().InTask();
+  std::vector<IGUIProcessTask *> tasks;
+
   int current = offset - cacheBefore;
   while (pos < end && m_items.size())
   {
@@ -116,17 +142,30 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
     if (itemNo >= 0)
     {
       CGUIListItemPtr item = m_items[itemNo];
+      float posX = (m_orientation == VERTICAL) ? origin.x : pos;
+      float posY = (m_orientation == VERTICAL) ? pos : origin.y;
       // render our item
-      if (m_orientation == VERTICAL)
-        ProcessItem(origin.x, pos, item.get(), focused, currentTime, dirtyregions);
+      if (parallel && !focused)
+        tasks.push_back(new CProcessItemTask(this, item, posX, posY, currentTime));
       else
-        ProcessItem(pos, origin.y, item.get(), focused, currentTime, dirtyregions);
+        ProcessItem(posX, posY, item.get(), focused, currentTime, dirtyregions);
     }
     // increment our position
     pos += focused ? m_focusedLayout->Size(m_orientation) : m_layout->Size(m_orientation);
     current++;
   }
 
+  if (tasks.size())
+  {
+    CGUIProcessPool::Get().Run(tasks);
+    for (std::vector<IGUIProcessTask *>::iterator i = tasks.begin(); i != tasks.end(); ++i)
+    {
+      CProcessItemTask *task = (CProcessItemTask *)*i;
+      dirtyregions.insert(dirtyregions.end(), task->m_dirtyRegions.begin(), task->m_dirtyRegions.end());
+      delete task;
+    }
+  }
+
   UpdatePageControl(offset);
 
   CGUIControl::Process(currentTime, dirtyregions);
@@ -593,6 +632,12 @@ int CGUIBaseContainer::GetSelectedItem() const
   return CorrectOffset(GetOffset(), GetCursor());
 }
 
+void CGUIBaseContainer::GetVisibleRange(int &first, int &count) const
+{
+  first = CorrectOffset(GetOffset(), 0);
+  count = m_itemsPerPage;
+}
+
 CGUIListItemPtr CGUIBaseContainer::GetListItem(int offset, unsigned int flag) const
 {
   if (!m_items.size())
@@ -68,6 +68,12 @@ public:
   virtual void SaveStates(std::vector<CControlState> &states);
   virtual int GetSelectedItem() const;
 
+  /*! \brief Get the items currently on screen
+   \param first index of the first item in view
+   \param count number of items that fit in view
+   */
+  virtual void GetVisibleRange(int &first, int &count) const;
+
   virtual void DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions);
   virtual void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions);
 
@@ -209,6 +215,8 @@ private:
   CStdString m_match;
 
   static const int letter_match_timeout = 1000;
+
+  class CProcessItemTask; ///< processes an unfocused item during the parallel process pass
 };
 
 
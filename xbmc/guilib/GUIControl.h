@@ -160,6 +160,10 @@ public:
   virtual void SetPosition(float posX, float posY);
   virtual void SetHitRect(const CRect &rect);
   virtual void SetCamera(const CPoint &camera);
+  /*! \brief Whether this control (or any of its children) sets a camera.
+   Controls with a camera are always processed on the render thread.
+   */
+  virtual bool HasCamera() const { return m_hasCamera; };
   bool SetColorDiffuse(const CGUIInfoColor &color);
   CPoint GetRenderPosition() const;
   virtual float GetXPosition() const;
@@ -435,6 +435,17 @@ bool CGUIControlGroup::HasVisibleID(int id) const
   return false;
 }
 
+bool CGUIControlGroup::HasCamera() const
+{
+  if (CGUIControl::HasCamera()) return true;
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->HasCamera())
+      return true;
+  }
+  return false;
+}
+
 const CGUIControl* CGUIControlGroup::GetControl(int iControl) const
 {
   CGUIControl *pPotential = NULL;
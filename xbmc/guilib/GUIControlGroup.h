@@ -65,6 +65,7 @@ public:
 
   virtual bool HasID(int id) const;
   virtual bool HasVisibleID(int id) const;
+  virtual bool HasCamera() const;
 
   int GetFocusedControlID() const;
   CGUIControl *GetFocusedControl() const;
@@ -117,7 +117,9 @@ void CGUIDialog::OnDeinitWindow(int nextWindowID)
 
 void CGUIDialog::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
-  UpdateVisibility();
+  // in a parallel process pass the window manager has done this before handing us to the pool
+  if (!g_graphicsContext.InProcessPass())
+    UpdateVisibility();
 
   // if we were running but now we're not, mark us dirty
   if (!m_active && m_wasRunning)
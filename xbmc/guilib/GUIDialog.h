@@ -59,10 +59,14 @@ public:
   void SetSound(bool OnOff) { m_enableSound = OnOff; };
   virtual bool IsSoundEnabled() const { return m_enableSound; };
 
+  /*! \brief Show or close the dialog as its visible condition says.
+   Called by DoProcess(), or by the window manager before a parallel process pass.
+   */
+  virtual void UpdateVisibility();
+
 protected:
   virtual void SetDefaults();
   virtual void OnWindowLoaded();
-  virtual void UpdateVisibility();
 
   virtual void DoModal_Internal(int iWindowID = WINDOW_INVALID, const CStdString &param = ""); // modal
   virtual void Show_Internal(); // modeless
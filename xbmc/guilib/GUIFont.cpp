@@ -21,6 +21,7 @@
 
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
+#include "GUITextLayout.h"
 #include "GraphicContext.h"
 
 #include "threads/SingleLock.h"
@@ -65,6 +66,8 @@ CGUIFont::~CGUIFont()
 {
   if (m_font)
     m_font->RemoveReference();
+  // any shared layouts using this font are now invalid
+  CGUITextLayout::ClearCache();
 }
 
 CStdString& CGUIFont::GetFontName()
@@ -284,6 +287,8 @@ void CGUIFont::SetFont(CGUIFontTTFBase *font)
 {
   if (m_font == font)
     return; // no need to update the font if we already have it
+  // our metrics are changing, so shared layouts using this font are now invalid
+  CGUITextLayout::ClearCache();
   if (m_font)
     m_font->RemoveReference();
   m_font = font;
@@ -48,7 +48,6 @@ using namespace std;
 
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -139,8 +138,6 @@ CFreeTypeLibrary g_freeTypeLibrary; // our freetype library
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
   m_nestedBeginCount = 0;
 
   m_bTextureLoaded = false;
@@ -149,7 +146,11 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 
   m_face = NULL;
   m_stroker = NULL;
+  memset(m_charhash, 0, sizeof(m_charhash));
   memset(m_charquick, 0, sizeof(m_charquick));
+  m_recyclePages = false;
+  m_useCount = 0;
+  m_glyphHits = m_glyphMisses = m_pageRecycles = 0;
   m_strFileName = strFileName;
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
@@ -190,26 +191,51 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
+  FreeCharacters();
   // set the posX and posY so that our texture will be created on first character write.
   m_posX = m_textureWidth;
   m_posY = -(int)m_cellHeight;
   m_textureHeight = 0;
 }
 
+void CGUIFontTTFBase::FreeCharacters()
+{
+  for (vector<CharacterPage>::iterator page = m_pages.begin(); page != m_pages.end(); ++page)
+  {
+    for (vector<Character *>::iterator ch = page->chars.begin(); ch != page->chars.end(); ++ch)
+      delete *ch;
+  }
+  m_pages.clear();
+  memset(m_charhash, 0, sizeof(m_charhash));
+  memset(m_charquick, 0, sizeof(m_charquick));
+  m_numChars = 0;
+  m_recyclePages = false;
+}
+
+float CGUIFontTTFBase::GetGlyphHitRate() const
+{
+  unsigned int lookups = m_glyphHits + m_glyphMisses;
+  return lookups ? (float)m_glyphHits / lookups : 0.0f;
+}
+
+float CGUIFontTTFBase::GetCacheOccupancy() const
+{
+  if (!m_textureHeight || !m_cellHeight)
+    return 0.0f;
+  unsigned int usedPages = 0;
+  for (vector<CharacterPage>::const_iterator page = m_pages.begin(); page != m_pages.end(); ++page)
+  {
+    if (!page->chars.empty())
+      usedPages++;
+  }
+  return std::min(1.0f, (float)(usedPages * m_cellHeight) / m_textureHeight);
+}
+
 void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
-  m_numChars = 0;
+  FreeCharacters();
   m_posX = 0;
   m_posY = 0;
   m_nestedBeginCount = 0;
@@ -278,11 +304,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
-
-  m_maxChars = 0;
-  m_numChars = 0;
+  FreeCharacters();
 
   m_strFilename = strFilename;
 
@@ -453,83 +475,134 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
-  // quick access to ascii chars
-  if (letter < 255)
-  {
-    character_t ch = (style << 8) | letter;
-    if (m_charquick[ch])
-      return m_charquick[ch];
-  }
-
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  int mid;
-  while (low <= high)
+  // quick access to ascii chars, everything else goes via the hash table
+  Character *c = NULL;
+  if (letter < 255)
+    c = m_charquick[(style << 8) | letter];
+  if (!c)
   {
-    mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
-  }
-  // if we get to here, then low is where we should insert the new character
-
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
+    for (c = m_charhash[HashCharacter(ch)]; c; c = c->next)
     {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
+      if (c->letterAndStyle == ch)
+        break;
     }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
-
   }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+  if (c)
+  {
+    m_glyphHits++;
+    m_pages[c->page].lastUsed = ++m_useCount;
+    return c;
   }
+  m_glyphMisses++;
+
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
+  c = new Character;
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  if (!CacheCharacter(letter, style, c))
   { // unable to cache character - try clearing them all out and starting over
     CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(letter, style, c))
     {
       CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
       if (nestedBeginCount) Begin();
       m_nestedBeginCount = nestedBeginCount;
+      delete c;
       return NULL;
     }
   }
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
+  // add to our lookup tables
+  unsigned int hash = HashCharacter(ch);
+  c->next = m_charhash[hash];
+  m_charhash[hash] = c;
+  if (letter < 255)
+    m_charquick[(style << 8) | letter] = c;
+  m_pages[c->page].chars.push_back(c);
+  m_pages[c->page].lastUsed = ++m_useCount;
+
+  return c;
+}
+
+bool CGUIFontTTFBase::NextCharacterPage()
+{
+  m_posX = 0;
+  if (!m_recyclePages)
   {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
+    m_posY += m_cellHeight;
+    if (m_posY + m_cellHeight < m_textureHeight)
+      return true;
+
+    // create the new larger texture
+    unsigned int newHeight = m_posY + m_cellHeight;
+    // check for max height
+    if (newHeight > g_Windowing.GetMaxTextureSize())
+      CLog::Log(LOGDEBUG, "GUIFontTTF::NextCharacterPage: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
+    else
     {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
+      CBaseTexture* newTexture = ReallocTexture(newHeight);
+      if (newTexture)
+      {
+        m_texture = newTexture;
+        return true;
+      }
+      CLog::Log(LOGDEBUG, "GUIFontTTF::NextCharacterPage: Failed to allocate new texture of height %u", newHeight);
     }
+
+    // the texture can't grow any further, so from now on we reuse the least recently used pages
+    m_posY -= m_cellHeight;
+    if (m_pages.empty())
+      return false;
+    m_recyclePages = true;
+  }
+  return RecycleCharacterPage();
+}
+
+bool CGUIFontTTFBase::RecycleCharacterPage()
+{
+  if (m_pages.empty() || !m_texture)
+    return false;
+
+  unsigned int oldest = 0;
+  for (unsigned int i = 1; i < m_pages.size(); i++)
+  {
+    if (m_pages[i].lastUsed < m_pages[oldest].lastUsed)
+      oldest = i;
   }
 
-  return m_char + low;
+  // drop the page's characters from our lookup tables
+  CharacterPage &page = m_pages[oldest];
+  for (vector<Character *>::iterator it = page.chars.begin(); it != page.chars.end(); ++it)
+  {
+    Character *c = *it;
+    Character **link = &m_charhash[HashCharacter(c->letterAndStyle)];
+    while (*link != c)
+      link = &(*link)->next;
+    *link = c->next;
+    if ((c->letterAndStyle & 0xffff) < 255)
+      m_charquick[((c->letterAndStyle & 0xffff0000) >> 8) | (c->letterAndStyle & 0xff)] = NULL;
+    delete c;
+    m_numChars--;
+  }
+  page.chars.clear();
+  page.lastUsed = ++m_useCount;
+  m_pageRecycles++;
+
+  m_posX = 0;
+  m_posY = oldest * m_cellHeight;
+  ClearCharacterPage(m_posY, m_cellHeight);
+
+  CLog::Log(LOGDEBUG, "GUIFontTTF::RecycleCharacterPage: Reusing page %u of %s (%u recycled, hit rate %.1f%%, occupancy %.1f%%)",
+            oldest, m_strFileName.c_str(), m_pageRecycles, GetGlyphHitRate() * 100.0f, GetCacheOccupancy() * 100.0f);
+  return true;
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
@@ -569,34 +642,14 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
   // check we have enough room for the character
   if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-  { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-    m_posX = 0;
-    m_posY += m_cellHeight;
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    if(m_posY + m_cellHeight >= m_textureHeight)
+  { // no space - gotta drop to the next line (which means either growing the texture or recycling an old line)
+    if (!NextCharacterPage())
     {
-      // create the new larger texture
-      unsigned int newHeight = m_posY + m_cellHeight;
-      // check for max height
-      if (newHeight > g_Windowing.GetMaxTextureSize())
-      {
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
-        FT_Done_Glyph(glyph);
-        return false;
-      }
-
-      CBaseTexture* newTexture = NULL;
-      newTexture = ReallocTexture(newHeight);
-      if(newTexture == NULL)
-      {
-        FT_Done_Glyph(glyph);
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
-        return false;
-      }
-      m_texture = newTexture;
+      FT_Done_Glyph(glyph);
+      return false;
     }
+    if (bitGlyph->left < 0)
+      m_posX += -bitGlyph->left;
   }
 
   if(m_texture == NULL)
@@ -607,6 +660,10 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
   // set the character in our table
   ch->letterAndStyle = (style << 16) | letter;
+  ch->page = m_posY / m_cellHeight;
+  ch->next = NULL;
+  if (ch->page >= m_pages.size())
+    m_pages.resize(ch->page + 1);
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)max((short)m_cellBaseLine - bitGlyph->top, 0);
   ch->left = (float)m_posX + ch->offsetX;
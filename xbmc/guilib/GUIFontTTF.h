@@ -83,6 +83,16 @@ public:
 
   const CStdString& GetFileName() const { return m_strFileName; };
 
+  /*! \brief Fraction of character lookups served from the glyph cache
+   \return hit rate in the range 0..1
+   */
+  float GetGlyphHitRate() const;
+
+  /*! \brief Fraction of the glyph texture that is currently holding characters
+   \return occupancy in the range 0..1
+   */
+  float GetCacheOccupancy() const;
+
 protected:
   struct Character
   {
@@ -90,6 +100,14 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned int page;                 // texture line (page) that holds our glyph
+    Character *next;                   // next character in the same hash bucket
+  };
+  struct CharacterPage
+  {
+    CharacterPage() : lastUsed(0) {};
+    std::vector<Character *> chars;    // characters cached on this texture line
+    unsigned int lastUsed;             // use count at last access, for LRU recycling
   };
   void AddReference();
   void RemoveReference();
@@ -111,10 +129,15 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
+  void FreeCharacters();
+  bool NextCharacterPage();
+  bool RecycleCharacterPage();
+  static inline unsigned int HashCharacter(character_t ch) { return (ch * 2654435761U) >> (32 - CHAR_HASH_BITS); };
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch) = 0;
   virtual void DeleteHardwareTexture() = 0;
+  virtual void ClearCharacterPage(unsigned int posY, unsigned int height) = 0;
 
   // modifying glyphs
   void EmboldenGlyph(FT_GlyphSlot slot);
@@ -129,11 +152,19 @@ protected:
 
   color_t m_color;
 
-  Character *m_char;                 // our characters
+  enum { CHAR_HASH_BITS = 10 };
+  Character *m_charhash[1 << CHAR_HASH_BITS]; // our characters, hashed on letter and style
   Character *m_charquick[256*4];     // ascii chars (4 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
   int m_numChars;                    // the current number of cached characters
 
+  std::vector<CharacterPage> m_pages; // texture lines, recycled in LRU order once the texture is at its max size
+  bool m_recyclePages;               // true once the texture can't grow any further
+  unsigned int m_useCount;           // incremented on every character access
+
+  unsigned int m_glyphHits;          // statistics for the character cache
+  unsigned int m_glyphMisses;
+  unsigned int m_pageRecycles;
+
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
   unsigned int m_cellBaseLine;
@@ -24,6 +24,7 @@
 #include "GUIFontTTFGL.h"
 #include "GUIFontManager.h"
 #include "Texture.h"
+#include "GUITexture.h"
 #include "GraphicContext.h"
 #include "gui3d.h"
 #include "utils/log.h"
@@ -56,6 +57,10 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
+#ifdef HAS_GL
+    // text goes on top of any textures still waiting to be rendered
+    CGUITextureGL::FlushBatch();
+#endif
     if (!m_bTextureLoaded)
     {
       // Have OpenGL generate a texture object handle for us
@@ -228,6 +233,22 @@ bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character* ch)
   return TRUE;
 }
 
+void CGUIFontTTFGL::ClearCharacterPage(unsigned int posY, unsigned int height)
+{
+  if (posY + height > m_texture->GetHeight())
+    height = m_texture->GetHeight() - posY;
+  memset(m_texture->GetPixels() + posY * m_texture->GetPitch(), 0, height * m_texture->GetPitch());
+
+  // the hardware texture needs to be uploaded again
+  if (m_bTextureLoaded)
+  {
+    g_graphicsContext.BeginPaint();  //FIXME
+    DeleteHardwareTexture();
+    g_graphicsContext.EndPaint();
+    m_bTextureLoaded = false;
+  }
+}
+
 
 void CGUIFontTTFGL::DeleteHardwareTexture()
 {
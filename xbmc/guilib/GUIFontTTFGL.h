@@ -49,6 +49,7 @@ protected:
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight);
   virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, Character *ch);
   virtual void DeleteHardwareTexture();
+  virtual void ClearCharacterPage(unsigned int posY, unsigned int height);
 
 };
 
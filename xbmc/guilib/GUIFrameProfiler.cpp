@@ -0,0 +1,252 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GUIFrameProfiler.h"
+#include "threads/SingleLock.h"
+#include "filesystem/File.h"
+#include "utils/TimeUtils.h"
+#include "utils/log.h"
+
+bool CGUIFrameProfiler::m_bIsRunning = false;
+
+CGUIFrameProfilerScope::CGUIFrameProfilerScope(const char *name)
+: m_name(name), m_start(0)
+{
+  if (CGUIFrameProfiler::IsRunning())
+    m_start = CurrentHostCounter();
+}
+
+CGUIFrameProfilerScope::~CGUIFrameProfilerScope()
+{
+  if (m_start && CGUIFrameProfiler::IsRunning())
+    CGUIFrameProfiler::Instance().AddEvent(m_name, m_start, CurrentHostCounter());
+}
+
+CGUIFrameProfiler::CGUIFrameProfiler(void)
+: m_iMaxFrameCount(0), m_iFrameCount(0), m_startTime(0), m_lastFrameEnd(0), m_frameTotal(0)
+{
+  m_msecScale = 1000.0 / CurrentHostFrequency();
+  memset(m_histogram, 0, sizeof(m_histogram));
+  memset(m_frameBuckets, 0, sizeof(m_frameBuckets));
+}
+
+CGUIFrameProfiler::~CGUIFrameProfiler(void)
+{
+  m_bIsRunning = false;
+  for (std::vector<ThreadBuffer *>::iterator i = m_buffers.begin(); i != m_buffers.end(); ++i)
+    delete *i;
+}
+
+CGUIFrameProfiler &CGUIFrameProfiler::Instance(void)
+{
+  static CGUIFrameProfiler _instance;
+  return _instance;
+}
+
+void CGUIFrameProfiler::Start(int maxFrameCount)
+{
+  CSingleLock lock(m_section);
+  m_iMaxFrameCount = maxFrameCount;
+  m_iFrameCount = 0;
+  m_startTime = CurrentHostCounter();
+  // anything recorded before now belongs to an earlier capture
+  for (std::vector<ThreadBuffer *>::iterator i = m_buffers.begin(); i != m_buffers.end(); ++i)
+  {
+    CSingleLock bufferLock((*i)->section);
+    (*i)->consumed = (*i)->written;
+  }
+  m_bIsRunning = true;
+}
+
+void CGUIFrameProfiler::Stop(void)
+{
+  m_bIsRunning = false;
+}
+
+CGUIFrameProfiler::ThreadBuffer *CGUIFrameProfiler::GetThreadBuffer(ThreadIdentifier thread)
+{
+  CSingleLock lock(m_section);
+  ThreadBuffer *buffer = NULL;
+  for (std::vector<ThreadBuffer *>::iterator i = m_buffers.begin(); i != m_buffers.end() && !buffer; ++i)
+  {
+    CSingleLock bufferLock((*i)->section);
+    if (!(*i)->owner)
+    {
+      buffer = *i;
+      buffer->owner = thread;
+      buffer->idleFrames = 0;
+    }
+  }
+  if (!buffer)
+  {
+    buffer = new ThreadBuffer(m_buffers.size() + 1);
+    buffer->owner = thread;
+    m_buffers.push_back(buffer);
+  }
+  m_threadBuffer.set(buffer);
+  return buffer;
+}
+
+void CGUIFrameProfiler::AddEvent(const char *name, int64_t start, int64_t end)
+{
+  ThreadIdentifier thread = CThread::GetCurrentThreadId();
+  ThreadBuffer *buffer = m_threadBuffer.get();
+  while (true)
+  {
+    if (!buffer)
+      buffer = GetThreadBuffer(thread);
+    // only FrameEnd() and SaveResults() ever contend for this lock
+    CSingleLock lock(buffer->section);
+    if (buffer->owner == thread)
+    {
+      Event &event = buffer->events[buffer->written % BUFFER_SIZE];
+      event.name = name;
+      event.start = start;
+      event.end = end;
+      buffer->written++;
+      buffer->idleFrames = 0;
+      return;
+    }
+    // we were idle for long enough that it went to another thread
+    buffer = NULL;
+  }
+}
+
+void CGUIFrameProfiler::AddFrameTime(int64_t duration)
+{
+  unsigned int bucket = (unsigned int)(duration * m_msecScale * 4);
+  if (bucket >= HISTOGRAM_BUCKETS)
+    bucket = HISTOGRAM_BUCKETS - 1;
+
+  unsigned int slot = m_frameTotal % FRAME_HISTORY;
+  if (m_frameTotal >= FRAME_HISTORY)
+    m_histogram[m_frameBuckets[slot]]--;
+  m_frameBuckets[slot] = bucket;
+  m_histogram[bucket]++;
+  m_frameTotal++;
+}
+
+void CGUIFrameProfiler::FrameEnd(void)
+{
+  int64_t now = CurrentHostCounter();
+
+  CSingleLock lock(m_section);
+  if (m_lastFrameEnd)
+    AddFrameTime(now - m_lastFrameEnd);
+  int64_t frameStart = m_lastFrameEnd ? m_lastFrameEnd : now;
+  m_lastFrameEnd = now;
+
+  if (!m_bIsRunning)
+  {
+    m_lastFrameTimes.clear();
+    return;
+  }
+
+  AddEvent("Frame", frameStart, now);
+
+  // fold everything completed since the previous frame into per-scope totals
+  m_frameTimes.clear();
+  for (std::vector<ThreadBuffer *>::iterator i = m_buffers.begin(); i != m_buffers.end(); ++i)
+  {
+    ThreadBuffer *buffer = *i;
+    CSingleLock bufferLock(buffer->section);
+    if (buffer->written - buffer->consumed > BUFFER_SIZE)
+      buffer->consumed = buffer->written - BUFFER_SIZE;
+    for (; buffer->consumed != buffer->written; buffer->consumed++)
+    {
+      const Event &event = buffer->events[buffer->consumed % BUFFER_SIZE];
+      m_frameTimes[event.name] += event.end - event.start;
+    }
+    // free the buffers of threads that have gone (or gone quiet) for others
+    if (buffer->owner && ++buffer->idleFrames > RECYCLE_FRAMES)
+      buffer->owner = 0;
+  }
+
+  m_lastFrameTimes.clear();
+  for (std::map<const char *, int64_t, NameCompare>::const_iterator i = m_frameTimes.begin(); i != m_frameTimes.end(); ++i)
+    m_lastFrameTimes.push_back(std::make_pair(std::string(i->first), (float)(i->second * m_msecScale)));
+
+  if (m_iMaxFrameCount && ++m_iFrameCount >= m_iMaxFrameCount)
+  {
+    m_bIsRunning = false;
+    if (!SaveResults())
+      CLog::Log(LOGERROR, "CGUIFrameProfiler::FrameEnd: unable to write %s", m_strOutputFile.c_str());
+  }
+}
+
+bool CGUIFrameProfiler::GetFramePercentiles(float &p50, float &p95, float &p99) const
+{
+  CSingleLock lock(m_section);
+  unsigned int frames = m_frameTotal < FRAME_HISTORY ? m_frameTotal : FRAME_HISTORY;
+  if (!frames)
+    return false;
+
+  const unsigned int ranks[3] = { (frames * 50 + 99) / 100, (frames * 95 + 99) / 100, (frames * 99 + 99) / 100 };
+  float *values[3] = { &p50, &p95, &p99 };
+  unsigned int seen = 0, rank = 0;
+  for (unsigned int bucket = 0; bucket < HISTOGRAM_BUCKETS && rank < 3; bucket++)
+  {
+    seen += m_histogram[bucket];
+    while (rank < 3 && seen >= ranks[rank])
+      *values[rank++] = (bucket + 1) * 0.25f;
+  }
+  return true;
+}
+
+void CGUIFrameProfiler::GetLastFrameTimes(SubsystemTimes &times) const
+{
+  CSingleLock lock(m_section);
+  times = m_lastFrameTimes;
+}
+
+bool CGUIFrameProfiler::SaveResults(void)
+{
+  if (m_strOutputFile.IsEmpty())
+    return false;
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(m_strOutputFile, true))
+    return false;
+
+  CSingleLock lock(m_section);
+  CStdString data = "{\"traceEvents\":[\n";
+  bool first = true;
+  double usecScale = m_msecScale * 1000.0;
+  for (std::vector<ThreadBuffer *>::iterator i = m_buffers.begin(); i != m_buffers.end(); ++i)
+  {
+    ThreadBuffer *buffer = *i;
+    CSingleLock bufferLock(buffer->section);
+    unsigned int count = buffer->written < BUFFER_SIZE ? buffer->written : BUFFER_SIZE;
+    for (unsigned int index = buffer->written - count; index != buffer->written; index++)
+    {
+      const Event &event = buffer->events[index % BUFFER_SIZE];
+      if (event.start < m_startTime)
+        continue;
+      data.AppendFormat("%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.1f,\"dur\":%.1f,\"pid\":1,\"tid\":%u}",
+                        first ? "" : ",\n", event.name, (event.start - m_startTime) * usecScale,
+                        (event.end - event.start) * usecScale, buffer->id);
+      first = false;
+    }
+  }
+  data += "\n]}\n";
+
+  return file.Write(data.c_str(), data.size()) == (int)data.size();
+}
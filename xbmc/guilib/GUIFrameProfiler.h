@@ -0,0 +1,165 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#ifndef GUILIB_GUIFRAMEPROFILER_H__
+#define GUILIB_GUIFRAMEPROFILER_H__
+#pragma once
+
+#include <vector>
+#include <map>
+#include <string.h>
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+#include "threads/ThreadLocal.h"
+#include "threads/Thread.h"
+
+/*!
+ \ingroup guilib
+ \brief Frame time profiler complementing CGUIControlProfiler.
+
+ Subsystems mark the work they do with GUIPROFILER_SCOPE("name"), which records
+ a begin/end pair into a ring buffer owned by the calling thread. Once per frame
+ the application calls FrameEnd(), which folds the events completed since the
+ previous frame into per-subsystem totals and adds the frame time to a rolling
+ histogram from which the p50/p95/p99 frame times are read.
+
+ Buffers of threads that haven't recorded anything for RECYCLE_FRAMES frames are
+ handed to the next thread that needs one, so threads coming and going don't add a
+ buffer each. An idle thread that comes back simply takes another buffer.
+
+ Scopes only record while the profiler is running. A capture started with a
+ frame limit is written out as a Chrome trace (chrome://tracing) once the limit
+ is reached.
+ */
+class CGUIFrameProfiler
+{
+public:
+  static CGUIFrameProfiler &Instance(void);
+  static bool IsRunning(void) { return m_bIsRunning; };
+
+  /*! \brief Start recording scopes.
+   \param maxFrameCount number of frames to capture before the trace is saved, 0 to record until Stop() is called.
+   */
+  void Start(int maxFrameCount = 0);
+  void Stop(void);
+
+  /*! \brief Called by the application once a frame has been rendered.
+   */
+  void FrameEnd(void);
+
+  void AddEvent(const char *name, int64_t start, int64_t end);
+
+  int GetMaxFrameCount(void) const { return m_iMaxFrameCount; };
+  void SetOutputFile(const CStdString &strOutputFile) { m_strOutputFile = strOutputFile; };
+  const CStdString &GetOutputFile(void) const { return m_strOutputFile; };
+
+  /*! \brief Write the recorded events since Start() as a Chrome trace JSON file.
+
+   Only the last BUFFER_SIZE events of each thread are kept, so a thread that recorded more
+   than that since Start() has its older events left out of the trace.
+   */
+  bool SaveResults(void);
+
+  /*! \brief Frame time percentiles (in ms) over the last FRAME_HISTORY frames.
+   \return false if no frames have been recorded.
+   */
+  bool GetFramePercentiles(float &p50, float &p95, float &p99) const;
+
+  typedef std::vector< std::pair<std::string, float> > SubsystemTimes;
+  /*! \brief Time (in ms) spent in each named scope during the last frame.
+   */
+  void GetLastFrameTimes(SubsystemTimes &times) const;
+
+private:
+  CGUIFrameProfiler(void);
+  ~CGUIFrameProfiler(void);
+  CGUIFrameProfiler(const CGUIFrameProfiler &that);
+  CGUIFrameProfiler &operator=(const CGUIFrameProfiler &that);
+
+  static const unsigned int BUFFER_SIZE = 4096;      ///< events kept per thread
+  static const unsigned int FRAME_HISTORY = 1024;    ///< frames kept in the histogram
+  static const unsigned int HISTOGRAM_BUCKETS = 400; ///< 0.25ms buckets, last one catches everything above 100ms
+  static const unsigned int RECYCLE_FRAMES = 300;    ///< frames without events after which a thread's buffer may be reused
+
+  struct Event
+  {
+    const char *name;
+    int64_t start;
+    int64_t end;
+  };
+
+  struct ThreadBuffer
+  {
+    ThreadBuffer(unsigned int tid) : id(tid), owner(0), idleFrames(0), written(0), consumed(0) {};
+    CCriticalSection section;
+    unsigned int id;
+    ThreadIdentifier owner;   ///< thread recording into the buffer, 0 if it's free for another
+    unsigned int idleFrames;  ///< frames since the owner last recorded anything
+    unsigned int written;  ///< total number of events added, index into events modulo BUFFER_SIZE
+    unsigned int consumed; ///< events already folded into a frame by FrameEnd
+    Event events[BUFFER_SIZE];
+  };
+
+  struct NameCompare
+  {
+    bool operator()(const char *a, const char *b) const { return strcmp(a, b) < 0; }
+  };
+
+  ThreadBuffer *GetThreadBuffer(ThreadIdentifier thread);
+  void AddFrameTime(int64_t duration);
+
+  static bool m_bIsRunning;
+  XbmcThreads::ThreadLocal<ThreadBuffer> m_threadBuffer;
+  std::vector<ThreadBuffer *> m_buffers;
+  mutable CCriticalSection m_section;
+
+  CStdString m_strOutputFile;
+  int m_iMaxFrameCount;
+  int m_iFrameCount;
+  int64_t m_startTime;
+  int64_t m_lastFrameEnd;
+  double m_msecScale;
+
+  unsigned int m_histogram[HISTOGRAM_BUCKETS];
+  unsigned int m_frameBuckets[FRAME_HISTORY];
+  unsigned int m_frameTotal;
+
+  std::map<const char *, int64_t, NameCompare> m_frameTimes;
+  SubsystemTimes m_lastFrameTimes;
+};
+
+/*!
+ \ingroup guilib
+ \brief Times the enclosing scope into the CGUIFrameProfiler. The name must be a string literal.
+ */
+class CGUIFrameProfilerScope
+{
+public:
+  CGUIFrameProfilerScope(const char *name);
+  ~CGUIFrameProfilerScope();
+private:
+  const char *m_name;
+  int64_t m_start;
+};
+
+#define GUIPROFILER_SCOPE(x) CGUIFrameProfilerScope __frameProfilerScope(x)
+
+#endif
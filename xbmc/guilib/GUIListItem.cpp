@@ -23,8 +23,22 @@
 #include "GUIListItemLayout.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
+#include "utils/StringPool.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+
+namespace
+{
+  struct PropertyLess
+  {
+    bool operator()(const std::pair<CStdString, CVariant> &property, const CStdString &key) const
+    {
+      return property.first.CompareNoCase(key) < 0;
+    }
+  };
+}
+
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
 {
   m_layout = NULL;
@@ -122,7 +136,7 @@ void CGUIListItem::SetIconImage(const CStdString& strIcon)
 {
   if (m_strIcon == strIcon)
     return;
-  m_strIcon = strIcon;
+  m_strIcon = CStringPool::Intern(strIcon);
   SetInvalid();
 }
 
@@ -203,7 +217,7 @@ const CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strThumbnailImage = item.m_strThumbnailImage;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  m_properties = item.m_properties;
   SetInvalid();
   return *this;
 }
@@ -220,8 +234,8 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_strIcon;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << (int)m_mapProperties.size();
-    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+    ar << (int)m_properties.size();
+    for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); it++)
     {
       ar << it->first;
       ar << it->second;
@@ -235,6 +249,7 @@ void CGUIListItem::Archive(CArchive &ar)
     ar >> m_sortLabel;
     ar >> m_strThumbnailImage;
     ar >> m_strIcon;
+    m_strIcon = CStringPool::Intern(m_strIcon);
     ar >> m_bSelected;
 
     int overlayIcon;
@@ -243,6 +258,7 @@ void CGUIListItem::Archive(CArchive &ar)
 
     int mapSize;
     ar >> mapSize;
+    m_properties.reserve(mapSize);
     for (int i = 0; i < mapSize; i++)
     {
       CStdString key;
@@ -263,7 +279,7 @@ void CGUIListItem::Serialize(CVariant &value)
   value["strIcon"] = m_strIcon;
   value["selected"] = m_bSelected;
 
-  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); it++)
+  for (PropertyList::const_iterator it = m_properties.begin(); it != m_properties.end(); it++)
   {
     value["properties"][it->first] = it->second;
   }
@@ -321,15 +337,35 @@ void CGUIListItem::SetInvalid()
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+CGUIListItem::PropertyList::iterator CGUIListItem::FindProperty(const CStdString &strKey)
+{
+  PropertyList::iterator iter = std::lower_bound(m_properties.begin(), m_properties.end(), strKey, PropertyLess());
+  if (iter != m_properties.end() && iter->first.CompareNoCase(strKey) == 0)
+    return iter;
+  return m_properties.end();
+}
+
+CGUIListItem::PropertyList::const_iterator CGUIListItem::FindProperty(const CStdString &strKey) const
+{
+  PropertyList::const_iterator iter = std::lower_bound(m_properties.begin(), m_properties.end(), strKey, PropertyLess());
+  if (iter != m_properties.end() && iter->first.CompareNoCase(strKey) == 0)
+    return iter;
+  return m_properties.end();
+}
+
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
-  m_mapProperties[strKey] = value;
+  PropertyList::iterator iter = std::lower_bound(m_properties.begin(), m_properties.end(), strKey, PropertyLess());
+  if (iter != m_properties.end() && iter->first.CompareNoCase(strKey) == 0)
+    iter->second = value;
+  else
+    m_properties.insert(iter, Property(CStringPool::Intern(strKey), value));
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
+  PropertyList::const_iterator iter = FindProperty(strKey);
+  if (iter == m_properties.end())
     return CVariant(CVariant::VariantTypeNull);
 
   return iter->second;
@@ -337,23 +373,24 @@ CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 
 bool CGUIListItem::HasProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
+  return FindProperty(strKey) != m_properties.end();
+}
 
-  return true;
+bool CGUIListItem::HasProperties() const
+{
+  return !m_properties.empty();
 }
 
 void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
-    m_mapProperties.erase(iter);
+  PropertyList::iterator iter = FindProperty(strKey);
+  if (iter != m_properties.end())
+    m_properties.erase(iter);
 }
 
 void CGUIListItem::ClearProperties()
 {
-  m_mapProperties.clear();
+  m_properties.clear();
 }
 
 void CGUIListItem::IncrementProperty(const CStdString &strKey, int nVal)
@@ -372,6 +409,6 @@ void CGUIListItem::IncrementProperty(const CStdString &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
+  for (PropertyList::const_iterator i = item.m_properties.begin(); i != item.m_properties.end(); ++i)
     SetProperty(i->first, i->second);
 }
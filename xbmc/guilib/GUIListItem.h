@@ -32,6 +32,7 @@
 #include "utils/StdString.h"
 
 #include <map>
+#include <vector>
 #include <string>
 
 //  Forward
@@ -120,7 +121,7 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const CStdString &strKey) const;
-  bool       HasProperties() const { return m_mapProperties.size() > 0; };
+  bool       HasProperties() const;
   void       ClearProperty(const CStdString &strKey);
 
   CVariant   GetProperty(const CStdString &strKey) const;
@@ -135,16 +136,16 @@ protected:
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
-  {
-    bool operator()(const CStdString &s1, const CStdString &s2) const
-    {
-      return s1.CompareNoCase(s2) < 0;
-    }
-  };
+  /*! \brief Properties, sorted case-insensitively by name.
+   A sorted vector rather than a map, as most items have a handful of properties and large lists
+   have many items. Names are interned, as the same few are set on every item.
+   */
+  typedef std::pair<CStdString, CVariant> Property;
+  typedef std::vector<Property> PropertyList;
+  PropertyList m_properties;
 
-  typedef std::map<CStdString, CVariant, icompare> PropertyMap;
-  PropertyMap m_mapProperties;
+  PropertyList::iterator FindProperty(const CStdString &strKey);
+  PropertyList::const_iterator FindProperty(const CStdString &strKey) const;
 private:
   CStdStringW m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   CStdString m_strLabel;      // text of column1
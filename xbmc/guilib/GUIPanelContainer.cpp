@@ -449,6 +449,12 @@ int CGUIPanelContainer::CorrectOffset(int offset, int cursor) const
   return offset * m_itemsPerRow + cursor;
 }
 
+void CGUIPanelContainer::GetVisibleRange(int &first, int &count) const
+{
+  first = CorrectOffset(GetOffset(), 0);
+  count = m_itemsPerPage * m_itemsPerRow;
+}
+
 int CGUIPanelContainer::GetCursorFromPoint(const CPoint &point, CPoint *itemPoint) const
 {
   if (!m_layout)
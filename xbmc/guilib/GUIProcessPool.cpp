@@ -0,0 +1,203 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "GUIProcessPool.h"
+#include "GraphicContext.h"
+#include "threads/SingleLock.h"
+#include "threads/Atomics.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+#define MAX_PROCESS_WORKERS 7
+
+CGUIProcessPool::CWorker::CWorker(CGUIProcessPool &pool, unsigned int queue)
+: CThread("GUIProcessWorker"), m_pool(pool), m_queue(queue)
+{
+}
+
+void CGUIProcessPool::CWorker::Process()
+{
+  m_pool.m_worker.set(this);
+  while (!m_bStop)
+  {
+    if (m_pool.RunOne(m_queue))
+    { // pass the wakeup on if there's more to do
+      if (m_pool.m_queued > 0)
+        m_pool.m_workEvent.Set();
+      continue;
+    }
+    AbortableWait(m_pool.m_workEvent, 100);
+  }
+  m_pool.m_worker.set(NULL);
+}
+
+CGUIProcessPool::CGUIProcessPool()
+: m_queued(0)
+{
+}
+
+CGUIProcessPool::~CGUIProcessPool()
+{
+  Stop();
+  for (std::vector<CTaskQueue *>::iterator i = m_queues.begin(); i != m_queues.end(); ++i)
+    delete *i;
+}
+
+CGUIProcessPool &CGUIProcessPool::Get()
+{
+  static CGUIProcessPool pool;
+  return pool;
+}
+
+void CGUIProcessPool::StartWorkers()
+{
+  CSingleLock lock(m_section);
+  if (m_workers.size())
+    return;
+
+  // the queues are created once and never resized, as they're read without m_section
+  if (m_queues.empty())
+  {
+    int workers = std::min(std::max(g_cpuInfo.getCPUCount() - 1, 1), MAX_PROCESS_WORKERS);
+    for (int i = 0; i <= workers; i++)
+      m_queues.push_back(new CTaskQueue);
+    CLog::Log(LOGDEBUG, "CGUIProcessPool::StartWorkers - using %d workers", workers);
+  }
+
+  for (unsigned int queue = 1; queue < m_queues.size(); queue++)
+  {
+    CWorker *worker = new CWorker(*this, queue);
+    worker->Create();
+    m_workers.push_back(worker);
+  }
+}
+
+void CGUIProcessPool::Stop()
+{
+  CSingleLock lock(m_section);
+  for (std::vector<CWorker *>::iterator i = m_workers.begin(); i != m_workers.end(); ++i)
+  {
+    (*i)->StopThread(true);
+    delete *i;
+  }
+  m_workers.clear();
+}
+
+unsigned int CGUIProcessPool::CurrentQueue()
+{
+  CWorker *worker = m_worker.get();
+  return worker ? worker->GetQueue() : 0;
+}
+
+bool CGUIProcessPool::InTask()
+{
+  return m_running.get() != NULL;
+}
+
+void CGUIProcessPool::Run(const std::vector<IGUIProcessTask *> &tasks)
+{
+  if (tasks.empty())
+    return;
+
+  StartWorkers();
+
+  CGUITransformState state(g_graphicsContext.GetTransformState());
+  volatile long pending = tasks.size();
+  unsigned int queue = CurrentQueue();
+  {
+    CTaskQueue *own = m_queues[queue];
+    CSingleLock lock(own->section);
+    for (std::vector<IGUIProcessTask *>::const_iterator i = tasks.begin(); i != tasks.end(); ++i)
+    {
+      CTaskItem item = { *i, &state, &pending };
+      own->items.push_back(item);
+    }
+  }
+  AtomicAdd(&m_queued, tasks.size());
+  m_workEvent.Set();
+  { // wake threads waiting for their own tasks, so they help with ours
+    CSingleLock lock(m_doneSection);
+    m_doneCv.notifyAll();
+  }
+
+  // help out until our tasks are done - this may run tasks of other threads as well
+  while (pending > 0)
+  {
+    if (RunOne(queue))
+      continue;
+    // nothing left to steal, so wait for the last of ours to complete elsewhere
+    CSingleLock lock(m_doneSection);
+    if (pending > 0 && m_queued <= 0)
+      m_doneCv.wait(lock);
+  }
+}
+
+bool CGUIProcessPool::RunOne(unsigned int queue)
+{
+  CTaskItem item;
+  bool found = false;
+  { // newest first from our own queue, so nested tasks complete before their parents' siblings
+    CTaskQueue *own = m_queues[queue];
+    CSingleLock lock(own->section);
+    if (!own->items.empty())
+    {
+      item = own->items.back();
+      own->items.pop_back();
+      found = true;
+    }
+  }
+  for (unsigned int i = 1; !found && i < m_queues.size(); i++)
+  { // steal the oldest task from someone else
+    CTaskQueue *other = m_queues[(queue + i) % m_queues.size()];
+    CSingleLock lock(other->section);
+    if (!other->items.empty())
+    {
+      item = other->items.front();
+      other->items.pop_front();
+      found = true;
+    }
+  }
+  if (!found)
+    return false;
+
+  AtomicDecrement(&m_queued);
+  RunTask(item);
+  return true;
+}
+
+void CGUIProcessPool::RunTask(const CTaskItem &item)
+{
+  CGUITransformState state(*item.state);
+  CGUITransformState *previousState = g_graphicsContext.SetThreadState(&state);
+  CTaskItem *previousTask = m_running.get();
+  m_running.set(const_cast<CTaskItem *>(&item));
+
+  item.task->Process();
+
+  m_running.set(previousTask);
+  g_graphicsContext.SetThreadState(previousState);
+
+  CSingleLock lock(m_doneSection);
+  AtomicDecrement(item.pending);
+  m_doneCv.notifyAll();
+}
@@ -0,0 +1,123 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Condition.h"
+#include "threads/Thread.h"
+#include "threads/ThreadLocal.h"
+
+struct CGUITransformState;
+
+/*!
+ \ingroup guilib
+ \brief A unit of control processing that is independent of the others it is run with.
+ */
+class IGUIProcessTask
+{
+public:
+  virtual ~IGUIProcessTask() {};
+  virtual void Process() = 0;
+};
+
+/*!
+ \ingroup guilib
+ \brief Work stealing pool used by the parallel process pass.
+
+ Each thread queues the tasks it spawns on its own deque and works through them newest
+ first, while idle threads steal the oldest tasks of the others. A thread waiting in Run()
+ keeps processing tasks until its own have completed, so tasks may call Run() themselves
+ (eg a window fanning out the items of its list containers).
+
+ Every task runs with its own copy of the graphics context coordinate state as it was when
+ Run() was called, see CGraphicContext::SetThreadState().
+ */
+class CGUIProcessPool
+{
+public:
+  static CGUIProcessPool &Get();
+
+  /*! \brief Run the given tasks, returning once all of them have completed.
+   The calling thread must own the tasks and should not hold g_graphicsContext. The main
+   thread brackets its pass with CGraphicContext::BeginProcessPass() and EndProcessPass().
+   */
+  void Run(const std::vector<IGUIProcessTask *> &tasks);
+
+  /*! \brief Whether the calling thread is currently running a task of the pool.
+   */
+  bool InTask();
+
+  /*! \brief Stop and join the worker threads. They are restarted by the next Run().
+   */
+  void Stop();
+
+private:
+  CGUIProcessPool();
+  ~CGUIProcessPool();
+  CGUIProcessPool(const CGUIProcessPool&);
+  CGUIProcessPool const& operator=(CGUIProcessPool const&);
+
+  struct CTaskItem
+  {
+    IGUIProcessTask          *task;
+    const CGUITransformState *state;
+    volatile long            *pending;
+  };
+
+  struct CTaskQueue
+  {
+    CCriticalSection        section;
+    std::deque<CTaskItem>   items;
+  };
+
+  class CWorker : public CThread
+  {
+  public:
+    CWorker(CGUIProcessPool &pool, unsigned int queue);
+    unsigned int GetQueue() const { return m_queue; };
+  protected:
+    virtual void Process();
+  private:
+    CGUIProcessPool &m_pool;
+    unsigned int     m_queue;
+  };
+
+  void StartWorkers();
+  unsigned int CurrentQueue();
+  bool RunOne(unsigned int queue);
+  void RunTask(const CTaskItem &item);
+
+  std::vector<CTaskQueue *> m_queues;   ///< queue 0 is shared by callers that aren't workers
+  std::vector<CWorker *>    m_workers;
+  CCriticalSection          m_section;
+  CEvent                    m_workEvent;
+  volatile long             m_queued;
+
+  CCriticalSection               m_doneSection;  ///< guards waiting on m_doneCv against task completion
+  XbmcThreads::ConditionVariable m_doneCv;       ///< notified when a task completes or new tasks are queued
+
+  XbmcThreads::ThreadLocal<CWorker>   m_worker;
+  XbmcThreads::ThreadLocal<CTaskItem> m_running;
+};
@@ -23,13 +23,88 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "GraphicContext.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Atomics.h"
+
+#include <list>
+#include <map>
 
 using namespace std;
 
 #define WORK_AROUND_NEEDED_FOR_LINE_BREAKS
 
+#define MAX_CACHED_LAYOUTS     512  // number of parsed and wrapped layouts kept in the shared cache
+#define MAX_CACHED_TEXT_LENGTH 256  // longer text (plots etc.) rarely repeats, so isn't worth caching
+
+// Layouts shared between all CGUITextLayout objects, so labels that flip between a small
+// set of values (times, progress, list items scrolling in and out of view) don't need to
+// reparse, bidi flip and wrap their text each time it changes.
+namespace
+{
+  struct CLayoutKey
+  {
+    CGUIFont   *font;
+    CStdStringW text;
+    float       maxWidth;
+    float       maxHeight;
+    bool        wrap;
+    bool        forceLTR;
+    color_t     textColor;  // the base of the cached colors, as [COLOR] tags add to it
+    float       scaleX;     // the GUI scale the text was measured at, as it changes with the resolution
+    float       scaleY;
+
+    bool operator<(const CLayoutKey &right) const
+    {
+      if (font != right.font) return font < right.font;
+      if (scaleX != right.scaleX) return scaleX < right.scaleX;
+      if (scaleY != right.scaleY) return scaleY < right.scaleY;
+      if (maxWidth != right.maxWidth) return maxWidth < right.maxWidth;
+      if (maxHeight != right.maxHeight) return maxHeight < right.maxHeight;
+      if (wrap != right.wrap) return wrap < right.wrap;
+      if (forceLTR != right.forceLTR) return forceLTR < right.forceLTR;
+      if (textColor != right.textColor) return textColor < right.textColor;
+      return text < right.text;
+    }
+  };
+
+  struct CLayoutEntry
+  {
+    CLayoutKey          key;
+    vector<CGUIString>  lines;
+    vecColors           colors;
+    float               textWidth;
+    float               textHeight;
+  };
+
+  typedef list<CLayoutEntry> LayoutList;
+  typedef map<CLayoutKey, LayoutList::iterator> LayoutMap;
+
+  CCriticalSection g_layoutSection;
+  LayoutList       g_layoutList;   // most recently used at the front
+  LayoutMap        g_layoutMap;
+  unsigned int     g_layoutHits = 0;
+  unsigned int     g_layoutMisses = 0;
+
+  // bumped by ClearCache() and checked under the lock, so that fonts may safely
+  // invalidate the cache at any time, including during static destruction.
+  volatile long    g_layoutGeneration = 0;
+  long             g_layoutCacheGeneration = 0;
+
+  void ValidateLayoutCache()
+  {
+    if (g_layoutCacheGeneration != g_layoutGeneration)
+    {
+      g_layoutMap.clear();
+      g_layoutList.clear();
+      g_layoutCacheGeneration = g_layoutGeneration;
+    }
+  }
+}
+
 CGUIString::CGUIString(iString start, iString end, bool carriageReturn)
 {
   m_text.assign(start, end);
@@ -208,6 +283,12 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   if (text.Equals(m_lastText) && !forceUpdate)
     return false;
 
+  if (GetCachedLayout(text, maxWidth, forceLTRReadingOrder))
+  {
+    m_lastText = text;
+    return true;
+  }
+
   vecText parsedText;
 
   // empty out our previous string
@@ -236,10 +317,96 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   // and cache the width and height for later reading
   CalcTextExtent();
 
+  CacheLayout(text, maxWidth, forceLTRReadingOrder);
+
   m_lastText = text;
   return true;
 }
 
+bool CGUITextLayout::GetCachedLayout(const CStdStringW &text, float maxWidth, bool forceLTRReadingOrder)
+{
+  if (!m_font || text.size() > MAX_CACHED_TEXT_LENGTH)
+    return false;
+
+  CLayoutKey key;
+  key.font = m_font;
+  key.text = text;
+  key.wrap = m_wrap && maxWidth > 0;
+  key.maxWidth = key.wrap ? maxWidth : 0;
+  key.maxHeight = m_maxHeight;
+  key.forceLTR = forceLTRReadingOrder;
+  key.textColor = m_textColor;
+  key.scaleX = g_graphicsContext.GetGUIScaleX();
+  key.scaleY = g_graphicsContext.GetGUIScaleY();
+
+  CSingleLock lock(g_layoutSection);
+  ValidateLayoutCache();
+  LayoutMap::iterator it = g_layoutMap.find(key);
+  if (it == g_layoutMap.end())
+  {
+    g_layoutMisses++;
+    return false;
+  }
+  g_layoutHits++;
+
+  // move to the front of our LRU list
+  g_layoutList.splice(g_layoutList.begin(), g_layoutList, it->second);
+
+  const CLayoutEntry &entry = *it->second;
+  m_lines = entry.lines;
+  m_colors = entry.colors;
+  m_textWidth = entry.textWidth;
+  m_textHeight = entry.textHeight;
+  return true;
+}
+
+void CGUITextLayout::CacheLayout(const CStdStringW &text, float maxWidth, bool forceLTRReadingOrder) const
+{
+  if (!m_font || text.size() > MAX_CACHED_TEXT_LENGTH)
+    return;
+
+  CLayoutEntry entry;
+  entry.key.font = m_font;
+  entry.key.text = text;
+  entry.key.wrap = m_wrap && maxWidth > 0;
+  entry.key.maxWidth = entry.key.wrap ? maxWidth : 0;
+  entry.key.maxHeight = m_maxHeight;
+  entry.key.forceLTR = forceLTRReadingOrder;
+  entry.key.textColor = m_textColor;
+  entry.key.scaleX = g_graphicsContext.GetGUIScaleX();
+  entry.key.scaleY = g_graphicsContext.GetGUIScaleY();
+
+  CSingleLock lock(g_layoutSection);
+  ValidateLayoutCache();
+  if (g_layoutMap.find(entry.key) != g_layoutMap.end())
+    return;
+
+  entry.lines = m_lines;
+  entry.colors = m_colors;
+  entry.textWidth = m_textWidth;
+  entry.textHeight = m_textHeight;
+  g_layoutList.push_front(entry);
+  g_layoutMap.insert(make_pair(entry.key, g_layoutList.begin()));
+
+  if (g_layoutList.size() > MAX_CACHED_LAYOUTS)
+  { // drop the least recently used
+    g_layoutMap.erase(g_layoutList.back().key);
+    g_layoutList.pop_back();
+  }
+}
+
+void CGUITextLayout::ClearCache()
+{
+  AtomicIncrement(&g_layoutGeneration);
+}
+
+void CGUITextLayout::GetCacheStats(unsigned int &hits, unsigned int &misses)
+{
+  CSingleLock lock(g_layoutSection);
+  hits = g_layoutHits;
+  misses = g_layoutMisses;
+}
+
 // BidiTransform is used to handle RTL text flipping in the string
 void CGUITextLayout::BidiTransform(vector<CGUIString> &lines, bool forceLTRReadingOrder)
 {
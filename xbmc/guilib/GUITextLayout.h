@@ -100,6 +100,17 @@ public:
   static void DrawText(CGUIFont *font, float x, float y, color_t color, color_t shadowColor, const CStdString &text, uint32_t align);
   static void Filter(CStdString &text);
 
+  /*! \brief Drop all layouts from the shared layout cache.
+   Must be called whenever a font is deleted or has its metrics changed, as cached layouts are keyed on the font.
+   */
+  static void ClearCache();
+
+  /*! \brief Retrieve the shared layout cache statistics since startup.
+   \param hits [out] number of updates that were served from the cache
+   \param misses [out] number of updates that had to parse and wrap the text
+   */
+  static void GetCacheStats(unsigned int &hits, unsigned int &misses);
+
 protected:
   void ParseText(const CStdStringW &text, vecText &parsedText);
   void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
@@ -107,6 +118,8 @@ protected:
   void BidiTransform(std::vector<CGUIString> &lines, bool forceLTRReadingOrder);
   CStdStringW BidiFlip(const CStdStringW &text, bool forceLTRReadingOrder);
   void CalcTextExtent();
+  bool GetCachedLayout(const CStdStringW &text, float maxWidth, bool forceLTRReadingOrder);
+  void CacheLayout(const CStdStringW &text, float maxWidth, bool forceLTRReadingOrder) const;
 
   // our text to render
   vecColors m_colors;
@@ -29,6 +29,12 @@
 
 #if defined(HAS_GL)
 
+std::vector<CGUITextureGL::PackedVertex> CGUITextureGL::m_batch;
+GLuint CGUITextureGL::m_batchTexture = 0;
+GLuint CGUITextureGL::m_batchDiffuse = 0;
+GUITextureBatchStats CGUITextureGL::m_stats;
+GUITextureBatchStats CGUITextureGL::m_lastStats;
+
 CGUITextureGL::CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo &texture)
 : CGUITextureBase(posX, posY, width, height, texture)
 {
@@ -47,7 +53,104 @@ void CGUITextureGL::Begin(color_t color)
   if (m_diffuse.size())
     m_diffuse.m_textures[0]->LoadToGPU();
 
-  glBindTexture(GL_TEXTURE_2D, texture->GetTextureObject());
+  // consecutive textures with the same texture and diffuse can share a draw call,
+  // as the blend state is the same for all of them and the color is per vertex.
+  GLuint textureObject = texture->GetTextureObject();
+  GLuint diffuseObject = m_diffuse.size() ? m_diffuse.m_textures[0]->GetTextureObject() : 0;
+  if (!m_batch.empty() && (textureObject != m_batchTexture || diffuseObject != m_batchDiffuse))
+  {
+    FlushBatch();
+    m_stats.stateChanges++;
+  }
+  m_batchTexture = textureObject;
+  m_batchDiffuse = diffuseObject;
+}
+
+void CGUITextureGL::End()
+{
+  // nothing to do - our quads are rendered by FlushBatch()
+}
+
+void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
+{
+  PackedVertex v[4];
+  for (int i = 0; i < 4; i++)
+  {
+    v[i].x = x[i];
+    v[i].y = y[i];
+    v[i].z = z[i];
+    v[i].r = m_col[0];
+    v[i].g = m_col[1];
+    v[i].b = m_col[2];
+    v[i].a = m_col[3];
+  }
+
+  // Top-left vertex (corner)
+  v[0].u1 = texture.x1;
+  v[0].v1 = texture.y1;
+  v[0].u2 = diffuse.x1;
+  v[0].v2 = diffuse.y1;
+
+  // Top-right vertex (corner)
+  if (orientation & 4)
+  {
+    v[1].u1 = texture.x1;
+    v[1].v1 = texture.y2;
+  }
+  else
+  {
+    v[1].u1 = texture.x2;
+    v[1].v1 = texture.y1;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[1].u2 = diffuse.x1;
+    v[1].v2 = diffuse.y2;
+  }
+  else
+  {
+    v[1].u2 = diffuse.x2;
+    v[1].v2 = diffuse.y1;
+  }
+
+  // Bottom-right vertex (corner)
+  v[2].u1 = texture.x2;
+  v[2].v1 = texture.y2;
+  v[2].u2 = diffuse.x2;
+  v[2].v2 = diffuse.y2;
+
+  // Bottom-left vertex (corner)
+  if (orientation & 4)
+  {
+    v[3].u1 = texture.x2;
+    v[3].v1 = texture.y1;
+  }
+  else
+  {
+    v[3].u1 = texture.x1;
+    v[3].v1 = texture.y2;
+  }
+  if (m_info.orientation & 4)
+  {
+    v[3].u2 = diffuse.x2;
+    v[3].v2 = diffuse.y1;
+  }
+  else
+  {
+    v[3].u2 = diffuse.x1;
+    v[3].v2 = diffuse.y2;
+  }
+
+  m_batch.insert(m_batch.end(), v, v + 4);
+}
+
+void CGUITextureGL::FlushBatch()
+{
+  if (m_batch.empty())
+    return;
+
+  glActiveTextureARB(GL_TEXTURE0_ARB);
+  glBindTexture(GL_TEXTURE_2D, m_batchTexture);
   glEnable(GL_TEXTURE_2D);
 
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
@@ -63,10 +166,10 @@ void CGUITextureGL::Begin(color_t color)
   glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
   VerifyGLState();
 
-  if (m_diffuse.size())
+  if (m_batchDiffuse)
   {
     glActiveTextureARB(GL_TEXTURE1_ARB);
-    glBindTexture(GL_TEXTURE_2D, m_diffuse.m_textures[0]->GetTextureObject());
+    glBindTexture(GL_TEXTURE_2D, m_batchDiffuse);
     glEnable(GL_TEXTURE_2D);
     glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_COMBINE);
     glTexEnvf(GL_TEXTURE_ENV, GL_COMBINE_RGB, GL_MODULATE);
@@ -76,71 +179,51 @@ void CGUITextureGL::Begin(color_t color)
     glTexEnvf(GL_TEXTURE_ENV, GL_OPERAND1_RGB, GL_SRC_COLOR);
     VerifyGLState();
   }
-  //glDisable(GL_TEXTURE_2D); // uncomment these 2 lines to switch to wireframe rendering
-  //glBegin(GL_LINE_LOOP);
-  glBegin(GL_QUADS);
-}
 
-void CGUITextureGL::End()
-{
-  glEnd();
-  if (m_diffuse.size())
-  {
-    glDisable(GL_TEXTURE_2D);
-    glActiveTextureARB(GL_TEXTURE0_ARB);
-  }
-  glDisable(GL_TEXTURE_2D);
-}
+  glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
-void CGUITextureGL::Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation)
-{
-  // Top-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y1);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y1);
-  glVertex3f(x[0], y[0], z[0]);
+  const PackedVertex *v = &m_batch[0];
+  glVertexPointer(3, GL_FLOAT,         sizeof(PackedVertex), &v->x);
+  glColorPointer (4, GL_UNSIGNED_BYTE, sizeof(PackedVertex), &v->r);
+  glEnableClientState(GL_VERTEX_ARRAY);
+  glEnableClientState(GL_COLOR_ARRAY);
 
-  // Top-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  if (m_diffuse.size())
+  glClientActiveTextureARB(GL_TEXTURE0_ARB);
+  glTexCoordPointer(2, GL_FLOAT, sizeof(PackedVertex), &v->u1);
+  glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+  if (m_batchDiffuse)
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
+    glClientActiveTextureARB(GL_TEXTURE1_ARB);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(PackedVertex), &v->u2);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
   }
-  glVertex3f(x[1], y[1], z[1]);
 
-  // Bottom-right vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y2);
-  if (m_diffuse.size())
-    glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y2);
-  glVertex3f(x[2], y[2], z[2]);
+  glDrawArrays(GL_QUADS, 0, m_batch.size());
 
-  // Bottom-left vertex (corner)
-  glColor4ub(m_col[0], m_col[1], m_col[2], m_col[3]);
-  if (orientation & 4)
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x2, texture.y1);
-  else
-    glMultiTexCoord2fARB(GL_TEXTURE0_ARB, texture.x1, texture.y2);
-  if (m_diffuse.size())
+  glPopClientAttrib();
+
+  if (m_batchDiffuse)
   {
-    if (m_info.orientation & 4)
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x2, diffuse.y1);
-    else
-      glMultiTexCoord2fARB(GL_TEXTURE1_ARB, diffuse.x1, diffuse.y2);
+    glDisable(GL_TEXTURE_2D);
+    glActiveTextureARB(GL_TEXTURE0_ARB);
   }
-  glVertex3f(x[3], y[3], z[3]);
+  glDisable(GL_TEXTURE_2D);
+
+  m_stats.drawCalls++;
+  m_stats.quads += m_batch.size() / 4;
+  m_batch.clear();
+}
+
+void CGUITextureGL::ResetBatchStats()
+{
+  m_lastStats = m_stats;
+  m_stats = GUITextureBatchStats();
 }
 
 void CGUITextureGL::DrawQuad(const CRect &rect, color_t color, CBaseTexture *texture, const CRect *texCoords)
 {
+  FlushBatch();
+
   if (texture)
   {
     glActiveTextureARB(GL_TEXTURE0_ARB);
@@ -31,17 +31,62 @@
 
 #include "GUITexture.h"
 
+#include <vector>
+
+/*!
+ \brief Batch statistics for the GUI texture renderer
+ \sa CGUITextureGL::GetBatchStats
+ */
+struct GUITextureBatchStats
+{
+  GUITextureBatchStats() : drawCalls(0), stateChanges(0), quads(0) {};
+  unsigned int drawCalls;     ///< number of draw calls issued
+  unsigned int stateChanges;  ///< number of batches that were broken due to a texture change
+  unsigned int quads;         ///< number of quads rendered
+};
+
 class CGUITextureGL : public CGUITextureBase
 {
 public:
   CGUITextureGL(float posX, float posY, float width, float height, const CTextureInfo& texture);
   static void DrawQuad(const CRect &coords, color_t color, CBaseTexture *texture = NULL, const CRect *texCoords = NULL);
+
+  /*! \brief Render any quads that are waiting in the batch.
+   Quads from consecutive textures sharing the same texture and diffuse texture are merged into a
+   single draw call, so this must be called before anything else renders or changes the GL state
+   (viewport, scissors, transforms, render target) and before the frame is presented.
+   */
+  static void FlushBatch();
+
+  /*! \brief Finish the statistics for the current frame and start new ones.
+   \sa GetBatchStats
+   */
+  static void ResetBatchStats();
+
+  /*! \brief Retrieve the batch statistics of the last completed frame.
+   \return statistics of the previous frame
+   */
+  static const GUITextureBatchStats &GetBatchStats() { return m_lastStats; };
 protected:
   void Begin(color_t color);
   void Draw(float *x, float *y, float *z, const CRect &texture, const CRect &diffuse, int orientation);
   void End();
 private:
+  struct PackedVertex
+  {
+    float x, y, z;
+    GLubyte r, g, b, a;
+    float u1, v1;
+    float u2, v2;
+  };
+
   GLubyte m_col[4];
+
+  static std::vector<PackedVertex> m_batch;
+  static GLuint m_batchTexture;
+  static GLuint m_batchDiffuse;
+  static GUITextureBatchStats m_stats;
+  static GUITextureBatchStats m_lastStats;
 };
 
 #endif
@@ -115,17 +115,32 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
   TiXmlDocument xmlDoc;
-  if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+  if (g_SkinInfo->GetCachedWindowXML(strPath, xmlDoc))
+    return Load(xmlDoc, true);
+
+  CStdString file = strPath;
+  if (!xmlDoc.LoadFile(file) && !xmlDoc.LoadFile(file = CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(file = strLowerPath))
   {
     CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
     SetID(WINDOW_INVALID);
     return false;
   }
 
-  return Load(xmlDoc);
+  // Resolve any includes now, so that the result can be kept for the next time the window is loaded.
+  // Windows with conditional includes are resolved afresh each time.
+  TiXmlElement* pRootElement = xmlDoc.RootElement();
+  if (pRootElement && strcmpi(pRootElement->Value(), "window") == 0)
+  {
+    g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
+    bool conditional = false;
+    g_SkinInfo->ResolveIncludes(pRootElement, &conditional);
+    if (!conditional)
+      g_SkinInfo->CacheWindowXML(strPath, file, xmlDoc);
+  }
+  return Load(xmlDoc, true);
 }
 
-bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
+bool CGUIWindow::Load(TiXmlDocument &xmlDoc, bool includesResolved /* = false */)
 {
   TiXmlElement* pRootElement = xmlDoc.RootElement();
   if (strcmpi(pRootElement->Value(), "window"))
@@ -139,7 +154,8 @@ bool CGUIWindow::Load(TiXmlDocument &xmlDoc)
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
   // Resolve any includes that may be present
-  g_SkinInfo->ResolveIncludes(pRootElement);
+  if (!includesResolved)
+    g_SkinInfo->ResolveIncludes(pRootElement);
   // now load in the skin file
   SetDefaults();
 
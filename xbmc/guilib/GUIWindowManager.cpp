@@ -32,6 +32,8 @@
 #include "settings/AdvancedSettings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIFrameProfiler.h"
+#include "GUIProcessPool.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
 
@@ -489,23 +491,43 @@ bool RenderOrderSortFunction(CGUIWindow *first, CGUIWindow *second)
   return first->GetRenderOrder() < second->GetRenderOrder();
 }
 
+namespace
+{
+  class CWindowProcessTask : public IGUIProcessTask
+  {
+  public:
+    CWindowProcessTask(CGUIWindow *window, unsigned int currentTime) : m_window(window), m_currentTime(currentTime) {};
+    virtual void Process() { m_window->DoProcess(m_currentTime, m_dirtyRegions); };
+    CDirtyRegionList m_dirtyRegions;
+  private:
+    CGUIWindow *m_window;
+    unsigned int m_currentTime;
+  };
+}
+
 void CGUIWindowManager::Process(unsigned int currentTime)
 {
   assert(g_application.IsCurrentThread());
+  GUIPROFILER_SCOPE("WindowManager::Process");
   CSingleLock lock(g_graphicsContext);
 
   CDirtyRegionList dirtyregions;
 
-  CGUIWindow* pWindow = GetWindow(GetActiveWindow());
-  if (pWindow)
-    pWindow->DoProcess(currentTime, dirtyregions);
-
-  // process all dialogs - visibility may change etc.
-  for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); it++)
+  if (g_advancedSettings.m_guiParallelProcess)
+    ProcessParallel(currentTime, dirtyregions);
+  else
   {
-    CGUIWindow *pWindow = (*it).second;
-    if (pWindow && pWindow->IsDialog())
+    CGUIWindow* pWindow = GetWindow(GetActiveWindow());
+    if (pWindow)
       pWindow->DoProcess(currentTime, dirtyregions);
+
+    // process all dialogs - visibility may change etc.
+    for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); it++)
+    {
+      CGUIWindow *pWindow = (*it).second;
+      if (pWindow && pWindow->IsDialog())
+        pWindow->DoProcess(currentTime, dirtyregions);
+    }
   }
 
   if (g_application.m_AppActive)
@@ -515,6 +537,54 @@ void CGUIWindowManager::Process(unsigned int currentTime)
   }
 }
 
+void CGUIWindowManager::ProcessParallel(unsigned int currentTime, CDirtyRegionList &dirtyregions)
+{
+  // the active window and each dialog are independent control trees. Those using a camera
+  // need the render system and are done here, the rest are processed on the pool.
+  std::vector<CGUIWindow *> windows;
+  CGUIWindow* pWindow = GetWindow(GetActiveWindow());
+  if (pWindow)
+    windows.push_back(pWindow);
+  for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); it++)
+  {
+    if ((*it).second && (*it).second->IsDialog())
+      windows.push_back((*it).second);
+  }
+
+  std::vector<IGUIProcessTask *> tasks;
+  for (std::vector<CGUIWindow *>::iterator it = windows.begin(); it != windows.end(); ++it)
+  {
+    if ((*it)->HasCamera())
+      (*it)->DoProcess(currentTime, dirtyregions);
+    else
+    { // showing or closing a dialog changes the active dialogs, so it's done here rather than on the pool
+      if ((*it)->IsDialog())
+        ((CGUIDialog *)*it)->UpdateVisibility();
+      tasks.push_back(new CWindowProcessTask(*it, currentTime));
+    }
+  }
+  if (tasks.empty())
+    return;
+
+  // put the render system back to the default camera the pool's threads assume, then let go of
+  // the graphics context so they can take it for font and texture access. Any other thread that
+  // takes it is held off until the pass ends, so windows don't change under it.
+  g_graphicsContext.SetRenderingResolution(g_graphicsContext.GetResInfo(), false);
+  g_graphicsContext.BeginProcessPass();
+  {
+    CSingleExit exit(g_graphicsContext);
+    CGUIProcessPool::Get().Run(tasks);
+    g_graphicsContext.EndProcessPass(); // before we take it back
+  }
+
+  for (std::vector<IGUIProcessTask *>::iterator it = tasks.begin(); it != tasks.end(); ++it)
+  {
+    CWindowProcessTask *task = (CWindowProcessTask *)*it;
+    dirtyregions.insert(dirtyregions.end(), task->m_dirtyRegions.begin(), task->m_dirtyRegions.end());
+    delete task;
+  }
+}
+
 void CGUIWindowManager::MarkDirty()
 {
   m_tracker.MarkDirtyRegion(CRect(0, 0, (float)g_graphicsContext.GetWidth(), (float)g_graphicsContext.GetHeight()));
@@ -543,6 +613,7 @@ void CGUIWindowManager::RenderPass()
 bool CGUIWindowManager::Render()
 {
   assert(g_application.IsCurrentThread());
+  GUIPROFILER_SCOPE("WindowManager::Render");
   CSingleLock lock(g_graphicsContext);
 
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
@@ -652,6 +723,8 @@ void CGUIWindowManager::SetCallback(IWindowManagerCallback& callback)
 
 void CGUIWindowManager::DeInitialize()
 {
+  CGUIProcessPool::Get().Stop();
+
   CSingleLock lock(g_graphicsContext);
   for (WindowMap::iterator it = m_mapWindows.begin(); it != m_mapWindows.end(); it++)
   {
@@ -764,6 +837,7 @@ void CGUIWindowManager::SendThreadMessage(CGUIMessage& message, int window)
 
 void CGUIWindowManager::DispatchThreadMessages()
 {
+  GUIPROFILER_SCOPE("WindowManager::DispatchThreadMessages");
   CSingleLock lock(m_critSection);
   vector< pair<CGUIMessage*,int> > messages(m_vecThreadMessages);
   m_vecThreadMessages.erase(m_vecThreadMessages.begin(), m_vecThreadMessages.end());
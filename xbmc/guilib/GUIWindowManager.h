@@ -133,6 +133,11 @@ public:
 private:
   void RenderPass();
 
+  /*! \brief Process the active window and dialogs concurrently on the CGUIProcessPool.
+   Enabled with <gui><parallelprocess> in advancedsettings.xml.
+   */
+  void ProcessParallel(unsigned int currentTime, CDirtyRegionList &dirtyregions);
+
   void LoadNotOnDemandWindows();
   void UnloadNotOnDemandWindows();
   void HideOverlay(CGUIWindow::OVERLAY_STATE state);
@@ -22,6 +22,7 @@
 #include "system.h"
 #include "GraphicContext.h"
 #include "threads/SingleLock.h"
+#include "threads/Atomics.h"
 #include "Application.h"
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
@@ -31,6 +32,7 @@
 #include "TextureManager.h"
 #include "input/MouseStat.h"
 #include "GUIWindowManager.h"
+#include "GUIProcessPool.h"
 #include "utils/JobManager.h"
 #include "video/VideoReferenceClock.h"
 
@@ -51,59 +53,83 @@ CGraphicContext::CGraphicContext(void) :
   m_bFullScreenVideo(false),
   m_bCalibrating(false), 
   m_Resolution(RES_INVALID), 
-  /*m_windowResolution,*/
-  m_guiScaleX(1.0f), 
-  m_guiScaleY(1.0f) 
-  /*,m_cameras, */ 
-  /*m_origins, */
-  /*m_clipRegions,*/
-  /*m_guiTransform,*/
-  /*m_finalTransform, */
-  /*m_groupTransform*/
+  /*m_state,*/
+  m_threadStates(0),
+  m_processPass(false),
+  m_processPassDone(true, true)
 {
+  set_name("CGraphicContext");
+  set_gate(this);
 }
 
 CGraphicContext::~CGraphicContext(void)
 {
 }
 
+void CGraphicContext::BeginProcessPass()
+{
+  m_processPassDone.Reset();
+  m_processPass = true;
+}
+
+void CGraphicContext::EndProcessPass()
+{
+  m_processPass = false;
+  m_processPassDone.Set();
+}
+
+bool CGraphicContext::HoldOff()
+{
+  // the pass is started by the main thread while it holds the lock, so once we
+  //  have it m_processPass can only go from true to false.
+  return m_processPass && !CGUIProcessPool::Get().InTask();
+}
+
+void CGraphicContext::Wait()
+{
+  m_processPassDone.Wait();
+}
+
 void CGraphicContext::SetOrigin(float x, float y)
 {
-  if (m_origins.size())
-    m_origins.push(CPoint(x,y) + m_origins.top());
+  CGUITransformState &state = State();
+  if (state.origins.size())
+    state.origins.push(CPoint(x,y) + state.origins.top());
   else
-    m_origins.push(CPoint(x,y));
+    state.origins.push(CPoint(x,y));
 
   AddTransform(TransformMatrix::CreateTranslation(x, y));
 }
 
 void CGraphicContext::RestoreOrigin()
 {
-  if (m_origins.size())
-    m_origins.pop();
+  CGUITransformState &state = State();
+  if (state.origins.size())
+    state.origins.pop();
   RemoveTransform();
 }
 
 // add a new clip region, intersecting with the previous clip region.
 bool CGraphicContext::SetClipRegion(float x, float y, float w, float h)
 { // transform from our origin
+  CGUITransformState &state = State();
   CPoint origin;
-  if (m_origins.size())
-    origin = m_origins.top();
+  if (state.origins.size())
+    origin = state.origins.top();
 
   // ok, now intersect with our old clip region
   CRect rect(x, y, x + w, y + h);
   rect += origin;
-  if (m_clipRegions.size())
+  if (state.clipRegions.size())
   {
     // intersect with original clip region
-    rect.Intersect(m_clipRegions.top());
+    rect.Intersect(state.clipRegions.top());
   }
 
   if (rect.IsEmpty())
     return false;
 
-  m_clipRegions.push(rect);
+  state.clipRegions.push(rect);
 
   // here we could set the hardware clipping, if applicable
   return true;
@@ -111,23 +137,25 @@ bool CGraphicContext::SetClipRegion(float x, float y, float w, float h)
 
 void CGraphicContext::RestoreClipRegion()
 {
-  if (m_clipRegions.size())
-    m_clipRegions.pop();
+  CGUITransformState &state = State();
+  if (state.clipRegions.size())
+    state.clipRegions.pop();
 
   // here we could reset the hardware clipping, if applicable
 }
 
 void CGraphicContext::ClipRect(CRect &vertex, CRect &texture, CRect *texture2)
 {
+  CGUITransformState &state = State();
   // this is the software clipping routine.  If the graphics hardware is set to do the clipping
   // (eg via SetClipPlane in D3D for instance) then this routine is unneeded.
-  if (m_clipRegions.size())
+  if (state.clipRegions.size())
   {
     // take a copy of the vertex rectangle and intersect
     // it with our clip region (moved to the same coordinate system)
-    CRect clipRegion(m_clipRegions.top());
-    if (m_origins.size())
-      clipRegion -= m_origins.top();
+    CRect clipRegion(state.clipRegions.top());
+    if (state.origins.size())
+      clipRegion -= state.origins.top();
     CRect original(vertex);
     vertex.Intersect(clipRegion);
     // and use the original to compute the texture coordinates
@@ -220,7 +248,7 @@ bool CGraphicContext::SetViewPort(float fx, float fy, float fwidth, float fheigh
 
   m_viewStack.push(oldviewport);
 
-  UpdateCameraPosition(m_cameras.top());
+  UpdateCameraPosition(State().cameras.top());
   return true;
 }
 
@@ -233,7 +261,7 @@ void CGraphicContext::RestoreViewPort()
 
   m_viewStack.pop();
 
-  UpdateCameraPosition(m_cameras.top());
+  UpdateCameraPosition(State().cameras.top());
 }
 
 void CGraphicContext::SetScissors(const CRect &rect)
@@ -564,8 +592,9 @@ const RESOLUTION_INFO &CGraphicContext::GetResInfo() const
 
 void CGraphicContext::SetScalingResolution(const RESOLUTION_INFO &res, bool needsScaling)
 {
+  CGUITransformState &state = State();
   Lock();
-  m_windowResolution = res;
+  state.windowResolution = res;
   if (needsScaling && m_Resolution != RES_INVALID)
   {
     // calculate necessary scalings
@@ -602,28 +631,28 @@ void CGraphicContext::SetScalingResolution(const RESOLUTION_INFO &res, bool need
     fToPosY -= fToHeight * fZoom * 0.5f;
     fToHeight *= fZoom + 1.0f;
 
-    m_guiScaleX = fFromWidth / fToWidth;
-    m_guiScaleY = fFromHeight / fToHeight;
+    state.guiScaleX = fFromWidth / fToWidth;
+    state.guiScaleY = fFromHeight / fToHeight;
     TransformMatrix guiScaler = TransformMatrix::CreateScaler(fToWidth / fFromWidth, fToHeight / fFromHeight, fToHeight / fFromHeight);
     TransformMatrix guiOffset = TransformMatrix::CreateTranslation(fToPosX, fToPosY);
-    m_guiTransform = guiOffset * guiScaler;
+    state.guiTransform = guiOffset * guiScaler;
   }
   else
   {
-    m_guiTransform.Reset();
-    m_guiScaleX = 1.0f;
-    m_guiScaleY = 1.0f;
+    state.guiTransform.Reset();
+    state.guiScaleX = 1.0f;
+    state.guiScaleY = 1.0f;
   }
   // reset our origin and camera
-  while (m_origins.size())
-    m_origins.pop();
-  m_origins.push(CPoint(0, 0));
-  while (m_cameras.size())
-    m_cameras.pop();
-  m_cameras.push(CPoint(0.5f*m_iScreenWidth, 0.5f*m_iScreenHeight));
+  while (state.origins.size())
+    state.origins.pop();
+  state.origins.push(CPoint(0, 0));
+  while (state.cameras.size())
+    state.cameras.pop();
+  state.cameras.push(CPoint(0.5f*m_iScreenWidth, 0.5f*m_iScreenHeight));
 
   // and reset the final transform
-  UpdateFinalTransform(m_guiTransform);
+  UpdateFinalTransform(state.guiTransform);
   Unlock();
 }
 
@@ -631,13 +660,13 @@ void CGraphicContext::SetRenderingResolution(const RESOLUTION_INFO &res, bool ne
 {
   Lock();
   SetScalingResolution(res, needsScaling);
-  UpdateCameraPosition(m_cameras.top());
+  UpdateCameraPosition(State().cameras.top());
   Unlock();
 }
 
 void CGraphicContext::UpdateFinalTransform(const TransformMatrix &matrix)
 {
-  m_finalTransform = matrix;
+  State().finalTransform = matrix;
   // We could set the world transform here to GPU-ize the animation system.
   // trouble is that we require the resulting x,y coords to be rounded to
   // the nearest pixel (vertex shader perhaps?)
@@ -645,15 +674,16 @@ void CGraphicContext::UpdateFinalTransform(const TransformMatrix &matrix)
 
 void CGraphicContext::InvertFinalCoords(float &x, float &y) const
 {
-  m_finalTransform.InverseTransformPosition(x, y);
+  State().finalTransform.InverseTransformPosition(x, y);
 }
 
 float CGraphicContext::GetScalingPixelRatio() const
 {
+  const CGUITransformState &state = State();
   // assume the resolutions are different - we want to return the aspect ratio of the video resolution
   // but only once it's been corrected for the skin -> screen coordinates scaling
-  float winWidth = (float)m_windowResolution.iWidth;
-  float winHeight = (float)m_windowResolution.iHeight;
+  float winWidth = (float)state.windowResolution.iWidth;
+  float winHeight = (float)state.windowResolution.iHeight;
   float outWidth = (float)g_settings.m_ResInfo[m_Resolution].iWidth;
   float outHeight = (float)g_settings.m_ResInfo[m_Resolution].iHeight;
   float outPR = GetPixelRatio(m_Resolution);
@@ -663,24 +693,26 @@ float CGraphicContext::GetScalingPixelRatio() const
 
 void CGraphicContext::SetCameraPosition(const CPoint &camera)
 {
+  CGUITransformState &state = State();
   // offset the camera from our current location (this is in XML coordinates) and scale it up to
   // the screen resolution
   CPoint cam(camera);
-  if (m_origins.size())
-    cam += m_origins.top();
+  if (state.origins.size())
+    cam += state.origins.top();
 
-  cam.x *= (float)m_iScreenWidth / m_windowResolution.iWidth;
-  cam.y *= (float)m_iScreenHeight / m_windowResolution.iHeight;
+  cam.x *= (float)m_iScreenWidth / state.windowResolution.iWidth;
+  cam.y *= (float)m_iScreenHeight / state.windowResolution.iHeight;
 
-  m_cameras.push(cam);
-  UpdateCameraPosition(m_cameras.top());
+  state.cameras.push(cam);
+  UpdateCameraPosition(state.cameras.top());
 }
 
 void CGraphicContext::RestoreCameraPosition()
 { // remove the top camera from the stack
-  ASSERT(m_cameras.size());
-  m_cameras.pop();
-  UpdateCameraPosition(m_cameras.top());
+  CGUITransformState &state = State();
+  ASSERT(state.cameras.size());
+  state.cameras.pop();
+  UpdateCameraPosition(state.cameras.top());
 }
 
 CRect CGraphicContext::generateAABB(const CRect &rect) const
@@ -725,14 +757,29 @@ CRect CGraphicContext::generateAABB(const CRect &rect) const
 //       to cut down on one setting)
 void CGraphicContext::UpdateCameraPosition(const CPoint &camera)
 {
+  // threads processing controls off the render thread mustn't touch the render system
+  if (m_threadStates && m_threadState.get())
+    return;
   g_Windowing.SetCameraPosition(camera, m_iScreenWidth, m_iScreenHeight);
 }
 
+CGUITransformState *CGraphicContext::SetThreadState(CGUITransformState *state)
+{
+  CGUITransformState *previous = m_threadState.get();
+  if (state && !previous)
+    AtomicIncrement(&m_threadStates);
+  else if (!state && previous)
+    AtomicDecrement(&m_threadStates);
+  m_threadState.set(state);
+  return previous;
+}
+
 bool CGraphicContext::RectIsAngled(float x1, float y1, float x2, float y2) const
 { // need only test 3 points, as they must be co-planer
-  if (m_finalTransform.TransformZCoord(x1, y1, 0)) return true;
-  if (m_finalTransform.TransformZCoord(x2, y2, 0)) return true;
-  if (m_finalTransform.TransformZCoord(x1, y2, 0)) return true;
+  const TransformMatrix &finalTransform = State().finalTransform;
+  if (finalTransform.TransformZCoord(x1, y1, 0)) return true;
+  if (finalTransform.TransformZCoord(x2, y2, 0)) return true;
+  if (finalTransform.TransformZCoord(x1, y2, 0)) return true;
   return false;
 }
 
@@ -812,7 +859,7 @@ void CGraphicContext::Flip(const CDirtyRegionList& dirty)
 
 void CGraphicContext::ApplyHardwareTransform()
 {
-  g_Windowing.ApplyHardwareTransform(m_finalTransform);
+  g_Windowing.ApplyHardwareTransform(State().finalTransform);
 }
 
 void CGraphicContext::RestoreHardwareTransform()
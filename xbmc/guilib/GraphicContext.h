@@ -41,7 +41,9 @@
 #include <stack>
 #include <map>
 #include "threads/CriticalSection.h"  // base class
-#include "TransformMatrix.h"        // for the members m_guiTransform etc.
+#include "threads/ThreadLocal.h"
+#include "threads/Event.h"
+#include "TransformMatrix.h"        // for the members m_state.guiTransform etc.
 #include "Geometry.h"               // for CRect/CPoint
 #include "gui3d.h"
 #include "utils/StdString.h"
@@ -64,7 +66,30 @@ enum VIEW_TYPE { VIEW_TYPE_NONE = 0,
                  VIEW_TYPE_MAX };
 
 
-class CGraphicContext : public CCriticalSection
+/*!
+ \brief Coordinate state used while processing and rendering controls
+
+ The scaling, origin, camera, clip and transform stacks that controls push and pop
+ as they walk their children. The render thread uses the graphics context's own copy;
+ threads processing controls in parallel install their own with SetThreadState().
+ */
+struct CGUITransformState
+{
+  CGUITransformState() : guiScaleX(1.0f), guiScaleY(1.0f) {};
+
+  RESOLUTION_INFO windowResolution;
+  float guiScaleX;
+  float guiScaleY;
+  std::stack<CPoint> cameras;
+  std::stack<CPoint> origins;
+  std::stack<CRect>  clipRegions;
+
+  TransformMatrix guiTransform;
+  TransformMatrix finalTransform;
+  std::stack<TransformMatrix> groupTransform;
+};
+
+class CGraphicContext : public CCriticalSection, private XbmcThreads::LockGate
 {
 public:
   CGraphicContext(void);
@@ -103,6 +128,15 @@ public:
   void ResetScreenParameters(RESOLUTION res);
   void Lock() { lock(); }
   void Unlock() { unlock(); }
+
+  /*! \brief Mark the start and end of a parallel process pass.
+   The main thread lets go of the lock while the pass runs, and any other thread that takes it
+   meanwhile is held off until the pass ends. Only the tasks of the pass get through. The main
+   thread must end the pass before it takes the lock back.
+   */
+  void BeginProcessPass();
+  void EndProcessPass();
+  bool InProcessPass() const { return m_processPass; }
   float GetPixelRatio(RESOLUTION iRes) const;
   void CaptureStateBlock();
   void ApplyStateBlock();
@@ -116,17 +150,17 @@ public:
   float GetScalingPixelRatio() const;
   void Flip(const CDirtyRegionList& dirty);
   void InvertFinalCoords(float &x, float &y) const;
-  inline float ScaleFinalXCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.TransformXCoord(x, y, 0); }
-  inline float ScaleFinalYCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.TransformYCoord(x, y, 0); }
-  inline float ScaleFinalZCoord(float x, float y) const XBMC_FORCE_INLINE { return m_finalTransform.TransformZCoord(x, y, 0); }
-  inline void ScaleFinalCoords(float &x, float &y, float &z) const XBMC_FORCE_INLINE { m_finalTransform.TransformPosition(x, y, z); }
+  inline float ScaleFinalXCoord(float x, float y) const XBMC_FORCE_INLINE { return State().finalTransform.TransformXCoord(x, y, 0); }
+  inline float ScaleFinalYCoord(float x, float y) const XBMC_FORCE_INLINE { return State().finalTransform.TransformYCoord(x, y, 0); }
+  inline float ScaleFinalZCoord(float x, float y) const XBMC_FORCE_INLINE { return State().finalTransform.TransformZCoord(x, y, 0); }
+  inline void ScaleFinalCoords(float &x, float &y, float &z) const XBMC_FORCE_INLINE { State().finalTransform.TransformPosition(x, y, z); }
   bool RectIsAngled(float x1, float y1, float x2, float y2) const;
 
-  inline float GetGUIScaleX() const XBMC_FORCE_INLINE { return m_guiScaleX; }
-  inline float GetGUIScaleY() const XBMC_FORCE_INLINE { return m_guiScaleY; }
+  inline float GetGUIScaleX() const XBMC_FORCE_INLINE { return State().guiScaleX; }
+  inline float GetGUIScaleY() const XBMC_FORCE_INLINE { return State().guiScaleY; }
   inline color_t MergeAlpha(color_t color) const XBMC_FORCE_INLINE
   {
-    color_t alpha = m_finalTransform.TransformAlpha((color >> 24) & 0xff);
+    color_t alpha = State().finalTransform.TransformAlpha((color >> 24) & 0xff);
     if (alpha > 255) alpha = 255;
     return ((alpha << 24) & 0xff000000) | (color & 0xffffff);
   }
@@ -172,16 +206,18 @@ public:
   void ClipRect(CRect &vertex, CRect &texture, CRect *diffuse = NULL);
   inline unsigned int AddGUITransform()
   {
-    unsigned int size = m_groupTransform.size();
-    m_groupTransform.push(m_guiTransform);
-    UpdateFinalTransform(m_groupTransform.top());
+    CGUITransformState &state = State();
+    unsigned int size = state.groupTransform.size();
+    state.groupTransform.push(state.guiTransform);
+    UpdateFinalTransform(state.groupTransform.top());
     return size;
   }
   inline TransformMatrix AddTransform(const TransformMatrix &matrix)
   {
-    ASSERT(m_groupTransform.size());
-    TransformMatrix absoluteMatrix = m_groupTransform.size() ? m_groupTransform.top() * matrix : matrix;
-    m_groupTransform.push(absoluteMatrix);
+    CGUITransformState &state = State();
+    ASSERT(state.groupTransform.size());
+    TransformMatrix absoluteMatrix = state.groupTransform.size() ? state.groupTransform.top() * matrix : matrix;
+    state.groupTransform.push(absoluteMatrix);
     UpdateFinalTransform(absoluteMatrix);
     return absoluteMatrix;
   }
@@ -189,24 +225,36 @@ public:
   {
     // TODO: We only need to add it to the group transform as other transforms may be added on top of this one later on
     //       Once all transforms are cached then this can be removed and UpdateFinalTransform can be called directly
-    ASSERT(m_groupTransform.size());
-    m_groupTransform.push(matrix);
-    UpdateFinalTransform(m_groupTransform.top());
+    CGUITransformState &state = State();
+    ASSERT(state.groupTransform.size());
+    state.groupTransform.push(matrix);
+    UpdateFinalTransform(state.groupTransform.top());
   }
   inline unsigned int RemoveTransform()
   {
-    ASSERT(m_groupTransform.size());
-    if (m_groupTransform.size())
-      m_groupTransform.pop();
-    if (m_groupTransform.size())
-      UpdateFinalTransform(m_groupTransform.top());
+    CGUITransformState &state = State();
+    ASSERT(state.groupTransform.size());
+    if (state.groupTransform.size())
+      state.groupTransform.pop();
+    if (state.groupTransform.size())
+      UpdateFinalTransform(state.groupTransform.top());
     else
       UpdateFinalTransform(TransformMatrix());
-    return m_groupTransform.size();
+    return state.groupTransform.size();
   }
 
   CRect generateAABB(const CRect &rect) const;
 
+  /*! \brief Give the calling thread its own coordinate state
+   Used when controls are processed off the render thread (see CGUIProcessPool). While a thread
+   state is set, camera changes are tracked but not applied to the render system, so only
+   controls that don't use a camera may be processed this way.
+   \param state the state to use from now on, NULL to return to the shared state.
+   \return the previously set thread state, if any.
+   */
+  CGUITransformState *SetThreadState(CGUITransformState *state);
+  const CGUITransformState &GetTransformState() const { return State(); };
+
 protected:
   std::stack<CRect> m_viewStack;
 
@@ -223,16 +271,32 @@ protected:
 private:
   void UpdateCameraPosition(const CPoint &camera);
   void UpdateFinalTransform(const TransformMatrix &matrix);
-  RESOLUTION_INFO m_windowResolution;
-  float m_guiScaleX;
-  float m_guiScaleY;
-  std::stack<CPoint> m_cameras;
-  std::stack<CPoint> m_origins;
-  std::stack<CRect>  m_clipRegions;
-
-  TransformMatrix m_guiTransform;
-  TransformMatrix m_finalTransform;
-  std::stack<TransformMatrix> m_groupTransform;
+
+  inline CGUITransformState &State() XBMC_FORCE_INLINE
+  {
+    if (m_threadStates)
+    {
+      CGUITransformState *state = m_threadState.get();
+      if (state)
+        return *state;
+    }
+    return m_state;
+  }
+  inline const CGUITransformState &State() const XBMC_FORCE_INLINE
+  {
+    return const_cast<CGraphicContext *>(this)->State();
+  }
+
+  CGUITransformState m_state;
+  mutable XbmcThreads::ThreadLocal<CGUITransformState> m_threadState;
+  volatile long m_threadStates; ///< number of threads with their own state, so the render thread can skip the lookup
+
+  // XbmcThreads::LockGate, holding off threads outside of a process pass
+  virtual bool HoldOff();
+  virtual void Wait();
+
+  volatile bool m_processPass;
+  CEvent m_processPassDone;
 
   CRect m_scissors;
 };
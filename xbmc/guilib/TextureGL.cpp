@@ -21,6 +21,7 @@
 
 #include "system.h"
 #include "TextureGL.h"
+#include "GUITexture.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -50,7 +51,13 @@ void CGLTexture::CreateTextureObject()
 void CGLTexture::DestroyTextureObject()
 {
   if (m_texture)
+  {
+#if defined(HAS_GL)
+    // the texture may still be waiting to be rendered
+    CGUITextureGL::FlushBatch();
+#endif
     glDeleteTextures(1, (GLuint*) &m_texture);
+  }
 }
 
 void CGLTexture::LoadToGPU()
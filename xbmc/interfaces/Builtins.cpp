@@ -51,6 +51,7 @@
 #include "PartyModeManager.h"
 #include "settings/Settings.h"
 #include "utils/StringUtils.h"
+#include "threads/LockProfiler.h"
 #include "utils/URIUtils.h"
 #include "Util.h"
 
@@ -206,6 +207,7 @@ const BUILT_IN commands[] = {
   { "LCD.Resume",                 false,  "Resumes LCDproc" },
 #endif
   { "VideoLibrary.Search",        false,  "Brings up a search dialog which will search the library" },
+  { "LockProfiler",               true,   "Start, stop or reset lock contention profiling, or log its report" },
 };
 
 bool CBuiltins::HasCommand(const CStdString& execString)
@@ -1560,6 +1562,28 @@ int CBuiltins::Execute(const CStdString& execString)
     CGUIMessage msg(GUI_MSG_SEARCH, 0, 0, 0);
     g_windowManager.SendMessage(msg, WINDOW_VIDEO_NAV);
   }
+  else if (execute.Equals("lockprofiler") && params.size())
+  {
+    if (params[0].Equals("start"))
+      XbmcThreads::LockProfiler::Enable(true);
+    else if (params[0].Equals("stop"))
+      XbmcThreads::LockProfiler::Enable(false);
+    else if (params[0].Equals("reset"))
+      XbmcThreads::LockProfiler::Reset();
+    else if (params[0].Equals("report"))
+    {
+      CStdStringArray lines;
+      StringUtils::SplitString(XbmcThreads::LockProfiler::GetReport(params.size() > 1 ? atoi(params[1].c_str()) : 50), "\n", lines);
+      CLog::Log(LOGNOTICE, "Lock contention, most waited on first:");
+      for (unsigned int i = 0; i < lines.size(); i++)
+      {
+        if (!lines[i].IsEmpty())
+          CLog::Log(LOGNOTICE, "%s", lines[i].c_str());
+      }
+    }
+    else
+      return -1;
+  }
   else
     return -1;
   return 0;
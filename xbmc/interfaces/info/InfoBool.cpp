@@ -35,7 +35,12 @@ InfoSingle::InfoSingle(const CStdString &expression, int context)
 
 void InfoSingle::Update(const CGUIListItem *item)
 {
-  m_value = g_infoManager.GetBool(m_condition, m_context, item);
+  m_value = Evaluate(item);
+}
+
+bool InfoSingle::Evaluate(const CGUIListItem *item)
+{
+  return g_infoManager.GetBool(m_condition, m_context, item);
 }
 
 InfoExpression::InfoExpression(const CStdString &expression, int context)
@@ -46,7 +51,14 @@ InfoExpression::InfoExpression(const CStdString &expression, int context)
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  Evaluate(item, m_value);
+  EvaluatePostfix(item, m_value);
+}
+
+bool InfoExpression::Evaluate(const CGUIListItem *item)
+{
+  bool result = false;
+  EvaluatePostfix(item, result);
+  return result;
 }
 
 #define OPERATOR_LB   5
@@ -145,11 +157,11 @@ void InfoExpression::Parse(const CStdString &expression)
 
   // test evaluate
   bool test;
-  if (!Evaluate(NULL, test))
+  if (!EvaluatePostfix(NULL, test))
     CLog::Log(LOGERROR, "Error evaluating boolean expression %s", expression.c_str());
 }
 
-bool InfoExpression::Evaluate(const CGUIListItem *item, bool &result)
+bool InfoExpression::EvaluatePostfix(const CGUIListItem *item, bool &result)
 {
   stack<bool> save;
   for (vector<short>::const_iterator it = m_postfix.begin(); it != m_postfix.end(); ++it)
@@ -74,6 +74,12 @@ public:
    */
   virtual void Update(const CGUIListItem *item) {};
 
+  /*! \brief Evaluate the info bool without touching its cached value
+   This is used by threads other than the one that owns the cache, see CGUIInfoManager::GetBoolValue()
+   \param item the item used to evaluate the bool
+   */
+  virtual bool Evaluate(const CGUIListItem *item) { return m_value; };
+
 protected:
 
   bool m_value;                ///< current value
@@ -93,6 +99,7 @@ public:
   virtual ~InfoSingle() {};
 
   virtual void Update(const CGUIListItem *item);
+  virtual bool Evaluate(const CGUIListItem *item);
 private:
   int m_condition;             ///< actual condition this represents
 };
@@ -106,9 +113,10 @@ public:
   virtual ~InfoExpression() {};
 
   virtual void Update(const CGUIListItem *item);
+  virtual bool Evaluate(const CGUIListItem *item);
 private:
   void Parse(const CStdString &expression);
-  bool Evaluate(const CGUIListItem *item, bool &result);
+  bool EvaluatePostfix(const CGUIListItem *item, bool &result);
   short GetOperator(const char ch) const;
 
   std::vector<short> m_postfix;         ///< the postfix form of the expression (operators and operand indicies)
@@ -2044,6 +2044,35 @@ namespace JSONRPC
         "\"type\": \"object\","
         "\"description\": \"List of key-value pairs of the retrieved info booleans\""
       "}"
+    "}",
+    "\"XBMC.GetLockProfile\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieve the lock contention recorded since profiling was started with the LockProfiler builtin, most waited on first\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"limit\", \"type\": \"integer\", \"minimum\": 1, \"default\": 50 }"
+      "],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"enabled\": { \"type\": \"boolean\", \"required\": true },"
+          "\"locks\": { \"type\": \"array\", \"required\": true,"
+            "\"items\": { \"type\": \"object\","
+              "\"properties\": {"
+                "\"name\": { \"type\": \"string\", \"required\": true },"
+                "\"acquisitions\": { \"type\": \"integer\", \"required\": true },"
+                "\"contended\": { \"type\": \"integer\", \"required\": true },"
+                "\"waittotal\": { \"type\": \"integer\", \"required\": true, \"description\": \"Microseconds\" },"
+                "\"waitmax\": { \"type\": \"integer\", \"required\": true },"
+                "\"holdsamples\": { \"type\": \"integer\", \"required\": true },"
+                "\"holdaverage\": { \"type\": \"integer\", \"required\": true, \"description\": \"Microseconds\" },"
+                "\"holdmax\": { \"type\": \"integer\", \"required\": true }"
+              "}"
+            "}"
+          "}"
+        "}"
+      "}"
     "}"
   };
 
@@ -25,6 +25,7 @@
 #include "Util.h"
 #include "utils/Variant.h"
 #include "powermanagement/PowerManager.h"
+#include "threads/LockProfiler.h"
 
 using namespace JSONRPC;
 
@@ -94,3 +95,29 @@ JSON_STATUS CXBMCOperations::GetInfoBooleans(const CStdString &method, ITranspor
 
   return OK;
 }
+
+JSON_STATUS CXBMCOperations::GetLockProfile(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  std::vector<XbmcThreads::LockProfiler::Entry> entries;
+  XbmcThreads::LockProfiler::GetEntries(entries);
+
+  unsigned int limit = (unsigned int)parameterObject["limit"].asUnsignedInteger();
+  result["enabled"] = XbmcThreads::LockProfiler::IsEnabled();
+  result["locks"] = CVariant(CVariant::VariantTypeArray);
+  for (unsigned int i = 0; i < entries.size() && i < limit; i++)
+  {
+    const XbmcThreads::LockStats &stats = entries[i].stats;
+    CVariant lock(CVariant::VariantTypeObject);
+    lock["name"] = entries[i].name;
+    lock["acquisitions"] = stats.acquisitions;
+    lock["contended"] = stats.contended;
+    lock["waittotal"] = stats.waitTotal;
+    lock["waitmax"] = stats.waitMax;
+    lock["holdsamples"] = stats.holdSamples;
+    lock["holdaverage"] = stats.holdSamples ? stats.holdTotal / stats.holdSamples : (uint64_t)0;
+    lock["holdmax"] = stats.holdMax;
+    result["locks"].push_back(lock);
+  }
+
+  return OK;
+}
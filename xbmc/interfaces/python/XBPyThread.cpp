@@ -67,6 +67,8 @@ XBPyThread::XBPyThread(XBPython *pExecuter, int id) : CThread("XBPyThread")
   m_threadState = NULL;
   m_id          = id;
   m_stopping    = false;
+  m_reuseInterpreter = false;
+  m_endInterpreter = true;
   m_argv        = NULL;
   m_source      = NULL;
   m_argc        = 0;
@@ -76,6 +78,7 @@ XBPyThread::~XBPyThread()
 {
   stop();
   g_pythonParser.PulseGlobalEvent();
+  m_idleWakeup.Set();
   CLog::Log(LOGDEBUG,"waiting for python thread %d to stop", m_id);
   StopThread();
   CLog::Log(LOGDEBUG,"python thread %d destructed", m_id);
@@ -135,9 +138,16 @@ void XBPyThread::Process()
 
   int m_Py_file_input = Py_file_input;
 
+  PyInterpreter interpreter;
+  bool reused = m_reuseInterpreter && addon.get() != NULL && m_pExecuter->AcquireInterpreter(addon->ID(), interpreter);
+
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state;
+  if (reused) // carry on in the interpreter on a state of our own thread, the previous one was deleted by its thread
+    state = PyThreadState_New((PyInterpreterState *)interpreter.interpreterState);
+  else
+    state = Py_NewInterpreter();
   if (!state)
   {
     PyEval_ReleaseLock();
@@ -147,8 +157,6 @@ void XBPyThread::Process()
   // swap in my thread state
   PyThreadState_Swap(state);
 
-  m_pExecuter->InitializeInterpreter(addon);
-
   CLog::Log(LOGDEBUG, "%s - The source file to load is %s", __FUNCTION__, m_source);
 
   // get path from script file name and add python path's
@@ -156,62 +164,81 @@ void XBPyThread::Process()
   CStdString scriptDir;
   URIUtils::GetDirectory(_P(m_source), scriptDir);
   URIUtils::RemoveSlashAtEnd(scriptDir);
-  CStdString path = scriptDir;
 
-  // add on any addon modules the user has installed
-  ADDON::VECADDONS addons;
-  ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
-  for (unsigned int i = 0; i < addons.size(); ++i)
-#ifdef TARGET_WINDOWS
-  {
-    CStdString strTmp(_P(addons[i]->LibPath()));
-    g_charsetConverter.utf8ToSystem(strTmp);
-    path += PY_PATH_SEP + strTmp;
+  PyObject* module = PyImport_AddModule((char*)"__main__");
+  PyObject* moduleDict = PyModule_GetDict(module);
+
+  if (reused)
+  { // the addon's modules are still loaded, so only the script itself and the abort flag need resetting
+    CLog::Log(LOGDEBUG, "%s - Reusing the interpreter of %s", __FUNCTION__, addon->ID().c_str());
+    PyDict_Clear(moduleDict);
+    PyDict_Update(moduleDict, (PyObject *)interpreter.mainDict);
+    PyObject *m = PyImport_AddModule((char*)"xbmc");
+    if(!m || PyObject_SetAttrString(m, (char*)"abortRequested", PyBool_FromLong(0)))
+      CLog::Log(LOGERROR, "Python thread: failed to reset abortRequested");
   }
+  else
+  {
+    m_pExecuter->InitializeInterpreter(addon);
+
+    CStdString path = scriptDir;
+
+    // add on any addon modules the user has installed
+    ADDON::VECADDONS addons;
+    ADDON::CAddonMgr::Get().GetAddons(ADDON::ADDON_SCRIPT_MODULE, addons);
+    for (unsigned int i = 0; i < addons.size(); ++i)
+#ifdef TARGET_WINDOWS
+    {
+      CStdString strTmp(_P(addons[i]->LibPath()));
+      g_charsetConverter.utf8ToSystem(strTmp);
+      path += PY_PATH_SEP + strTmp;
+    }
 #else
-    path += PY_PATH_SEP + _P(addons[i]->LibPath());
+      path += PY_PATH_SEP + _P(addons[i]->LibPath());
 #endif
 
-  // and add on whatever our default path is
-  path += PY_PATH_SEP;
+    // and add on whatever our default path is
+    path += PY_PATH_SEP;
 
-  // we want to use sys.path so it includes site-packages
-  // if this fails, default to using Py_GetPath
-  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
-  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
-  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
+    // we want to use sys.path so it includes site-packages
+    // if this fails, default to using Py_GetPath
+    PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
+    PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
+    PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
 
-  if( pathObj && PyList_Check(pathObj) )
-  {
-    for( int i = 0; i < PyList_Size(pathObj); i++ )
+    if( pathObj && PyList_Check(pathObj) )
     {
-      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
-      if( e && PyString_Check(e) )
+      for( int i = 0; i < PyList_Size(pathObj); i++ )
       {
-          path += PyString_AsString(e); // returns internal data, don't delete or modify
-          path += PY_PATH_SEP;
+        PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
+        if( e && PyString_Check(e) )
+        {
+            path += PyString_AsString(e); // returns internal data, don't delete or modify
+            path += PY_PATH_SEP;
+        }
       }
     }
+    else
+    {
+      path += Py_GetPath();
+    }
+    Py_DECREF(sysMod); // release ref to sysMod
+
+    CLog::Log(LOGDEBUG, "%s - Setting the Python path to %s", __FUNCTION__, path.c_str());
+
+    interpreter.path = path;
+    interpreter.mainDict = m_reuseInterpreter ? PyDict_Copy(moduleDict) : NULL;
   }
-  else
-  {
-    path += Py_GetPath();
-  }
-  Py_DECREF(sysMod); // release ref to sysMod
 
   // set current directory and python's path.
   if (m_argv != NULL)
     PySys_SetArgv(m_argc, m_argv);
 
-  CLog::Log(LOGDEBUG, "%s - Setting the Python path to %s", __FUNCTION__, path.c_str());
-
-  PySys_SetPath((char *)path.c_str());
+  // setting argv may have added to the path, so this comes after
+  PySys_SetPath((char *)interpreter.path.c_str());
 
   CLog::Log(LOGDEBUG, "%s - Entering source directory %s", __FUNCTION__, scriptDir.c_str());
 
-  PyObject* module = PyImport_AddModule((char*)"__main__");
-  PyObject* moduleDict = PyModule_GetDict(module);
-
   // when we are done initing we store thread state so we can be aborted
   PyThreadState_Swap(NULL);
   PyEval_ReleaseLock();
@@ -265,6 +292,9 @@ void XBPyThread::Process()
     }
   }
 
+  // only an interpreter that ran to completion is fit for the next run
+  bool reusable = m_reuseInterpreter && addon.get() != NULL && interpreter.mainDict && !PyErr_Occurred();
+
   if (!PyErr_Occurred())
     CLog::Log(LOGINFO, "Scriptresult: Success");
   else if (PyErr_ExceptionMatches(PyExc_SystemExit))
@@ -377,11 +407,39 @@ void XBPyThread::Process()
 
   { CSingleLock lock(m_pExecuter->m_critSection);
     m_threadState = NULL;
+    reusable = reusable && !m_stopping;
+  }
+
+  // objects taking callbacks keep hold of our thread state, so their interpreter can't be kept
+  if (m_pExecuter->ForgetCallbacks(state->interp))
+    reusable = false;
+
+  if (reusable)
+  {
+    interpreter.addonID = addon->ID();
+    interpreter.interpreterState = state->interp;
+    interpreter.owner = this;
+    if (m_pExecuter->ReleaseInterpreter(interpreter, m_id))
+    {
+      // stay around until the interpreter is taken by the next run or is to be ended,
+      //  as our thread state must be deleted on this thread.
+      m_idleWakeup.Wait();
+      if (!m_endInterpreter)
+      {
+        PyEval_AcquireLock();
+        PyThreadState_Swap(state);
+        PyThreadState_Clear(state);
+        PyThreadState_DeleteCurrent();
+        return;
+      }
+      CLog::Log(LOGDEBUG, "Python thread: ending the idle interpreter of %s", addon->ID().c_str());
+    }
   }
 
   PyEval_AcquireLock();
   PyThreadState_Swap(state);
 
+  Py_XDECREF((PyObject *)interpreter.mainDict);
   m_pExecuter->DeInitializeInterpreter();
 
   Py_EndInterpreter(state);
@@ -390,6 +448,12 @@ void XBPyThread::Process()
   PyEval_ReleaseLock();
 }
 
+void XBPyThread::handOverInterpreter()
+{
+  m_endInterpreter = false;
+  m_idleWakeup.Set();
+}
+
 void XBPyThread::OnExit()
 {
   m_pExecuter->setDone(m_id);
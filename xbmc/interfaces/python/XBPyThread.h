@@ -23,6 +23,7 @@
 #define XBPYTHREAD_H_
 
 #include "threads/Thread.h"
+#include "threads/Event.h"
 #include "addons/IAddon.h"
 
 class XBPython;
@@ -40,6 +41,17 @@ public:
 
   void setAddon(ADDON::AddonPtr _addon) { addon = _addon; }
 
+  /*! \brief Run in an interpreter left by an earlier run of the same addon, and leave ours for the next one.
+   Modules the addon imported stay loaded between runs, so only addons that don't keep
+   per-run state in them should ask for this.
+   */
+  void setReuseInterpreter(bool reuse) { m_reuseInterpreter = reuse; }
+
+  /*! \brief Wake the thread parked on an idle interpreter, leaving the interpreter to the next run.
+   Without this the thread ends the interpreter once it's deleted.
+   */
+  void handOverInterpreter();
+
 protected:
   XBPython *m_pExecuter;
   void *m_threadState;
@@ -49,6 +61,9 @@ protected:
   char **m_argv;
   unsigned int  m_argc;
   bool m_stopping;
+  bool m_reuseInterpreter;
+  bool m_endInterpreter;     // whether to end the interpreter once woken from being idle
+  CEvent m_idleWakeup;
   int  m_id;
   ADDON::AddonPtr addon;
 
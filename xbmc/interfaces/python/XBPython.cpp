@@ -41,6 +41,10 @@
 
 #include "threads/SystemClock.h"
 #include "addons/Addon.h"
+#include "settings/AdvancedSettings.h"
+
+// how long an idle interpreter is kept for the next run of its addon
+#define PY_INTERPRETER_IDLE_TIME 300000
 
 extern "C" HMODULE __stdcall dllLoadLibraryA(LPCSTR file);
 extern "C" BOOL __stdcall dllFreeLibrary(HINSTANCE hLibModule);
@@ -455,6 +459,8 @@ void XBPython::FreeResources()
       it = m_vecPyList.erase(it);
       FinalizeScript();
     }
+    lock.Leave();
+    EndIdleInterpreters(true);
   }
 }
 
@@ -473,6 +479,9 @@ void XBPython::Process()
       CLog::Log(LOGDEBUG, "%s - no profile autoexec.py (%s) found, skipping", __FUNCTION__, strAutoExecPy.c_str());
   }
 
+  if (m_bInitialized)
+    EndIdleInterpreters(false);
+
   CSingleLock lock(m_critSection);
 
   if (m_bInitialized)
@@ -490,7 +499,7 @@ void XBPython::Process()
       else ++it;
     }
 
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && m_idleInterpreters.empty() && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
       Finalize();
   }
 }
@@ -518,7 +527,7 @@ int XBPython::evalFile(const CStdString &src, ADDON::AddonPtr addon)
   return evalFile(src, argv, addon);
 }
 // execute script, returns -1 if script doesn't exist
-int XBPython::evalFile(const CStdString &src, const std::vector<CStdString> &argv, ADDON::AddonPtr addon)
+int XBPython::evalFile(const CStdString &src, const std::vector<CStdString> &argv, ADDON::AddonPtr addon, bool reuseInterpreter)
 {
   CSingleExit ex(g_graphicsContext);
   CSingleLock lock(m_critSection);
@@ -541,12 +550,14 @@ int XBPython::evalFile(const CStdString &src, const std::vector<CStdString> &arg
   XBPyThread *pyThread = new XBPyThread(this, m_nextid);
   pyThread->setArgv(argv);
   pyThread->setAddon(addon);
+  pyThread->setReuseInterpreter(reuseInterpreter && g_advancedSettings.m_pythonInterpreterPool > 0);
   pyThread->evalFile(src);
   PyElem inf;
   inf.id        = m_nextid;
   inf.bDone     = false;
   inf.strFile   = src;
   inf.pyThread  = pyThread;
+  inf.doneEvent.reset(new CEvent(true));
 
   m_vecPyList.push_back(inf);
 
@@ -566,11 +577,113 @@ void XBPython::setDone(int id)
       else
         CLog::Log(LOGINFO, "Python script stopped");
       it->bDone = true;
+      it->doneEvent->Set();
     }
     ++it;
   }
 }
 
+boost::shared_ptr<CEvent> XBPython::getDoneEvent(int scriptId)
+{
+  CSingleLock lock(m_critSection);
+  for (PyList::iterator it = m_vecPyList.begin(); it != m_vecPyList.end(); ++it)
+  {
+    if (it->id == scriptId)
+      return it->doneEvent;
+  }
+  return boost::shared_ptr<CEvent>();
+}
+
+bool XBPython::AcquireInterpreter(const CStdString &addonID, PyInterpreter &interpreter)
+{
+  bool found = false;
+  {
+    CSingleLock lock(m_critSection);
+    // most recently used first, as it's the least likely to be ended
+    for (std::vector<PyInterpreter>::reverse_iterator it = m_idleInterpreters.rbegin(); it != m_idleInterpreters.rend(); ++it)
+    {
+      if (it->addonID == addonID)
+      {
+        interpreter = *it;
+        m_idleInterpreters.erase(--(it.base()));
+        found = true;
+        break;
+      }
+    }
+  }
+  if (!found)
+    return false;
+
+  // have the previous thread drop its thread state and wait for it to go
+  interpreter.owner->handOverInterpreter();
+  delete interpreter.owner;
+  interpreter.owner = NULL;
+  return true;
+}
+
+bool XBPython::ReleaseInterpreter(const PyInterpreter &interpreter, int id)
+{
+  CSingleLock lock(m_critSection);
+  if (!m_bInitialized || g_advancedSettings.m_pythonInterpreterPool <= 0)
+    return false;
+
+  PyList::iterator it = m_vecPyList.begin();
+  while (it != m_vecPyList.end() && it->id != id)
+    ++it;
+  // a script being stopped is about to be deleted by whoever stopped it
+  if (it == m_vecPyList.end() || it->pyThread->isStopping())
+    return false;
+
+  // the thread is ours to delete from now on, and the script is done as far as anyone else is concerned
+  CLog::Log(LOGINFO, "Python script stopped");
+  it->doneEvent->Set();
+  m_vecPyList.erase(it);
+  FinalizeScript();
+
+  // any beyond the size of the pool are ended by the next Process()
+  m_idleInterpreters.push_back(interpreter);
+  m_idleInterpreters.back().idleSince = XbmcThreads::SystemClockMillis();
+  return true;
+}
+
+void XBPython::NoteCallbacks(void *interpreterState)
+{
+  CSingleLock lock(m_callbackSection);
+  m_callbackInterpreters.insert(interpreterState);
+}
+
+bool XBPython::ForgetCallbacks(void *interpreterState)
+{
+  CSingleLock lock(m_callbackSection);
+  return m_callbackInterpreters.erase(interpreterState) > 0;
+}
+
+void XBPython::EndIdleInterpreters(bool all)
+{
+  std::vector<PyInterpreter> ended;
+  {
+    CSingleLock lock(m_critSection);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    unsigned int poolSize = g_advancedSettings.m_pythonInterpreterPool;
+    unsigned int excess = m_idleInterpreters.size() > poolSize ? m_idleInterpreters.size() - poolSize : 0;
+    std::vector<PyInterpreter>::iterator it = m_idleInterpreters.begin();
+    while (it != m_idleInterpreters.end())
+    {
+      if (all || excess || now - it->idleSince > PY_INTERPRETER_IDLE_TIME)
+      {
+        ended.push_back(*it);
+        it = m_idleInterpreters.erase(it);
+        if (excess)
+          excess--;
+      }
+      else ++it;
+    }
+  }
+  // the parked threads end their interpreters as they're deleted
+  for (std::vector<PyInterpreter>::iterator it = ended.begin(); it != ended.end(); ++it)
+    delete it->owner;
+}
+
 void XBPython::stopScript(int id)
 {
   CSingleExit ex(g_graphicsContext);
@@ -709,6 +822,7 @@ int XBPython::evalString(const CStdString &src, const std::vector<CStdString> &a
   inf.bDone     = false;
   inf.strFile   = "<string>";
   inf.pyThread  = pyThread;
+  inf.doneEvent.reset(new CEvent(true));
 
   m_vecPyList.push_back(inf);
 
@@ -27,14 +27,28 @@
 #include "addons/IAddon.h"
 
 #include <vector>
+#include <set>
+#include <boost/shared_ptr.hpp>
 
 typedef struct {
   int id;
   bool bDone;
   std::string strFile;
   XBPyThread *pyThread;
+  boost::shared_ptr<CEvent> doneEvent;
 }PyElem;
 
+/*! \brief A sub-interpreter kept between runs of an addon, see XBPython::ReleaseInterpreter().
+ */
+typedef struct {
+  CStdString addonID;
+  void *interpreterState;  // the PyInterpreterState
+  void *mainDict;          // copy of __main__'s dict as it was before the first script ran
+  CStdString path;         // the module search path
+  unsigned int idleSince;
+  XBPyThread *owner;       // the thread of the last run, parked until it hands the interpreter over or ends it
+}PyInterpreter;
+
 class LibraryLoader;
 
 typedef std::vector<PyElem> PyList;
@@ -66,12 +80,49 @@ public:
   int ScriptsSize();
   int GetPythonScriptId(int scriptPosition);
   int evalFile(const CStdString &src, ADDON::AddonPtr addon);
-  int evalFile(const CStdString &src, const std::vector<CStdString> &argv, ADDON::AddonPtr addon);
+  int evalFile(const CStdString &src, const std::vector<CStdString> &argv, ADDON::AddonPtr addon, bool reuseInterpreter = false);
   int evalString(const CStdString &src, const std::vector<CStdString> &argv);
 
   bool isRunning(int scriptId);
   bool isStopping(int scriptId);
   void setDone(int id);
+
+  /*! \brief Get an event that is set once a script has finished, to wait on it rather than polling isRunning()
+   \param scriptId id of the script, as returned by evalFile()
+   \return the event, or an empty pointer if the script isn't known
+   */
+  boost::shared_ptr<CEvent> getDoneEvent(int scriptId);
+
+  /*! \brief Take an idle interpreter left by an earlier run of the addon.
+   Must be called without the python lock held.
+   \param addonID the addon to run
+   \param interpreter filled in with the interpreter if there is one
+   \return true if an interpreter was taken, false if a new one should be created
+   */
+  bool AcquireInterpreter(const CStdString &addonID, PyInterpreter &interpreter);
+
+  /*! \brief Keep the interpreter of a finished script for the next run of the same addon.
+   The script is marked done and its thread handed to the pool, where it stays parked until
+   the interpreter is taken or ended, so that the interpreter's thread state is always
+   deleted on the thread that created it. Idle interpreters are ended once there are more
+   than advancedsettings <python><interpreterpool>, or after they've been idle for a while.
+   Must be called without the python lock held.
+   \param interpreter the interpreter, with owner set to the script's thread
+   \param id id of the script
+   \return false if the interpreter can't be kept, in which case the caller should end it
+   */
+  bool ReleaseInterpreter(const PyInterpreter &interpreter, int id);
+
+  /*! \brief Note that an interpreter has objects taking callbacks from xbmc (players, windows).
+   They keep hold of a thread state of the interpreter, so it won't be kept for reuse.
+   \param interpreterState the PyInterpreterState of the objects
+   */
+  void NoteCallbacks(void *interpreterState);
+
+  /*! \brief Forget about the callbacks of an interpreter that has finished its run.
+   \return true if the interpreter had objects taking callbacks
+   */
+  bool ForgetCallbacks(void *interpreterState);
   
   /*! \brief Stop a script if it's running
    \param path path to the script
@@ -106,6 +157,11 @@ public:
 private:
   bool              FileExist(const char* strFile);
 
+  /*! \brief End idle interpreters beyond the size of the pool or that have been idle for too long
+   \param all end all idle interpreters
+   */
+  void              EndIdleInterpreters(bool all);
+
   int               m_nextid;
   void*             m_mainThreadState;
   ThreadIdentifier  m_ThreadId;
@@ -116,6 +172,9 @@ private:
 
   //Vector with list of threads used for running scripts
   PyList              m_vecPyList;
+  std::vector<PyInterpreter> m_idleInterpreters;  // oldest first
+  CCriticalSection           m_callbackSection;  // separate from m_critSection, as it's taken with the python lock held
+  std::set<void *>           m_callbackInterpreters;
   PlayerCallbackList  m_vecPlayerCallbackList;
   LibraryLoader*      m_pDll;
 
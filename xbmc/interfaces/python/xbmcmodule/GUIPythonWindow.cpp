@@ -179,6 +179,8 @@ void CGUIPythonWindow::SetCallbackWindow(void *state, void *object)
 {
   pCallbackWindow = object;
   m_threadState   = state;
+  if (state)
+    g_pythonParser.NoteCallbacks(((PyThreadState *)state)->interp);
 }
 
 void CGUIPythonWindow::WaitForActionEvent(unsigned int timeout)
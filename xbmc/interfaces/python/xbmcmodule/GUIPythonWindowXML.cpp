@@ -428,6 +428,8 @@ void CGUIPythonWindowXML::SetCallbackWindow(void *state, void *object)
 {
   pCallbackWindow = object;
   m_threadState   = state;
+  if (state)
+    g_pythonParser.NoteCallbacks(((PyThreadState *)state)->interp);
 }
 
 void CGUIPythonWindowXML::GetContextButtons(int itemNumber, CContextButtons &buttons)
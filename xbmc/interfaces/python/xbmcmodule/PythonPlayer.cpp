@@ -127,4 +127,6 @@ void CPythonPlayer::SetCallback(PyThreadState *state, PyObject *object)
   /* python lock should be held */
   m_callback = object;
   m_state    = state;
+  if (state)
+    g_pythonParser.NoteCallbacks(state->interp);
 }
@@ -45,6 +45,7 @@
 #include "pictures/Picture.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/StringUtils.h"
+#include "utils/StringPool.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -204,6 +205,8 @@ void CMusicInfoScanner::Process()
   {
     CLog::Log(LOGERROR, "MusicInfoScanner: Exception while scanning.");
   }
+  // drop the strings of the songs that have gone from the library
+  CStringPool::Trim();
   m_bRunning = false;
   if (m_pObserver)
     m_pObserver->OnFinished();
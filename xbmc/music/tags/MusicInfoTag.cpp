@@ -22,6 +22,7 @@
 #include "MusicInfoTag.h"
 #include "music/Album.h"
 #include "utils/StringUtils.h"
+#include "utils/StringPool.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/Variant.h"
 
@@ -198,7 +199,7 @@ void CMusicInfoTag::SetTitle(const CStdString& strTitle)
 
 void CMusicInfoTag::SetArtist(const CStdString& strArtist)
 {
-  m_strArtist = Trim(strArtist);
+  m_strArtist = CStringPool::Intern(Trim(strArtist));
 }
 
 void CMusicInfoTag::SetArtistId(const int iArtistId)
@@ -208,7 +209,7 @@ void CMusicInfoTag::SetArtistId(const int iArtistId)
 
 void CMusicInfoTag::SetAlbum(const CStdString& strAlbum)
 {
-  m_strAlbum = Trim(strAlbum);
+  m_strAlbum = CStringPool::Intern(Trim(strAlbum));
 }
 
 void CMusicInfoTag::SetAlbumId(const int iAlbumId)
@@ -218,12 +219,12 @@ void CMusicInfoTag::SetAlbumId(const int iAlbumId)
 
 void CMusicInfoTag::SetAlbumArtist(const CStdString& strAlbumArtist)
 {
-  m_strAlbumArtist = Trim(strAlbumArtist);
+  m_strAlbumArtist = CStringPool::Intern(Trim(strAlbumArtist));
 }
 
 void CMusicInfoTag::SetGenre(const CStdString& strGenre)
 {
-  m_strGenre = Trim(strGenre);
+  m_strGenre = CStringPool::Intern(Trim(strGenre));
 }
 
 void CMusicInfoTag::SetYear(int year)
@@ -454,6 +455,10 @@ void CMusicInfoTag::Archive(CArchive& ar)
     ar >> m_strAlbum;
     ar >> m_strAlbumArtist;
     ar >> m_strGenre;
+    m_strArtist = CStringPool::Intern(m_strArtist);
+    m_strAlbum = CStringPool::Intern(m_strAlbum);
+    m_strAlbumArtist = CStringPool::Intern(m_strAlbumArtist);
+    m_strGenre = CStringPool::Intern(m_strGenre);
     ar >> m_iDuration;
     ar >> m_iTrack;
     ar >> m_bLoaded;
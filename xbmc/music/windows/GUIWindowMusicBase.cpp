@@ -1391,3 +1391,8 @@ CStdString CGUIWindowMusicBase::GetStartFolder(const CStdString &dir)
     return "special://musicplaylists/";
   return CGUIMediaWindow::GetStartFolder(dir);
 }
+
+void CGUIWindowMusicBase::OnVisibleRange(int first, int count)
+{
+  m_musicInfoLoader.SetVisibleRange(*m_vecItems, first, count);
+}
@@ -52,6 +52,7 @@ public:
   static void SetupFanart(CFileItemList& items);
 
 protected:
+  virtual void OnVisibleRange(int first, int count);
   /*!
   \brief Will be called when an popup context menu has been asked for
   \param itemNumber List/thumb control item that has been clicked on
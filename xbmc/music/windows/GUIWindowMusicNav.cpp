@@ -859,3 +859,9 @@ CStdString CGUIWindowMusicNav::GetStartFolder(const CStdString &dir)
     return "musicdb://9/";
   return CGUIWindowMusicBase::GetStartFolder(dir);
 }
+
+void CGUIWindowMusicNav::OnVisibleRange(int first, int count)
+{
+  CGUIWindowMusicBase::OnVisibleRange(first, count);
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
@@ -40,6 +40,7 @@ public:
 
   virtual void OnPrepareFileItems(CFileItemList &items);
 protected:
+  virtual void OnVisibleRange(int first, int count);
   virtual void OnItemLoaded(CFileItem* pItem) {};
   // override base class methods
   virtual bool GetDirectory(const CStdString &strDirectory, CFileItemList &items);
@@ -423,3 +423,9 @@ void CGUIWindowMusicPlaylistEditor::OnPlaylistContext()
   if (!OnPopupMenu(-1) && item >= 0 && item < m_playlist->Size())
     m_playlist->Get(item)->Select(false);
 }
+
+void CGUIWindowMusicPlaylistEditor::OnVisibleRange(int first, int count)
+{
+  CGUIWindowMusicBase::OnVisibleRange(first, count);
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
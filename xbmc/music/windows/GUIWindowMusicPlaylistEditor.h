@@ -36,6 +36,7 @@ public:
   virtual bool OnBack(int actionID);
 
 protected:
+  virtual void OnVisibleRange(int first, int count);
   virtual void OnItemLoaded(CFileItem* pItem) {};
   virtual bool GetDirectory(const CStdString &strDirectory, CFileItemList &items);
   virtual void UpdateButtons();
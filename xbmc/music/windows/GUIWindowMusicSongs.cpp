@@ -511,3 +511,9 @@ CStdString CGUIWindowMusicSongs::GetStartFolder(const CStdString &dir)
   }
   return CGUIWindowMusicBase::GetStartFolder(dir);
 }
+
+void CGUIWindowMusicSongs::OnVisibleRange(int first, int count)
+{
+  CGUIWindowMusicBase::OnVisibleRange(first, count);
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
@@ -35,6 +35,7 @@ public:
 
   void DoScan(const CStdString &strPath);
 protected:
+  virtual void OnVisibleRange(int first, int count);
   virtual void OnItemLoaded(CFileItem* pItem) {};
   virtual bool GetDirectory(const CStdString &strDirectory, CFileItemList &items);
   virtual void UpdateButtons();
@@ -616,3 +616,8 @@ CStdString CGUIWindowPictures::GetStartFolder(const CStdString &dir)
   }
   return CGUIMediaWindow::GetStartFolder(dir);
 }
+
+void CGUIWindowPictures::OnVisibleRange(int first, int count)
+{
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
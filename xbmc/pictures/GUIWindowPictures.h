@@ -37,6 +37,7 @@ public:
   virtual void OnInitWindow();
 
 protected:
+  virtual void OnVisibleRange(int first, int count);
   virtual bool GetDirectory(const CStdString &strDirectory, CFileItemList& items);
   virtual void OnInfo(int item);
   virtual bool OnClick(int iItem);
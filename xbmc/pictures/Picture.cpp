@@ -25,6 +25,7 @@
 #include "FileItem.h"
 #include "filesystem/File.h"
 #include "filesystem/FileCurl.h"
+#include "filesystem/HTTPFetchService.h"
 #include "DllImageLib.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
@@ -45,26 +46,26 @@ bool CPicture::CacheImage(const CStdString& sourceUrl, const CStdString& destFil
   if (width > 0 && height > 0)
   {
     CLog::Log(LOGINFO, "Caching image from: %s to %s with width %i and height %i", sourceUrl.c_str(), destFile.c_str(), width, height);
-    
-    DllImageLib dll;
-    if (!dll.Load()) return false;
 
     if (URIUtils::IsInternetStream(sourceUrl, true))
     {
-      CFileCurl http;
-      CStdString data;
-      if (http.Get(sourceUrl, data))
+      std::string data;
+      bool fetched;
+      if (CHTTPFetchService::CanFetch(sourceUrl))
+        fetched = CHTTPFetchService::Get().Fetch(sourceUrl, data);
+      else
       {
-        if (!dll.CreateThumbnailFromMemory((BYTE *)data.c_str(), data.GetLength(), URIUtils::GetExtension(sourceUrl).c_str(), destFile.c_str(), width, height))
-        {
-          CLog::Log(LOGERROR, "%s Unable to create new image %s from image %s", __FUNCTION__, destFile.c_str(), sourceUrl.c_str());
-          return false;
-        }
-        return true;
+        CFileCurl http;
+        CStdString result;
+        fetched = http.Get(sourceUrl, result);
+        data = result;
       }
-      return false;
+      return fetched && CacheImageData(data, sourceUrl, destFile, width, height);
     }
 
+    DllImageLib dll;
+    if (!dll.Load()) return false;
+
     if (!dll.CreateThumbnail(sourceUrl.c_str(), destFile.c_str(), width, height, g_guiSettings.GetBool("pictures.useexifrotation")))
     {
       CLog::Log(LOGERROR, "%s Unable to create new image %s from image %s", __FUNCTION__, destFile.c_str(), sourceUrl.c_str());
@@ -79,6 +80,56 @@ bool CPicture::CacheImage(const CStdString& sourceUrl, const CStdString& destFil
   }
 }
 
+bool CPicture::CacheImageData(const std::string& data, const CStdString& sourceUrl, const CStdString& destFile, int width, int height)
+{
+  DllImageLib dll;
+  if (!dll.Load()) return false;
+
+  if (!dll.CreateThumbnailFromMemory((BYTE *)data.c_str(), data.size(), URIUtils::GetExtension(sourceUrl).c_str(), destFile.c_str(), width, height))
+  {
+    CLog::Log(LOGERROR, "%s Unable to create new image %s from image %s", __FUNCTION__, destFile.c_str(), sourceUrl.c_str());
+    return false;
+  }
+  return true;
+}
+
+unsigned int CPicture::CacheThumbs(const std::vector< std::pair<CStdString, CStdString> > &thumbs)
+{
+  // fetch the internet images in one batch, so they're downloaded concurrently
+  std::vector<CHTTPFetchRequest> requests;
+  std::vector<int> request(thumbs.size(), -1);
+  for (unsigned int i = 0; i < thumbs.size(); i++)
+  {
+    if (URIUtils::IsInternetStream(thumbs[i].first, true) && CHTTPFetchService::CanFetch(thumbs[i].first))
+    {
+      request[i] = requests.size();
+      requests.push_back(CHTTPFetchRequest(thumbs[i].first));
+    }
+  }
+  if (requests.size())
+    CHTTPFetchService::Get().Fetch(requests);
+
+  unsigned int cached = 0;
+  for (unsigned int i = 0; i < thumbs.size(); i++)
+  {
+    bool result;
+    if (request[i] < 0)
+      result = CacheThumb(thumbs[i].first, thumbs[i].second);
+    else
+    {
+      const CHTTPFetchRequest &fetched = requests[request[i]];
+      CLog::Log(LOGINFO, "Caching image from: %s to %s", fetched.m_url.c_str(), thumbs[i].second.c_str());
+      result = fetched.m_success && CacheImageData(fetched.m_data, fetched.m_url, thumbs[i].second,
+                                                   g_advancedSettings.m_thumbSize, g_advancedSettings.m_thumbSize);
+    }
+    if (result)
+      cached++;
+    else
+      CFile::Delete(thumbs[i].second);
+  }
+  return cached;
+}
+
 bool CPicture::CacheThumb(const CStdString& sourceUrl, const CStdString& destFile)
 {
   return CacheImage(sourceUrl, destFile, g_advancedSettings.m_thumbSize, g_advancedSettings.m_thumbSize);
@@ -22,6 +22,9 @@
 #include "utils/StdString.h"
 #include "utils/Job.h"
 
+#include <string>
+#include <vector>
+
 class CPicture
 {
 public:
@@ -34,8 +37,15 @@ public:
   static bool CacheThumb(const CStdString& sourceUrl, const CStdString& destFile);
   static bool CacheFanart(const CStdString& SourceUrl, const CStdString& destFile);
 
+  /*! \brief Cache a number of thumbs, downloading those on the internet together.
+   \param thumbs the source url and destination of each thumb.
+   \return the number of thumbs cached. The destinations of those that failed are deleted.
+   */
+  static unsigned int CacheThumbs(const std::vector< std::pair<CStdString, CStdString> > &thumbs);
+
 private:
   static bool CacheImage(const CStdString& sourceUrl, const CStdString& destFile, int width, int height);
+  static bool CacheImageData(const std::string& data, const CStdString& sourceUrl, const CStdString& destFile, int width, int height);
 };
 
 //this class calls CreateThumbnailFromSurface in a CJob, so a png file can be written without halting the render thread
@@ -45,6 +55,7 @@ class CThumbnailWriter : public CJob
     //WARNING: buffer is deleted from DoWork()
     CThumbnailWriter(unsigned char* buffer, int width, int height, int stride, const CStdString& thumbFile);
     bool DoWork();
+    virtual CLASS GetClass() const { return CLASS_COMPUTE; };
 
   private:
     unsigned char* m_buffer;
@@ -291,3 +291,8 @@ CStdString CGUIWindowPrograms::GetStartFolder(const CStdString &dir)
   }
   return CGUIMediaWindow::GetStartFolder(dir);
 }
+
+void CGUIWindowPrograms::OnVisibleRange(int first, int count)
+{
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
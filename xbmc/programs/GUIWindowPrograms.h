@@ -34,6 +34,7 @@ public:
   virtual ~CGUIWindowPrograms(void);
   virtual bool OnMessage(CGUIMessage& message);
 protected:
+  virtual void OnVisibleRange(int first, int count);
   virtual void OnItemLoaded(CFileItem* pItem) {};
   virtual bool Update(const CStdString& strDirectory);
   virtual bool OnPlayMedia(int iItem);
@@ -23,6 +23,7 @@
 
 #include "system.h"
 #include "GUIWindowTestPatternGL.h"
+#include "guilib/GUITexture.h"
 
 #ifdef HAS_GL
 
@@ -191,6 +192,7 @@ void CGUIWindowTestPatternGL::DrawCircle(int originX, int originY, int radius)
 
 void CGUIWindowTestPatternGL::BeginRender()
 {
+  CGUITextureGL::FlushBatch();
   glDisable(GL_TEXTURE_2D);
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
@@ -24,6 +24,7 @@
 #ifdef HAS_GL
 
 #include "guilib/GraphicContext.h"
+#include "guilib/GUITexture.h"
 #include "settings/AdvancedSettings.h"
 #include "utils/log.h"
 #include "utils/GLUtils.h"
@@ -254,6 +255,9 @@ bool CRenderSystemGL::EndRender()
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGL::FlushBatch();
+  CGUITextureGL::ResetBatchStats();
+
   return true;
 }
 
@@ -262,6 +266,8 @@ bool CRenderSystemGL::ClearBuffers(color_t color)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGL::FlushBatch();
+
   float r = GET_R(color) / 255.0f;
   float g = GET_G(color) / 255.0f;
   float b = GET_B(color) / 255.0f;
@@ -290,6 +296,8 @@ bool CRenderSystemGL::PresentRender(const CDirtyRegionList& dirty)
   if (!m_bRenderCreated)
     return false;
 
+  CGUITextureGL::FlushBatch();
+
   if (m_iVSyncMode != 0 && m_iSwapRate != 0)
   {
     int64_t curr, diff, freq;
@@ -386,6 +394,8 @@ void CRenderSystemGL::CaptureStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixMode(GL_PROJECTION);
   glPushMatrix();
   glMatrixMode(GL_TEXTURE);
@@ -405,6 +415,8 @@ void CRenderSystemGL::ApplyStateBlock()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixMode(GL_PROJECTION);
   glPopMatrix();
   glMatrixMode(GL_TEXTURE);
@@ -424,6 +436,8 @@ void CRenderSystemGL::SetCameraPosition(const CPoint &camera, int screenWidth, i
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   g_graphicsContext.BeginPaint();
 
   CPoint offset = camera - CPoint(screenWidth*0.5f, screenHeight*0.5f);
@@ -487,6 +501,8 @@ void CRenderSystemGL::ApplyHardwareTransform(const TransformMatrix &finalMatrix)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixMode(GL_MODELVIEW);
   glPushMatrix();
   GLfloat matrix[4][4];
@@ -508,6 +524,8 @@ void CRenderSystemGL::RestoreHardwareTransform()
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glMatrixMode(GL_MODELVIEW);
   glPopMatrix();
 }
@@ -577,6 +595,8 @@ void CRenderSystemGL::SetViewPort(CRect& viewPort)
   if (!m_bRenderCreated)
     return;
 
+  CGUITextureGL::FlushBatch();
+
   glScissor((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
   glViewport((GLint) viewPort.x1, (GLint) (m_height - viewPort.y1 - viewPort.Height()), (GLsizei) viewPort.Width(), (GLsizei) viewPort.Height());
 }
@@ -585,6 +605,8 @@ void CRenderSystemGL::SetScissors(const CRect &rect)
 {
   if (!m_bRenderCreated)
     return;
+
+  CGUITextureGL::FlushBatch();
   GLint x1 = MathUtils::round_int(rect.x1);
   GLint y1 = MathUtils::round_int(rect.y1);
   GLint x2 = MathUtils::round_int(rect.x2);
@@ -185,6 +185,16 @@ void CAdvancedSettings::Initialize()
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
   m_sambastatfiles = true;
+  m_sambareadahead = 256;
+
+  // file stat cache, the http based protocols are given longer as they're the slowest to query
+  static const struct { const char *protocol; StatCacheTTL ttl; } statCacheDefaults[] = {
+    { "smb",  { 30, 10 } }, { "nfs",  { 30, 10 } }, { "afp",   { 30, 10 } }, { "sftp", { 30, 10 } },
+    { "ftp",  { 30, 10 } }, { "ftps", { 30, 10 } }, { "upnp",  { 30, 10 } },
+    { "http", { 60, 30 } }, { "https",{ 60, 30 } }, { "dav",   { 60, 30 } }, { "davs", { 60, 30 } } };
+  m_statCacheTTLs.clear();
+  for (unsigned int i = 0; i < sizeof(statCacheDefaults) / sizeof(statCacheDefaults[0]); i++)
+    m_statCacheTTLs[statCacheDefaults[i].protocol] = statCacheDefaults[i].ttl;
 
   m_bHTTPDirectoryStatFilesize = false;
 
@@ -241,6 +251,12 @@ void CAdvancedSettings::Initialize()
   m_curlretries = 2;
   m_curlDisableIPV6 = false;      //Certain hardware/OS combinations have trouble
                                   //with ipv6.
+  m_curlSegments = 0;
+  m_curlSegmentSize = 1024 * 1024;
+
+  m_pythonInterpreterPool = 4;
+
+  m_addonManifestCache = true;
 
   m_fullScreen = m_startFullScreen = false;
   m_showExitButton = true;
@@ -289,6 +305,7 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 0;
   m_guiDirtyRegionNoFlipTimeout = -1;
+  m_guiParallelProcess = false;
   m_logEnableAirtunes = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
@@ -612,9 +629,15 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curllowspeedtime", m_curllowspeedtime, 1, 1000);
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
+    XMLUtils::GetInt(pElement, "curlsegments", m_curlSegments, 0, 8);
+    XMLUtils::GetInt(pElement, "curlsegmentsize", m_curlSegmentSize, 64 * 1024, 16 * 1024 * 1024);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
   }
 
+  pElement = pRootElement->FirstChildElement("python");
+  if (pElement)
+    XMLUtils::GetInt(pElement, "interpreterpool", m_pythonInterpreterPool, 0, 16);
+
   pElement = pRootElement->FirstChildElement("jsonrpc");
   if (pElement)
   {
@@ -628,6 +651,26 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pElement,  "doscodepage",   m_sambadoscodepage);
     XMLUtils::GetInt(pElement, "clienttimeout", m_sambaclienttimeout, 5, 100);
     XMLUtils::GetBoolean(pElement, "statfiles", m_sambastatfiles);
+    XMLUtils::GetInt(pElement, "readahead", m_sambareadahead, 0, 4096);
+  }
+
+  pElement = pRootElement->FirstChildElement("statcache");
+  if (pElement)
+  {
+    // <protocol name="smb" ttl="30" negativettl="10"/>, a ttl of 0 disables caching for the protocol
+    for (TiXmlElement *pProtocol = pElement->FirstChildElement("protocol"); pProtocol; pProtocol = pProtocol->NextSiblingElement("protocol"))
+    {
+      const char *name = pProtocol->Attribute("name");
+      if (!name)
+        continue;
+      StatCacheTTL ttl = { 30, 10 };
+      pProtocol->QueryIntAttribute("ttl", &ttl.ttl);
+      pProtocol->QueryIntAttribute("negativettl", &ttl.negativettl);
+      if (ttl.ttl > 0 || ttl.negativettl > 0)
+        m_statCacheTTLs[CStdString(name).ToLower()] = ttl;
+      else
+        m_statCacheTTLs.erase(CStdString(name).ToLower());
+    }
   }
 
   pElement = pRootElement->FirstChildElement("httpdirectory");
@@ -665,6 +708,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   
 
   XMLUtils::GetBoolean(pRootElement, "handlemounting", m_handleMounting);
+  XMLUtils::GetBoolean(pRootElement, "addonmanifestcache", m_addonManifestCache);
 
 #ifdef HAS_SDL
   XMLUtils::GetBoolean(pRootElement, "fullscreen", m_startFullScreen);
@@ -926,6 +970,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetInt(pElement, "nofliptimeout",             m_guiDirtyRegionNoFlipTimeout);
+    XMLUtils::GetBoolean(pElement, "parallelprocess",       m_guiParallelProcess);
   }
 
   // load in the GUISettings overrides:
@@ -21,6 +21,7 @@
  */
 
 #include <vector>
+#include <map>
 #include "utils/StdString.h"
 #include "utils/GlobalsHandling.h"
 
@@ -59,6 +60,12 @@ struct RefreshOverride
   bool  fallback;
 };
 
+struct StatCacheTTL
+{
+  int ttl;         ///< seconds to cache a file that exists
+  int negativettl; ///< seconds to cache a file that doesn't
+};
+
 typedef std::vector<TVShowRegexp> SETTINGS_TVSHOWLIST;
 
 class CAdvancedSettings
@@ -194,6 +201,9 @@ class CAdvancedSettings
     int m_sambaclienttimeout;
     CStdString m_sambadoscodepage;
     bool m_sambastatfiles;
+    int m_sambareadahead; ///< read-ahead per open file in KB, 0 to disable
+
+    std::map<CStdString, StatCacheTTL> m_statCacheTTLs; ///< by protocol, those not listed aren't cached
 
     bool m_bHTTPDirectoryStatFilesize;
 
@@ -255,6 +265,12 @@ class CAdvancedSettings
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlSegments;       // parallel range requests when streaming over http, 0 or 1 for a single connection
+    int m_curlSegmentSize;    // bytes
+
+    int m_pythonInterpreterPool;  // idle interpreters kept for addons that reuse them, 0 to never reuse
+
+    bool m_addonManifestCache;    // keep addon.xml descriptors between runs so unchanged addons aren't reread at startup
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -298,6 +314,7 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    bool m_guiParallelProcess;
 
     unsigned int m_cacheMemBufferSize;
 
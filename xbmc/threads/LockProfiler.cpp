@@ -0,0 +1,248 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/LockProfiler.h"
+#include "threads/CriticalSection.h"
+
+#include <algorithm>
+#include <map>
+#include <stdio.h>
+#include <string.h>
+
+#if   defined(TARGET_DARWIN)
+#include <CoreVideo/CVHostTime.h>
+#elif defined(TARGET_WINDOWS)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace XbmcThreads
+{
+  volatile bool LockProfiler::enabled = false;
+
+  namespace
+  {
+    /**
+     * The locks being profiled. It's guarded by the underlying mutex of
+     *  a CCriticalSection, as profiling the profiler's own lock would
+     *  recurse.
+     */
+    struct Registry
+    {
+      CCriticalSection section;
+      std::map<const void*, LockStats*> locks;
+      std::map<const void*, std::string> names;
+      unsigned int sampleInterval;
+
+      Registry() : sampleInterval(64) {}
+    };
+
+    Registry& GetRegistry()
+    {
+      // never destroyed, as locks that outlive it may still need to be forgotten
+      static Registry* registry = new Registry;
+      return *registry;
+    }
+
+    class RegistryLock
+    {
+      Registry& registry;
+    public:
+      RegistryLock(Registry& r) : registry(r) { registry.section.get_underlying().lock(); }
+      ~RegistryLock() { registry.section.get_underlying().unlock(); }
+    };
+
+    bool MoreWaited(const LockProfiler::Entry& a, const LockProfiler::Entry& b)
+    {
+      if (a.stats.waitTotal != b.stats.waitTotal)
+        return a.stats.waitTotal > b.stats.waitTotal;
+      return a.stats.contended > b.stats.contended;
+    }
+  }
+
+  uint64_t LockProfiler::Now()
+  {
+#if defined(TARGET_DARWIN)
+    return CVGetCurrentHostTime() * 1000000 / CVGetHostClockFrequency();
+#elif defined(TARGET_WINDOWS)
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER now;
+    if (!frequency.QuadPart)
+      QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+    return (uint64_t)(now.QuadPart * 1000000 / frequency.QuadPart);
+#else
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+  }
+
+  void LockProfiler::Enable(bool enable)
+  {
+    GetRegistry(); // make sure it exists before any lock needs it
+    enabled = enable;
+  }
+
+  void LockProfiler::SetSampleInterval(unsigned int sampleInterval)
+  {
+    Registry& registry = GetRegistry();
+    RegistryLock lock(registry);
+    registry.sampleInterval = sampleInterval ? sampleInterval : 1;
+  }
+
+  void LockProfiler::SetName(const void* lock, const char* name)
+  {
+    Registry& registry = GetRegistry();
+    RegistryLock l(registry);
+    registry.names[lock] = name;
+  }
+
+  void LockProfiler::Acquired(LockStats*& stats, const void* lock, uint64_t waitStart)
+  {
+    // the caller holds the lock, so we're the only one touching its stats
+    Registry& registry = GetRegistry();
+    if (!stats)
+    {
+      stats = new LockStats;
+      memset(stats, 0, sizeof(LockStats));
+      stats->lock = lock;
+      RegistryLock l(registry);
+      registry.locks[lock] = stats;
+    }
+
+    stats->acquisitions++;
+    uint64_t now = 0;
+    if (waitStart)
+    {
+      now = Now();
+      uint64_t wait = now - waitStart;
+      stats->contended++;
+      stats->waitTotal += wait;
+      if (wait > stats->waitMax)
+        stats->waitMax = wait;
+    }
+
+    if (++stats->sampleCounter >= registry.sampleInterval)
+    {
+      stats->sampleCounter = 0;
+      stats->holdStart = now ? now : Now();
+    }
+  }
+
+  void LockProfiler::Waited(LockStats*& stats, const void* lock, uint64_t waitStart)
+  {
+    // a wait for something other than the lock itself, such as the readers of a CSharedSection
+    if (!stats)
+    {
+      Acquired(stats, lock, waitStart);
+      stats->acquisitions--;
+      return;
+    }
+    uint64_t wait = Now() - waitStart;
+    stats->contended++;
+    stats->waitTotal += wait;
+    if (wait > stats->waitMax)
+      stats->waitMax = wait;
+  }
+
+  void LockProfiler::Released(LockStats* stats)
+  {
+    if (!stats->holdStart)
+      return;
+
+    uint64_t hold = Now() - stats->holdStart;
+    stats->holdStart = 0;
+    stats->holdSamples++;
+    stats->holdTotal += hold;
+    if (hold > stats->holdMax)
+      stats->holdMax = hold;
+  }
+
+  void LockProfiler::Forget(LockStats* stats, const void* lock)
+  {
+    Registry& registry = GetRegistry();
+    {
+      RegistryLock l(registry);
+      registry.locks.erase(lock);
+      registry.names.erase(lock); // another lock may come to live at the same address
+    }
+    delete stats;
+  }
+
+  void LockProfiler::GetEntries(std::vector<Entry>& entries)
+  {
+    Registry& registry = GetRegistry();
+    RegistryLock l(registry);
+    entries.clear();
+    entries.reserve(registry.locks.size());
+    for (std::map<const void*, LockStats*>::const_iterator i = registry.locks.begin(); i != registry.locks.end(); ++i)
+    {
+      Entry entry;
+      std::map<const void*, std::string>::const_iterator name = registry.names.find(i->first);
+      if (name != registry.names.end())
+        entry.name = name->second;
+      else
+      {
+        char address[32];
+        sprintf(address, "%p", i->first);
+        entry.name = address;
+      }
+      entry.stats = *i->second;
+      entries.push_back(entry);
+    }
+    std::sort(entries.begin(), entries.end(), MoreWaited);
+  }
+
+  std::string LockProfiler::GetReport(unsigned int maxEntries)
+  {
+    std::vector<Entry> entries;
+    GetEntries(entries);
+
+    std::string report = "lock                                     acquired  contended   wait ms  max wait   hold us  max hold\n";
+    for (unsigned int i = 0; i < entries.size() && i < maxEntries; i++)
+    {
+      const LockStats& stats = entries[i].stats;
+      char line[160];
+      sprintf(line, "%-40.40s %9llu %10llu %9.1f %9.1f %9llu %9llu\n", entries[i].name.c_str(),
+               (unsigned long long)stats.acquisitions, (unsigned long long)stats.contended,
+               stats.waitTotal / 1000.0, stats.waitMax / 1000.0,
+               (unsigned long long)(stats.holdSamples ? stats.holdTotal / stats.holdSamples : 0),
+               (unsigned long long)stats.holdMax);
+      report += line;
+    }
+    return report;
+  }
+
+  void LockProfiler::Reset()
+  {
+    Registry& registry = GetRegistry();
+    RegistryLock l(registry);
+    for (std::map<const void*, LockStats*>::iterator i = registry.locks.begin(); i != registry.locks.end(); ++i)
+    {
+      LockStats& stats = *i->second;
+      stats.acquisitions = stats.contended = 0;
+      stats.waitTotal = stats.waitMax = 0;
+      stats.holdSamples = stats.holdTotal = stats.holdMax = 0;
+    }
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace XbmcThreads
+{
+  /**
+   * The statistics kept for a single lock while profiling. They're only
+   *  ever updated by the thread holding the lock, so need no locking of
+   *  their own.
+   */
+  struct LockStats
+  {
+    const void* lock;
+    uint64_t acquisitions;  // outermost acquisitions
+    uint64_t contended;     // acquisitions that had to wait
+    uint64_t waitTotal;     // microseconds
+    uint64_t waitMax;
+    uint64_t holdSamples;   // acquisitions whose hold time was measured
+    uint64_t holdTotal;     // microseconds
+    uint64_t holdMax;
+    uint64_t holdStart;     // when the current hold started, if it's being measured
+    unsigned int sampleCounter;
+  };
+
+  /**
+   * An opt-in profiler of the contention on CCriticalSection (and so on the
+   *  CSharedSection built on it).
+   *
+   * While it's enabled every lock records how often it's taken, how often
+   *  and for how long threads wait for it, and - for every Nth acquisition,
+   *  to keep the cost of reading the clock down - for how long it's held.
+   *  A hold includes any time spent waiting on a condition with the lock.
+   *
+   * When it's disabled the cost to each lock is a test of a flag.
+   *
+   * Locks are identified by address unless they've been given a name with
+   *  their set_name(), so the locks of interest should be named. A lock's name
+   *  and statistics are forgotten when it's destroyed.
+   *
+   * The recursion count of a lock is left alone while a thread waits on a
+   *  ConditionVariable with it, so an acquisition by another thread during
+   *  the wait isn't taken for an outermost one: it isn't counted, nor is its
+   *  hold measured, and any wait for it is missed.
+   */
+  class LockProfiler
+  {
+  public:
+    struct Entry
+    {
+      std::string name;
+      LockStats stats;
+    };
+
+    static volatile bool enabled;
+
+    static void Enable(bool enable);
+    static bool IsEnabled() { return enabled; }
+
+    /**
+     * Measure the hold time of one in every sampleInterval acquisitions
+     *  of each lock. Defaults to 64.
+     */
+    static void SetSampleInterval(unsigned int sampleInterval);
+
+    // called by the lockables' set_name()
+    static void SetName(const void* lock, const char* name);
+
+    /**
+     * Get the statistics of every lock taken while profiling, most waited
+     *  on first. As the statistics are updated without locking, those of
+     *  locks in use are approximate.
+     */
+    static void GetEntries(std::vector<Entry>& entries);
+
+    /**
+     * A ranked report of the first maxEntries of GetEntries(), one line per lock.
+     */
+    static std::string GetReport(unsigned int maxEntries = 50);
+
+    static void Reset();
+
+    // called by the lockables
+    static uint64_t Now();
+    static void Acquired(LockStats*& stats, const void* lock, uint64_t waitStart);
+    static void Waited(LockStats*& stats, const void* lock, uint64_t waitStart);
+    static void Released(LockStats* stats);
+    static void Forget(LockStats* stats, const void* lock);
+  };
+}
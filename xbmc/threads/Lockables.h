@@ -22,10 +22,32 @@
 #pragma once
 
 #include "threads/Helpers.h"
+#include "threads/LockProfiler.h"
 
 namespace XbmcThreads
 {
 
+  /**
+   * A gate that the outermost acquisition of a lock by a thread has to pass,
+   *  see CountingLockable::set_gate(). It's consulted with the lock held.
+   */
+  class LockGate
+  {
+  public:
+    virtual ~LockGate() {}
+
+    /**
+     * Whether the calling thread, which has just taken the lock, has to let go
+     *  of it again and Wait().
+     */
+    virtual bool HoldOff() = 0;
+
+    /**
+     * Wait for the gate to open. Called without the lock.
+     */
+    virtual void Wait() = 0;
+  };
+
   /**
    * This template will take any implementation of the "Lockable" concept
    * and allow it to be used as an "Exitable Lockable."
@@ -52,14 +74,72 @@ namespace XbmcThreads
   protected:
     L mutex;
     unsigned int count;
+    LockStats* stats; // only allocated once the lock is taken while profiling
+    LockGate* gate;
+    bool named;       // so its name is forgotten with it, even if it was never profiled
+
+    inline void acquire() { if (LockProfiler::enabled) profiled_lock(); else { mutex.lock(); count++; } }
+
+    void pass_gate()
+    {
+      while (gate->HoldOff())
+      {
+        unlock();
+        gate->Wait();
+        acquire();
+      }
+    }
+
+    inline void profiled_lock()
+    {
+      if (mutex.try_lock())
+      {
+        if (++count == 1)
+          LockProfiler::Acquired(stats, this, 0);
+        return;
+      }
+      uint64_t start = LockProfiler::Now();
+      mutex.lock();
+      count++;
+      LockProfiler::Acquired(stats, this, start);
+    }
 
   public:
-    inline CountingLockable() : count(0) {}
+    inline CountingLockable() : count(0), stats(NULL), gate(NULL), named(false) {}
+    inline ~CountingLockable() { if (stats || named) LockProfiler::Forget(stats, this); }
 
     // boost::thread Lockable concept
-    inline void lock() { mutex.lock(); count++; }
-    inline bool try_lock() { return mutex.try_lock() ? count++, true : false; }
-    inline void unlock() { count--; mutex.unlock(); }
+    inline void lock() { acquire(); if (gate && count == 1) pass_gate(); }
+    inline bool try_lock()
+    {
+      if (!mutex.try_lock())
+        return false;
+      if (++count == 1 && gate && gate->HoldOff())
+      {
+        unlock();
+        return false;
+      }
+      return true;
+    }
+    inline void unlock() { if (--count == 0 && stats) LockProfiler::Released(stats); mutex.unlock(); }
+
+    /**
+     * Record a wait made while holding the lock for something the lock
+     *  guards, such as CSharedSection waiting for its readers to leave.
+     */
+    inline void profile_wait(uint64_t start) { if (start) LockProfiler::Waited(stats, this, start); }
+
+    /**
+     * Name the lock in the reports of the LockProfiler.
+     */
+    inline void set_name(const char* name) { named = true; LockProfiler::SetName(this, name); }
+
+    /**
+     * Have every outermost lock() and try_lock() pass the given gate. A wait on
+     *  a ConditionVariable takes the lock back without it. Set it before the
+     *  lock is shared between threads.
+     */
+    inline void set_gate(LockGate* g) { gate = g; }
 
     /**
      * This implements the "exitable" behavior mentioned above.
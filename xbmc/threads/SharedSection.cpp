@@ -0,0 +1,171 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/SharedSection.h"
+#include "threads/Atomics.h"
+#include "threads/ThreadLocal.h"
+
+#include <stdint.h>
+
+// The stripe of each thread + 1, 0 until it's been given one.
+static XbmcThreads::ThreadLocal<void> readerStripe;
+static volatile long nextStripe = 0;
+
+static inline unsigned int GetReaderStripe(unsigned int stripes)
+{
+  intptr_t stripe = (intptr_t)readerStripe.get();
+  if (!stripe)
+  { // hand the stripes out in turn, so the first threads in get one each
+    stripe = (intptr_t)(AtomicIncrement(&nextStripe) % stripes) + 1;
+    readerStripe.set((void*)stripe);
+  }
+  return (unsigned int)(stripe - 1);
+}
+
+CSharedSection::CSharedSection() : writers(0), drained(0), writerDepth(0)
+{
+  stripes = (Stripe*)(((uintptr_t)stripeStorage + CACHE_LINE - 1) & ~(uintptr_t)(CACHE_LINE - 1));
+  for (unsigned int i = 0; i < STRIPES; i++)
+    stripes[i].readers = 0;
+}
+
+long CSharedSection::readerCount() const
+{
+  long count = 0;
+  for (unsigned int i = 0; i < STRIPES; i++)
+    count += stripes[i].readers;
+  return count;
+}
+
+bool CSharedSection::tryDrain()
+{
+  if (readerCount())
+    return false;
+
+  // readers already holding a shared lock may still get past us until we
+  //  say we're in, so look again once we have.
+  AtomicIncrement(&drained);
+  if (readerCount())
+  {
+    AtomicDecrement(&drained);
+    return false;
+  }
+  return true;
+}
+
+void CSharedSection::wakeWriter()
+{
+  CSingleLock l(drainSection);
+  drainCv.notifyAll();
+}
+
+void CSharedSection::lock()
+{
+  sec.lock();
+  if (writerDepth++)
+    return;
+
+  AtomicIncrement(&writers);
+  if (tryDrain())
+    return;
+
+  uint64_t start = XbmcThreads::LockProfiler::enabled ? XbmcThreads::LockProfiler::Now() : 0;
+  {
+    CSingleLock l(drainSection);
+    while (!tryDrain())
+      drainCv.wait(l);
+  }
+  sec.profile_wait(start);
+}
+
+bool CSharedSection::try_lock()
+{
+  if (!sec.try_lock())
+    return false;
+  if (writerDepth++)
+    return true;
+
+  AtomicIncrement(&writers);
+  if (tryDrain())
+    return true;
+
+  writerDepth = 0;
+  AtomicDecrement(&writers);
+  sec.unlock();
+  return false;
+}
+
+void CSharedSection::unlock()
+{
+  if (--writerDepth == 0)
+  {
+    // readers that see drained without writers simply come in, so writers goes first
+    AtomicDecrement(&writers);
+    AtomicDecrement(&drained);
+  }
+  sec.unlock();
+}
+
+void CSharedSection::lock_shared()
+{
+  volatile long& readers = stripes[GetReaderStripe(STRIPES)].readers;
+  intptr_t held = (intptr_t)holds.get();
+
+  AtomicIncrement(&readers);
+  if (writers && (!held || drained))
+  {
+    // queue behind the writer. Once we have sec no writer can be waiting on
+    //  the readers, and sec is recursive so the writer itself gets through.
+    AtomicDecrement(&readers);
+    wakeWriter();
+    CSingleLock l(sec);
+    AtomicIncrement(&readers);
+  }
+  holds.set((void*)(held + 1));
+}
+
+bool CSharedSection::try_lock_shared()
+{
+  volatile long& readers = stripes[GetReaderStripe(STRIPES)].readers;
+  intptr_t held = (intptr_t)holds.get();
+
+  AtomicIncrement(&readers);
+  if (writers && (!held || drained))
+  {
+    AtomicDecrement(&readers);
+    wakeWriter();
+    // the writer may have just left, or be this thread
+    CSingleTryLock l(sec);
+    if (!l.IsOwner())
+      return false;
+    AtomicIncrement(&readers);
+  }
+  holds.set((void*)(held + 1));
+  return true;
+}
+
+void CSharedSection::unlock_shared()
+{
+  AtomicDecrement(&stripes[GetReaderStripe(STRIPES)].readers);
+  holds.set((void*)((intptr_t)holds.get() - 1));
+  if (writers)
+    wakeWriter();
+}
@@ -24,28 +24,65 @@
 #include "threads/Condition.h"
 #include "threads/SingleLock.h"
 #include "threads/Helpers.h"
+#include "threads/ThreadLocal.h"
 
 /**
  * A CSharedSection is a mutex that satisfies the Shared Lockable concept (see Lockables.h).
+ *
+ * Readers are counted on one of several cacheline sized stripes, picked per
+ *  thread, so readers on different threads don't contend with each other.
+ *  The inner CCriticalSection is only taken by writers, and by readers that
+ *  arrive while a writer waits for or holds the section.
+ *
+ * Writers are preferred: once a writer is waiting, new readers queue behind
+ *  it rather than keeping it out indefinitely. The exceptions are a thread
+ *  that already holds a shared lock on this section, which is let in past a
+ *  waiting writer so that recursive shared locks can't deadlock, and the
+ *  writer itself, which may take shared locks on the section it holds
+ *  exclusively.
+ *
+ * A shared lock must be released by the thread that took it.
  */
 class CSharedSection
 {
-  CCriticalSection sec;
-  XbmcThreads::ConditionVariable actualCv;
-  XbmcThreads::TightConditionVariable<XbmcThreads::InversePredicate<unsigned int&> > cond;
+  static const unsigned int STRIPES = 8;
+  static const unsigned int CACHE_LINE = 64;
+
+  struct Stripe
+  {
+    volatile long readers;
+    char padding[CACHE_LINE - sizeof(long)];
+  };
+
+  char stripeStorage[(STRIPES + 1) * CACHE_LINE]; // room to line the stripes up on a cacheline
+  Stripe* stripes;
 
-  unsigned int sharedCount;
+  XbmcThreads::ThreadLocal<void> holds; // the number of shared locks each thread holds on the section
+
+  volatile long writers;      // nonzero while a writer waits for or holds the section
+  volatile long drained;      // nonzero once the writer has the section to itself
+  char padding[CACHE_LINE - 2 * sizeof(long)];
+
+  CCriticalSection sec;       // held by the writer for as long as it waits or holds the section
+  unsigned int writerDepth;   // recursion of the writer, only touched while holding sec
+
+  CCriticalSection drainSection;
+  XbmcThreads::ConditionVariable drainCv;
+
+  long readerCount() const;
+  bool tryDrain();
+  void wakeWriter();
 
 public:
-  inline CSharedSection() : cond(actualCv,XbmcThreads::InversePredicate<unsigned int&>(sharedCount)), sharedCount(0)  {}
+  CSharedSection();
 
-  inline void lock() { CSingleLock l(sec); if (sharedCount) cond.wait(l); sec.lock(); }
-  inline bool try_lock() { return (sec.try_lock() ? ((sharedCount == 0) ? true : (sec.unlock(), false)) : false); }
-  inline void unlock() { sec.unlock(); }
+  void lock();
+  bool try_lock();
+  void unlock();
 
-  inline void lock_shared() { CSingleLock l(sec); sharedCount++; }
-  inline bool try_lock_shared() { return (sec.try_lock() ? sharedCount++, sec.unlock(), true : false); }
-  inline void unlock_shared() { CSingleLock l(sec); sharedCount--; if (!sharedCount) { cond.notifyAll(); } }
+  void lock_shared();
+  bool try_lock_shared();
+  void unlock_shared();
 };
 
 class CSharedLock : public XbmcThreads::SharedLock<CSharedSection>
@@ -69,4 +106,3 @@ public:
   inline void Leave() { unlock(); }
   inline void Enter() { lock(); }
 };
-
@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "threads/LockProfiler.h"
+#include "threads/SingleLock.h"
+#include "threads/Atomics.h"
+#include "threads/test/TestHelpers.h"
+
+using namespace XbmcThreads;
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+class lock_taker
+{
+  CCriticalSection& sec;
+  volatile long* mutex;
+public:
+  volatile bool obtainedlock;
+
+  inline lock_taker(CCriticalSection& o, volatile long* mutex_) : sec(o), mutex(mutex_), obtainedlock(false) {}
+
+  void operator()()
+  {
+    AtomicGuard g(mutex);
+    CSingleLock lock(sec);
+    obtainedlock = true;
+  }
+};
+
+static bool findEntry(const char* name, LockProfiler::Entry& found)
+{
+  std::vector<LockProfiler::Entry> entries;
+  LockProfiler::GetEntries(entries);
+  for (unsigned int i = 0; i < entries.size(); i++)
+  {
+    if (entries[i].name == name)
+    {
+      found = entries[i];
+      return true;
+    }
+  }
+  return false;
+}
+
+// microseconds for count uncontended lock/unlock pairs
+static uint64_t timeLocks(CCriticalSection& sec, unsigned int count)
+{
+  uint64_t start = LockProfiler::Now();
+  for (unsigned int i = 0; i < count; i++)
+  {
+    CSingleLock lock(sec);
+  }
+  return LockProfiler::Now() - start;
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestProfileContention)
+{
+  CCriticalSection sec;
+  sec.set_name("TestProfileContention");
+  LockProfiler::Enable(true);
+
+  volatile long mutex = 0;
+  lock_taker taker(sec, &mutex);
+  {
+    CSingleLock lock(sec);
+    boost::thread waitThread(boost::ref(taker));
+    BOOST_CHECK(waitForThread(mutex, 1, 10000));
+    Sleep(20);
+    BOOST_CHECK(!taker.obtainedlock);
+    lock.Leave();
+    BOOST_CHECK(waitThread.timed_join(BOOST_MILLIS(10000)));
+  }
+  BOOST_CHECK(taker.obtainedlock);
+
+  LockProfiler::Entry entry;
+  BOOST_CHECK(findEntry("TestProfileContention", entry));
+  BOOST_CHECK_EQUAL(entry.stats.acquisitions, 2U);
+  BOOST_CHECK_EQUAL(entry.stats.contended, 1U);
+  BOOST_CHECK(entry.stats.waitTotal >= 10000);
+  BOOST_CHECK(entry.stats.waitMax == entry.stats.waitTotal);
+
+  LockProfiler::Enable(false);
+}
+
+BOOST_AUTO_TEST_CASE(TestProfileRecursion)
+{
+  CCriticalSection sec;
+  sec.set_name("TestProfileRecursion");
+  LockProfiler::SetSampleInterval(1);
+  LockProfiler::Enable(true);
+  {
+    CSingleLock l1(sec);
+    CSingleLock l2(sec);
+    CSingleLock l3(sec);
+  }
+  LockProfiler::Enable(false);
+  LockProfiler::SetSampleInterval(64);
+
+  // only the outermost lock counts, and is held until the last leaves
+  LockProfiler::Entry entry;
+  BOOST_CHECK(findEntry("TestProfileRecursion", entry));
+  BOOST_CHECK_EQUAL(entry.stats.acquisitions, 1U);
+  BOOST_CHECK_EQUAL(entry.stats.contended, 0U);
+  BOOST_CHECK_EQUAL(entry.stats.holdSamples, 1U);
+  BOOST_CHECK_EQUAL(entry.stats.holdStart, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(TestProfilerOverhead)
+{
+  static const unsigned int count = 1000000;
+  CCriticalSection sec;
+  sec.set_name("TestProfilerOverhead");
+
+  uint64_t disabled = timeLocks(sec, count);
+  LockProfiler::Enable(true);
+  uint64_t enabled = timeLocks(sec, count);
+  LockProfiler::Enable(false);
+
+  BOOST_TEST_MESSAGE(count << " uncontended locks took " << disabled << "us unprofiled, " << enabled << "us profiled");
+
+  LockProfiler::Entry entry;
+  BOOST_CHECK(findEntry("TestProfilerOverhead", entry));
+  BOOST_CHECK_EQUAL(entry.stats.acquisitions, (uint64_t)count);
+  BOOST_CHECK_EQUAL(entry.stats.holdSamples, (uint64_t)count / 64);
+
+  // profiling reads the clock for one in 64 locks, so an uncontended lock
+  // should stay well under a microsecond on anything we run on
+  BOOST_CHECK(enabled < (uint64_t)count);
+  // and not profiling is no more than a test of a flag
+  BOOST_CHECK(disabled < (uint64_t)count);
+}
@@ -28,6 +28,7 @@
 #include "threads/test/TestHelpers.h"
 
 #include <stdio.h>
+#include <vector>
 
 //=============================================================================
 // Helper classes
@@ -62,6 +63,34 @@ public:
   }
 };
 
+// takes a shared lock, waits for go, and then takes another one on top of it
+class nestedLocker
+{
+  CSharedSection& sec;
+  CEvent& go;
+  CEvent& wait;
+
+  volatile long* mutex;
+public:
+  volatile bool haslock;
+  volatile bool obtainedlock;
+
+  inline nestedLocker(CSharedSection& o, volatile long* mutex_, CEvent& go_, CEvent& wait_) :
+    sec(o), go(go_), wait(wait_), mutex(mutex_), haslock(false), obtainedlock(false) {}
+
+  void operator()()
+  {
+    CSharedLock outer(sec);
+    AtomicGuard g(mutex);
+    go.Wait();
+    CSharedLock inner(sec);
+    haslock = true;
+    obtainedlock = true;
+    wait.Wait();
+    haslock = false;
+  }
+};
+
 BOOST_AUTO_TEST_CASE(TestCritSectionCase)
 {
   CCriticalSection sec;
@@ -81,26 +110,30 @@ BOOST_AUTO_TEST_CASE(TestSharedSectionCase)
 BOOST_AUTO_TEST_CASE(TestGetSharedLockWhileTryingExclusiveLock)
 {
   volatile long mutex = 0;
+  CEvent go;
   CEvent event;
 
   CSharedSection sec;
 
   CSharedLock l1(sec); // get a shared lock
 
+  // a thread that already holds a shared lock when the exclusive lock is tried
+  nestedLocker l3(sec,&mutex,go,event);
+  boost::thread waitThread3(boost::ref(l3));
+  BOOST_CHECK(waitForThread(mutex,1,10000));
+
   locker<CExclusiveLock> l2(sec,&mutex);
   boost::thread waitThread1(boost::ref(l2)); // try to get an exclusive lock
 
-  BOOST_CHECK(waitForThread(mutex,1,10000));
+  BOOST_CHECK(waitForThread(mutex,2,10000));
   Sleep(10);  // still need to give it a chance to move ahead
 
   BOOST_CHECK(!l2.haslock);  // this thread is waiting ...
   BOOST_CHECK(!l2.obtainedlock);  // this thread is waiting ...
 
-  // now try and get a SharedLock
-  locker<CSharedLock> l3(sec,&mutex,&event);
-  boost::thread waitThread3(boost::ref(l3)); // try to get a shared lock
-  BOOST_CHECK(waitForThread(mutex,2,10000));
-  Sleep(10);
+  // now it takes another SharedLock, which isn't held up by the waiting exclusive lock
+  go.Set();
+  BOOST_CHECK(waitForWaiters(event,1,10000));
   BOOST_CHECK(l3.haslock);
 
   event.Set();
@@ -122,6 +155,118 @@ BOOST_AUTO_TEST_CASE(TestGetSharedLockWhileTryingExclusiveLock)
   BOOST_CHECK(!l2.haslock);  // ... but it doesn't have it anymore
 }
 
+BOOST_AUTO_TEST_CASE(TestSharedLockWaitsForWaitingExclusiveLock)
+{
+  volatile long mutex = 0;
+  CEvent event;
+
+  CSharedSection sec;
+
+  CSharedLock l1(sec); // get a shared lock
+
+  locker<CExclusiveLock> l2(sec,&mutex);
+  boost::thread waitThread1(boost::ref(l2)); // try to get an exclusive lock
+
+  BOOST_CHECK(waitForThread(mutex,1,10000));
+  Sleep(10);  // still need to give it a chance to move ahead
+
+  BOOST_CHECK(!l2.haslock);  // this thread is waiting ...
+  BOOST_CHECK(!l2.obtainedlock);  // this thread is waiting ...
+
+  // now try and get a SharedLock
+  locker<CSharedLock> l3(sec,&mutex,&event);
+  boost::thread waitThread3(boost::ref(l3)); // try to get a shared lock
+  BOOST_CHECK(waitForThread(mutex,2,10000));
+  Sleep(10);
+
+  // writers are preferred, so it queues behind the exclusive lock
+  BOOST_CHECK(!l3.obtainedlock);
+  BOOST_CHECK(!l2.obtainedlock);
+
+  // but a thread that already holds a shared lock isn't held up
+  {
+    CSharedLock l4(sec);
+    BOOST_CHECK(l4.IsOwner());
+  }
+
+  // let it go
+  l1.Leave(); // the last shared lock leaves.
+
+  BOOST_CHECK(waitThread1.timed_join(BOOST_MILLIS(10000)));
+
+  BOOST_CHECK(l2.obtainedlock);  // the exclusive lock was captured
+  BOOST_CHECK(!l2.haslock);  // ... but it doesn't have it anymore
+
+  // and then the shared lock
+  BOOST_CHECK(waitForWaiters(event,1,10000));
+  BOOST_CHECK(l3.haslock);
+
+  event.Set();
+  BOOST_CHECK(waitThread3.timed_join(BOOST_MILLIS(10000)));
+  BOOST_CHECK(!l3.haslock);
+}
+
+BOOST_AUTO_TEST_CASE(TestSharedLockOnOtherSectionWaitsForExclusiveLock)
+{
+  volatile long mutex = 0;
+  CEvent event;
+
+  CSharedSection other;
+  CSharedSection sec;
+
+  locker<CSharedLock> l1(sec,&mutex,&event);
+  boost::thread waitThread1(boost::ref(l1)); // another thread holds a shared lock
+  BOOST_CHECK(waitForWaiters(event,1,10000));
+
+  locker<CExclusiveLock> l2(sec,&mutex);
+  boost::thread waitThread2(boost::ref(l2)); // try to get an exclusive lock
+
+  BOOST_CHECK(waitForThread(mutex,2,10000));
+  Sleep(10);
+  BOOST_CHECK(!l2.obtainedlock);
+
+  // holding a shared lock on another section doesn't let a thread past the writer
+  {
+    CSharedLock held(other);
+    BOOST_CHECK(!sec.try_lock_shared());
+  }
+
+  event.Set();
+  BOOST_CHECK(waitThread1.timed_join(BOOST_MILLIS(10000)));
+  BOOST_CHECK(waitThread2.timed_join(BOOST_MILLIS(10000)));
+  BOOST_CHECK(l2.obtainedlock);
+}
+
+BOOST_AUTO_TEST_CASE(TestSharedLockWhileExclusive)
+{
+  CSharedSection sec;
+
+  // the owner of the exclusive lock can also take shared locks
+  CExclusiveLock l1(sec);
+  CExclusiveLock l2(sec);
+  CSharedLock l3(sec);
+  BOOST_CHECK(l3.IsOwner());
+  BOOST_CHECK(sec.try_lock_shared());
+  sec.unlock_shared();
+}
+
+BOOST_AUTO_TEST_CASE(TestTryLocks)
+{
+  CSharedSection sec;
+
+  {
+    CSharedLock l1(sec);
+    BOOST_CHECK(!sec.try_lock());
+    BOOST_CHECK(sec.try_lock_shared());
+    sec.unlock_shared();
+  }
+
+  BOOST_CHECK(sec.try_lock());
+  BOOST_CHECK(sec.try_lock());
+  sec.unlock();
+  sec.unlock();
+}
+
 BOOST_AUTO_TEST_CASE(TestSharedSection2Case)
 {
   CSharedSection sec;
@@ -225,3 +370,139 @@ BOOST_AUTO_TEST_CASE(TestMultipleSharedSectionCase)
   }
 }
 
+
+//=============================================================================
+// Contention
+//=============================================================================
+
+struct guarded_pair
+{
+  CSharedSection sec;
+  volatile long first;
+  volatile long second;
+  volatile bool stop;
+  guarded_pair() : first(0), second(0), stop(false) {}
+};
+
+class reader
+{
+  guarded_pair& data;
+public:
+  long reads;
+  long torn; // reads that saw a writer half way through
+
+  inline reader(guarded_pair& d) : data(d), reads(0), torn(0) {}
+
+  void operator()()
+  {
+    while (!data.stop)
+    {
+      CSharedLock lock(data.sec);
+      if (data.first != data.second)
+        torn++;
+      if ((reads & 15) == 0)
+      { // shared locks are recursive, even with a writer waiting
+        CSharedLock nested(data.sec);
+        if (data.first != data.second)
+          torn++;
+      }
+      reads++;
+    }
+  }
+};
+
+class writer
+{
+  guarded_pair& data;
+  int writes;
+public:
+  uint64_t waitTotal; // microseconds
+  uint64_t waitMax;
+
+  inline writer(guarded_pair& d, int w) : data(d), writes(w), waitTotal(0), waitMax(0) {}
+
+  void operator()()
+  {
+    for (int i = 0; i < writes; i++)
+    {
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      CExclusiveLock lock(data.sec);
+      uint64_t wait = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds();
+      waitTotal += wait;
+      if (wait > waitMax)
+        waitMax = wait;
+
+      data.first++;
+      Sleep(0);
+      data.second++;
+      lock.Leave();
+      Sleep(1);
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(TestReaderThroughput)
+{
+  static const int threads = 4;
+  static const int millis = 200;
+
+  guarded_pair data;
+  std::vector<reader*> readers;
+  boost::thread_group group;
+  for (int i = 0; i < threads; i++)
+  {
+    readers.push_back(new reader(data));
+    group.create_thread(boost::ref(*readers.back()));
+  }
+  Sleep(millis);
+  data.stop = true;
+  group.join_all();
+
+  long reads = 0;
+  for (int i = 0; i < threads; i++)
+  {
+    BOOST_CHECK(readers[i]->reads > 0);
+    reads += readers[i]->reads;
+    delete readers[i];
+  }
+  BOOST_TEST_MESSAGE(threads << " readers took " << reads << " shared locks in " << millis << "ms");
+}
+
+BOOST_AUTO_TEST_CASE(TestWriterLatencyUnderContention)
+{
+  static const int threads = 4;
+  static const int writes = 200;
+
+  guarded_pair data;
+  std::vector<reader*> readers;
+  boost::thread_group group;
+  for (int i = 0; i < threads; i++)
+  {
+    readers.push_back(new reader(data));
+    group.create_thread(boost::ref(*readers.back()));
+  }
+
+  // with readers continually coming in, the writer only gets in because it's preferred
+  writer w(data, writes);
+  boost::thread writerThread(boost::ref(w));
+  BOOST_CHECK(writerThread.timed_join(BOOST_MILLIS(30000)));
+  data.stop = true;
+  group.join_all();
+
+  long reads = 0;
+  long torn = 0;
+  for (int i = 0; i < threads; i++)
+  {
+    reads += readers[i]->reads;
+    torn += readers[i]->torn;
+    delete readers[i];
+  }
+  BOOST_TEST_MESSAGE(threads << " readers took " << reads << " shared locks around " << writes << " exclusive locks, which waited "
+                     << w.waitTotal / writes << "us on average and " << w.waitMax << "us at most");
+
+  BOOST_CHECK_EQUAL(data.first, (long)writes);
+  BOOST_CHECK_EQUAL(data.second, (long)writes);
+  BOOST_CHECK_EQUAL(torn, 0);
+  BOOST_CHECK(reads > 0);
+  BOOST_CHECK(w.waitMax < 1000000);
+}
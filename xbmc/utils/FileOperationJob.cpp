@@ -30,6 +30,9 @@
 #include "Util.h"
 #include "URIUtils.h"
 #include "guilib/LocalizeStrings.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "utils/Stopwatch.h"
 #ifdef HAS_FILESYSTEM_RAR
 #include "filesystem/RarManager.h"
 #endif
@@ -37,12 +40,24 @@
 using namespace std;
 using namespace XFILE;
 
+struct DataHolder
+{
+  CFileOperationJob *base;
+  double current;
+  double opWeight;
+  long *percent;            ///< set when run concurrently, the progress is then reported by the job
+  CCriticalSection *section; ///< guarding percent, which the job reads
+  volatile bool *cancelled;
+};
+
 CFileOperationJob::CFileOperationJob()
 {
+  m_concurrentCopies = 1;
 }
 
 CFileOperationJob::CFileOperationJob(FileAction action, CFileItemList & items, const CStdString& strDestFile)
 {
+  m_concurrentCopies = 1;
   SetFileOperation(action, items, strDestFile);
 }
 
@@ -67,12 +82,126 @@ bool CFileOperationJob::DoWork()
   double opWeight = 100.0 / totalTime;
   double current = 0.0;
 
-  for (unsigned int i = 0; i < size && success; i++)
-    success &= ops[i].ExecuteOperation(this, current, opWeight);
+  for (unsigned int i = 0; i < size && success;)
+  {
+    unsigned int last = i;
+    if (m_concurrentCopies > 1)
+    {
+      while (last < size && ops[last].IsCopy())
+        last++;
+    }
+
+    if (last - i > 1)
+    {
+      success &= ExecuteConcurrently(ops, i, last, current, opWeight);
+      i = last;
+    }
+    else
+      success &= ops[i++].ExecuteOperation(this, current, opWeight);
+  }
 
   return success;
 }
 
+bool CFileOperationJob::ExecuteConcurrently(FileOperationList &ops, unsigned int first, unsigned int last, double &current, double opWeight)
+{
+  CConcurrentCopy copy(this, ops, first, last);
+  m_currentOperation = g_localizeStrings.Get(115);
+
+  unsigned int count = std::min(m_concurrentCopies, last - first);
+  vector<CThread *> threads;
+  copy.m_workers = count;
+  for (unsigned int i = 0; i < count; i++)
+  {
+    CThread *thread = new CThread(&copy, "FileOperationCopy");
+    thread->Create();
+    threads.push_back(thread);
+  }
+
+  // report the progress of all the copies from here, as only this thread may talk to the job manager
+  CStopWatch timer;
+  timer.StartZero();
+  bool done = false;
+  while (!done)
+  {
+    done = copy.WaitDone(500);
+
+    CStdString currentFile;
+    double progress = copy.GetProgress(currentFile);
+    m_currentFile = currentFile;
+    float elapsed = timer.GetElapsedSeconds();
+    if (elapsed > 0)
+    { // the time of a copy is its size in bytes
+      float avgSpeed = progress / elapsed;
+      if (avgSpeed > 1000000.0f)
+        m_avgSpeed.Format("%.1f Mb/s", avgSpeed / 1000000.0f);
+      else
+        m_avgSpeed.Format("%.1f Kb/s", avgSpeed / 1000.0f);
+    }
+    if (ShouldCancel((unsigned)(current + progress * opWeight), 100))
+      copy.Cancel();
+  }
+
+  for (vector<CThread *>::iterator i = threads.begin(); i != threads.end(); ++i)
+  {
+    (*i)->StopThread(true);
+    delete *i;
+  }
+
+  for (unsigned int i = first; i < last; i++)
+    current += (double)ops[i].GetTime() * opWeight;
+
+  return copy.Succeeded();
+}
+
+CFileOperationJob::CConcurrentCopy::CConcurrentCopy(CFileOperationJob *base, FileOperationList &ops, unsigned int first, unsigned int last)
+  : m_workers(0), m_base(base), m_ops(ops), m_first(first), m_last(last), m_next(0), m_cancelled(false), m_failed(false)
+{
+  m_percent.resize(last - first, 0);
+}
+
+void CFileOperationJob::CConcurrentCopy::Run()
+{
+  while (!m_cancelled)
+  {
+    unsigned int index = m_first + AtomicIncrement(&m_next) - 1;
+    if (index >= m_last)
+      break;
+
+    {
+      CSingleLock lock(m_section);
+      m_currentFile = CURL(m_ops[index].GetFileA()).GetFileNameWithoutPath();
+    }
+
+    DataHolder data = { m_base, 0.0, 0.0, &m_percent[index - m_first], &m_section, &m_cancelled };
+    if (!m_ops[index].Execute(&data))
+    { // stop at the first failure, as when copying one by one
+      m_failed = true;
+      m_cancelled = true;
+    }
+    CSingleLock lock(m_section);
+    m_percent[index - m_first] = 100;
+  }
+
+  if (AtomicDecrement(&m_workers) == 0)
+    m_done.Set();
+}
+
+bool CFileOperationJob::CConcurrentCopy::WaitDone(unsigned int milliseconds)
+{
+  return m_done.WaitMSec(milliseconds);
+}
+
+double CFileOperationJob::CConcurrentCopy::GetProgress(CStdString &currentFile)
+{
+  CSingleLock lock(m_section);
+  currentFile = m_currentFile;
+  double progress = 0.0;
+  for (unsigned int i = m_first; i < m_last; i++)
+    progress += (double)m_ops[i].GetTime() * m_percent[i - m_first] / 100.0;
+  return progress;
+}
+
 bool CFileOperationJob::DoProcessFile(FileAction action, const CStdString& strFileA, const CStdString& strFileB, FileOperationList &fileOperations, double &totalTime)
 {
   int64_t time = 1;
@@ -181,17 +310,8 @@ CFileOperationJob::CFileOperation::CFileOperation(FileAction action, const CStdS
 {
 }
 
-struct DataHolder
-{
-  CFileOperationJob *base;
-  double current;
-  double opWeight;
-};
-
 bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base, double &current, double opWeight)
 {
-  bool bResult = true;
-
   base->m_currentFile = CURL(m_strFileA).GetFileNameWithoutPath();
 
   switch (m_action)
@@ -218,7 +338,23 @@ bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base
   if (base->ShouldCancel((unsigned)current, 100))
     return false;
 
-  DataHolder data = {base, current, opWeight};
+  DataHolder data = {base, current, opWeight, NULL, NULL, NULL};
+  bool bResult = Execute(&data);
+
+  current += (double)m_time * opWeight;
+
+  return bResult;
+}
+
+bool CFileOperationJob::CFileOperation::IsCopy() const
+{
+  return m_action == ActionCopy || m_action == ActionReplace ||
+        (m_action == ActionMove && !CanBeRenamed(m_strFileA, m_strFileB));
+}
+
+bool CFileOperationJob::CFileOperation::Execute(void *data)
+{
+  bool bResult = true;
 
   switch (m_action)
   {
@@ -227,7 +363,7 @@ bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base
     {
       CLog::Log(LOGDEBUG,"FileManager: copy %s -> %s\n", m_strFileA.c_str(), m_strFileB.c_str());
 
-      bResult = CFile::Cache(m_strFileA, m_strFileB, this, &data);
+      bResult = CFile::Cache(m_strFileA, m_strFileB, this, data);
     }
     break;
     case ActionMove:
@@ -236,7 +372,7 @@ bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base
 
       if (CanBeRenamed(m_strFileA, m_strFileB))
         bResult = CFile::Rename(m_strFileA, m_strFileB);
-      else if (CFile::Cache(m_strFileA, m_strFileB, this, &data))
+      else if (CFile::Cache(m_strFileA, m_strFileB, this, data))
         bResult = CFile::Delete(m_strFileA);
       else
         bResult = false;
@@ -265,8 +401,6 @@ bool CFileOperationJob::CFileOperation::ExecuteOperation(CFileOperationJob *base
     break;
   }
 
-  current += (double)m_time * opWeight;
-
   return bResult;
 }
 
@@ -290,6 +424,13 @@ void CFileOperationJob::CFileOperation::Debug()
 bool CFileOperationJob::CFileOperation::OnFileCallback(void* pContext, int ipercent, float avgSpeed)
 {
   DataHolder *data = (DataHolder *)pContext;
+  if (data->percent)
+  {
+    CSingleLock lock(*data->section);
+    *data->percent = ipercent;
+    return !*data->cancelled;
+  }
+
   double current = data->current + ((double)ipercent * data->opWeight * (double)m_time)/ 100.0;
 
   if (avgSpeed > 1000000.0f)
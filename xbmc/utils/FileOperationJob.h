@@ -24,6 +24,9 @@
 #include "FileItem.h"
 #include "Job.h"
 #include "filesystem/File.h"
+#include "threads/Thread.h"
+#include "threads/Event.h"
+#include "threads/CriticalSection.h"
 
 class CFileOperationJob : public CJob
 {
@@ -43,6 +46,12 @@ public:
 
   void SetFileOperation(FileAction action, CFileItemList &items, const CStdString &strDestFile);
 
+  /*! \brief Copy up to the given number of files at the same time.
+   Consecutive file copies (and moves that can't be renamed) are then run concurrently,
+   with the progress and speed reported for all of them together. Defaults to 1.
+   */
+  void SetConcurrentCopies(unsigned int copies) { m_concurrentCopies = copies ? copies : 1; }
+
   virtual bool DoWork();
   const CStdString &GetAverageSpeed()     { return m_avgSpeed; }
   const CStdString &GetCurrentOperation() { return m_currentOperation; }
@@ -55,6 +64,10 @@ private:
   public:
     CFileOperation(FileAction action, const CStdString &strFileA, const CStdString &strFileB, int64_t time);
     bool ExecuteOperation(CFileOperationJob *base, double &current, double opWeight);
+    bool Execute(void *data);
+    bool IsCopy() const;
+    int64_t GetTime() const { return m_time; }
+    const CStdString &GetFileA() const { return m_strFileA; }
     void Debug();
     virtual bool OnFileCallback(void* pContext, int ipercent, float avgSpeed);
   private:
@@ -64,6 +77,33 @@ private:
   };
   friend class CFileOperation;
   typedef std::vector<CFileOperation> FileOperationList;
+
+  /*! \brief Runs a range of copy operations on several threads.
+   */
+  class CConcurrentCopy : public IRunnable
+  {
+  public:
+    CConcurrentCopy(CFileOperationJob *base, FileOperationList &ops, unsigned int first, unsigned int last);
+    virtual void Run();
+    void Cancel() { m_cancelled = true; }
+    bool WaitDone(unsigned int milliseconds);
+    bool Succeeded() const { return !m_failed; }
+    double GetProgress(CStdString &currentFile); ///< sum of the completed part of each operation's time
+
+    volatile long m_workers;
+  private:
+    CFileOperationJob *m_base;
+    FileOperationList &m_ops;
+    unsigned int m_first, m_last;
+    volatile long m_next;
+    volatile bool m_cancelled;
+    volatile bool m_failed;
+    std::vector<long> m_percent;   ///< progress of each operation, 0-100
+    CStdString m_currentFile;
+    CCriticalSection m_section;    ///< guards m_percent and m_currentFile
+    CEvent m_done;
+  };
+  bool ExecuteConcurrently(FileOperationList &ops, unsigned int first, unsigned int last, double &current, double opWeight);
   bool DoProcess(FileAction action, CFileItemList & items, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime);
   bool DoProcessFolder(FileAction action, const CStdString& strPath, const CStdString& strDestFile, FileOperationList &fileOperations, double &totalTime);
   bool DoProcessFile(FileAction action, const CStdString& strFileA, const CStdString& strFileB, FileOperationList &fileOperations, double &totalTime);
@@ -74,4 +114,5 @@ private:
   CFileItemList m_items;
   CStdString m_strDestFile;
   CStdString m_avgSpeed, m_currentOperation, m_currentFile;
+  unsigned int m_concurrentCopies;
 };
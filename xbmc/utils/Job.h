@@ -105,6 +105,16 @@ public:
     PRIORITY_NORMAL,
     PRIORITY_HIGH
   };
+
+  /*!
+   \brief Classes of jobs, each of which is run by its own pool of workers.
+   \sa GetClass(), CJobManager
+   */
+  enum CLASS {
+    CLASS_IO = 0,    ///< jobs that mostly wait on the network or disk
+    CLASS_COMPUTE    ///< jobs that mostly keep a core busy
+  };
+
   CJob() { m_callback = NULL; };
 
   /*!
@@ -140,11 +150,36 @@ public:
    */
   virtual const char *GetType() const { return ""; };
 
+  /*!
+   \brief Function that returns the class of job, which decides the pool of workers it runs on.
+
+   CJob subclasses that spend their time computing rather than waiting on I/O should return CLASS_COMPUTE.
+
+   \return the class of the job, CLASS_IO by default.
+   \sa CJobManager
+   */
+  virtual CLASS GetClass() const { return CLASS_IO; };
+
   virtual bool operator==(const CJob* job) const
   {
     return false;
   }
 
+  /*!
+   \brief Called as each of the job's prerequisites finishes, before the prerequisite is destroyed.
+
+   CJob subclasses added with prerequisites (see CJobManager::AddJob()) may override this to take
+   the results they need from the prerequisite.  It's called on the thread of the prerequisite with
+   the CJobManager's dependency lock held, so it must not add or cancel jobs.
+
+   \param jobID the unique id of the prerequisite.
+   \param success the result of the prerequisite's DoWork call.
+   \param job the prerequisite.
+   \return true if the job should still be run, false to fail it without running it. Defaults to success.
+   \sa CJobManager::AddJob(), CJobManager::AddContinuation()
+   */
+  virtual bool OnPrerequisite(unsigned int jobID, bool success, const CJob *job) { return success; };
+
   /*!
    \brief Function for longer jobs to report progress and check whether they have been cancelled.
    
@@ -22,9 +22,28 @@
 #include "JobManager.h"
 #include <algorithm>
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "threads/Atomics.h"
+#include "utils/log.h"
+#ifndef TARGET_WINDOWS
+#include <unistd.h>
+#endif
 
 using namespace std;
 
+// the cores are counted here rather than by g_cpuInfo, which would pull the settings
+// into everything linking the job manager (its unit test included)
+static int GetCPUCount()
+{
+#ifdef TARGET_WINDOWS
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors;
+#else
+  return sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+}
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -32,9 +51,11 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("Jobworker")
+CJobWorker::CJobWorker(CJobManager *manager, CJob::CLASS jobClass)
+: CThread("Jobworker"), m_current(NULL, 0, NULL)
 {
   m_jobManager = manager;
+  m_class = jobClass;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -51,6 +72,7 @@ CJobWorker::~CJobWorker()
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  m_jobManager->m_worker.set(this);
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -62,6 +84,7 @@ void CJobWorker::Process()
     bool success = job->DoWork();
     m_jobManager->OnJobComplete(success, job);
   }
+  m_jobManager->m_worker.set(NULL);
 }
 
 void CJobQueue::CJobPointer::CancelJob()
@@ -87,6 +110,12 @@ void CJobQueue::OnJobComplete(unsigned int jobID, bool success, CJob *job)
   Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
   if (i != m_processing.end())
     m_processing.erase(i);
+  else
+  { // or our continuations
+    i = find(m_continuations.begin(), m_continuations.end(), job);
+    if (i != m_continuations.end())
+      m_continuations.erase(i);
+  }
   // request a new job be queued
   QueueNextJob();
 }
@@ -96,7 +125,8 @@ void CJobQueue::AddJob(CJob *job)
   CSingleLock lock(m_section);
   // check if we have this job already.  If so, we're done.
   if (find(m_jobQueue.begin(), m_jobQueue.end(), job) != m_jobQueue.end() ||
-      find(m_processing.begin(), m_processing.end(), job) != m_processing.end())
+      find(m_processing.begin(), m_processing.end(), job) != m_processing.end() ||
+      find(m_continuations.begin(), m_continuations.end(), job) != m_continuations.end())
   {
     delete job;
     return;
@@ -109,6 +139,23 @@ void CJobQueue::AddJob(CJob *job)
   QueueNextJob();
 }
 
+void CJobQueue::AddContinuation(unsigned int jobID, CJob *job)
+{
+  CSingleLock lock(m_section);
+  // check if we have this job already.  If so, we're done.
+  if (find(m_jobQueue.begin(), m_jobQueue.end(), job) != m_jobQueue.end() ||
+      find(m_processing.begin(), m_processing.end(), job) != m_processing.end() ||
+      find(m_continuations.begin(), m_continuations.end(), job) != m_continuations.end())
+  {
+    delete job;
+    return;
+  }
+
+  CJobPointer continuation(job);
+  continuation.m_id = CJobManager::GetInstance().AddContinuation(jobID, job, this, m_priority);
+  m_continuations.push_back(continuation);
+}
+
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
@@ -125,9 +172,11 @@ void CJobQueue::CancelJobs()
 {
   CSingleLock lock(m_section);
   for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CJobPointer::CancelJob));
+  for_each(m_continuations.begin(), m_continuations.end(), mem_fun_ref(&CJobPointer::CancelJob));
   for_each(m_jobQueue.begin(), m_jobQueue.end(), mem_fun_ref(&CJobPointer::FreeJob));
   m_jobQueue.clear();
   m_processing.clear();
+  m_continuations.clear();
 }
 
 CJobManager &CJobManager::GetInstance()
@@ -138,33 +187,64 @@ CJobManager &CJobManager::GetInstance()
 
 CJobManager::CJobManager()
 {
+  m_pools[CJob::CLASS_IO].m_section.set_name("CJobManager I/O pool");
+  m_pools[CJob::CLASS_COMPUTE].m_section.set_name("CJobManager compute pool");
+  m_dependencySection.set_name("CJobManager dependencies");
   m_jobCounter = 0;
+  m_dependencyCount = 0;
   m_running = true;
 }
 
 void CJobManager::CancelJobs()
 {
-  CSingleLock lock(m_section);
-  m_running = false;
+  { // drop the jobs held back on others
+    CSingleLock lock(m_dependencySection);
+    for (map<unsigned int, CWaiting>::iterator i = m_waiting.begin(); i != m_waiting.end(); ++i)
+      i->second.m_item.FreeJob();
+    m_waiting.clear();
+    AtomicSubtract(&m_dependencyCount, m_dependents.size());
+    m_dependents.clear();
+  }
 
-  // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  for (unsigned int jobClass = CJob::CLASS_IO; jobClass <= CJob::CLASS_COMPUTE; ++jobClass)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
-    m_jobQueue[priority].clear();
-  }
+    CPool &pool = m_pools[jobClass];
+    CSingleLock lock(pool.m_section);
+    m_running = false;
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), mem_fun_ref(&CWorkItem::Cancel));
+    // clear any pending jobs
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      for_each(pool.m_jobQueue[priority].begin(), pool.m_jobQueue[priority].end(), mem_fun_ref(&CWorkItem::FreeJob));
+      pool.m_jobQueue[priority].clear();
+    }
+
+    for (Workers::iterator i = pool.m_workers.begin(); i != pool.m_workers.end(); ++i)
+    {
+      CSingleLock workerLock((*i)->m_section);
+      for_each((*i)->m_local.begin(), (*i)->m_local.end(), mem_fun_ref(&CWorkItem::FreeJob));
+      (*i)->m_local.clear();
+      // cancel any callbacks on jobs still processing
+      (*i)->m_current.Cancel();
+    }
+    pool.m_stats.queued = 0;
+  }
 
   // tell our workers to finish
-  while (m_workers.size())
+  for (unsigned int jobClass = CJob::CLASS_IO; jobClass <= CJob::CLASS_COMPUTE; ++jobClass)
   {
-    lock.Leave();
-    m_jobEvent.Set();
-    Sleep(0); // yield after setting the event to give the workers some time to die
-    lock.Enter();
+    CPool &pool = m_pools[jobClass];
+    CSingleLock lock(pool.m_section);
+    while (pool.m_workers.size())
+    {
+      lock.Leave();
+      pool.m_jobEvent.Set();
+      Sleep(0); // yield after setting the event to give the workers some time to die
+      lock.Enter();
+    }
   }
+
+  LogStats();
 }
 
 CJobManager::~CJobManager()
@@ -173,93 +253,313 @@ CJobManager::~CJobManager()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter++, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, (unsigned int)AtomicIncrement(&m_jobCounter), callback, priority);
+  QueueJob(work);
+  return work.m_id;
+}
 
-  StartWorkers(priority);
+unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority, const vector<unsigned int> &prerequisites)
+{
+  CWorkItem work(job, (unsigned int)AtomicIncrement(&m_jobCounter), callback, priority);
+
+  CSingleLock lock(m_dependencySection);
+  // a prerequisite that finishes from here on has to look for us
+  AtomicIncrement(&m_dependencyCount);
+  unsigned int pending = 0;
+  for (vector<unsigned int>::const_iterator i = prerequisites.begin(); i != prerequisites.end(); ++i)
+  {
+    if (IsPending(*i))
+    {
+      m_dependents.insert(make_pair(*i, work.m_id));
+      AtomicIncrement(&m_dependencyCount);
+      pending++;
+    }
+  }
+  if (pending)
+  {
+    CWaiting &waiting = m_waiting[work.m_id];
+    waiting.m_item = work;
+    waiting.m_pending = pending;
+  }
+  AtomicDecrement(&m_dependencyCount);
+  lock.Leave();
+
+  if (!pending)
+    QueueJob(work);
   return work.m_id;
 }
 
-void CJobManager::CancelJob(unsigned int jobID)
+unsigned int CJobManager::AddContinuation(unsigned int jobID, CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  return AddJob(job, callback, priority, vector<unsigned int>(1, jobID));
+}
+
+void CJobManager::QueueJob(CWorkItem &work)
+{
+  CJob::CLASS jobClass = work.m_job->GetClass();
+  CPool &pool = m_pools[jobClass];
+  work.m_queued = XbmcThreads::SystemClockMillis();
+
+  CSingleLock lock(pool.m_section);
+  CJobWorker *worker = m_worker.get();
+  if (worker && worker->m_class == jobClass)
+  { // added by a job of the same class, so keep it with that job's worker
+    CSingleLock workerLock(worker->m_section);
+    worker->m_local.push_back(work);
+  }
+  else
+    pool.m_jobQueue[work.m_priority].push_back(work);
+
+  pool.m_stats.queued++;
+  pool.m_stats.maxQueued = std::max(pool.m_stats.maxQueued, pool.m_stats.queued);
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+  StartWorkers(pool, jobClass, work.m_priority);
+}
+
+bool CJobManager::IsPending(unsigned int jobID)
+{
+  if (m_waiting.find(jobID) != m_waiting.end())
+    return true;
+
+  for (unsigned int jobClass = CJob::CLASS_IO; jobClass <= CJob::CLASS_COMPUTE; ++jobClass)
+  {
+    CPool &pool = m_pools[jobClass];
+    CSingleLock lock(pool.m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      if (find(pool.m_jobQueue[priority].begin(), pool.m_jobQueue[priority].end(), jobID) != pool.m_jobQueue[priority].end())
+        return true;
+    }
+    for (Workers::iterator i = pool.m_workers.begin(); i != pool.m_workers.end(); ++i)
+    {
+      CSingleLock workerLock((*i)->m_section);
+      if (find((*i)->m_local.begin(), (*i)->m_local.end(), jobID) != (*i)->m_local.end())
+        return true;
+      if ((*i)->m_current.m_job && (*i)->m_current == jobID)
+        return true;
+    }
+  }
+  return false;
+}
+
+void CJobManager::OnPrerequisiteComplete(unsigned int jobID, bool success, const CJob *job)
+{
+  vector<CWorkItem> ready, failed;
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    CSingleLock lock(m_dependencySection);
+    pair<multimap<unsigned int, unsigned int>::iterator, multimap<unsigned int, unsigned int>::iterator> range = m_dependents.equal_range(jobID);
+    for (multimap<unsigned int, unsigned int>::iterator i = range.first; i != range.second; ++i)
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
+      AtomicDecrement(&m_dependencyCount);
+      map<unsigned int, CWaiting>::iterator waiting = m_waiting.find(i->second);
+      if (waiting == m_waiting.end())
+        continue; // failed on an earlier prerequisite
+      CWaiting &dependent = waiting->second;
+      if (!dependent.m_item.m_job->OnPrerequisite(jobID, success, job))
+        failed.push_back(dependent.m_item);
+      else if (--dependent.m_pending == 0)
+        ready.push_back(dependent.m_item);
+      else
+        continue;
+      m_waiting.erase(waiting);
+    }
+    m_dependents.erase(range.first, range.second);
+  }
+
+  for (vector<CWorkItem>::iterator i = ready.begin(); i != ready.end(); ++i)
+    QueueJob(*i);
+
+  for (vector<CWorkItem>::iterator i = failed.begin(); i != failed.end(); ++i)
+  {
+    if (i->m_callback)
+      i->m_callback->OnJobComplete(i->m_id, false, i->m_job);
+    if (m_dependencyCount)
+      OnPrerequisiteComplete(i->m_id, false, i->m_job);
+    i->FreeJob();
+  }
+}
+
+void CJobManager::CancelDependents(unsigned int jobID)
+{
+  pair<multimap<unsigned int, unsigned int>::iterator, multimap<unsigned int, unsigned int>::iterator> range = m_dependents.equal_range(jobID);
+  vector<unsigned int> dependents;
+  for (multimap<unsigned int, unsigned int>::iterator i = range.first; i != range.second; ++i)
+  {
+    AtomicDecrement(&m_dependencyCount);
+    dependents.push_back(i->second);
+  }
+  m_dependents.erase(range.first, range.second);
+
+  for (vector<unsigned int>::iterator i = dependents.begin(); i != dependents.end(); ++i)
+  {
+    map<unsigned int, CWaiting>::iterator waiting = m_waiting.find(*i);
+    if (waiting == m_waiting.end())
+      continue;
+    waiting->second.m_item.FreeJob();
+    m_waiting.erase(waiting);
+    CancelDependents(*i);
+  }
+}
+
+void CJobManager::CancelJob(unsigned int jobID)
+{
+  if (m_dependencyCount)
+  {
+    CSingleLock lock(m_dependencySection);
+    CancelDependents(jobID);
+    map<unsigned int, CWaiting>::iterator waiting = m_waiting.find(jobID);
+    if (waiting != m_waiting.end())
+    { // not queued yet - any entries of ours in m_dependents are skipped as our prerequisites finish
+      waiting->second.m_item.FreeJob();
+      m_waiting.erase(waiting);
       return;
     }
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+
+  for (unsigned int jobClass = CJob::CLASS_IO; jobClass <= CJob::CLASS_COMPUTE; ++jobClass)
+  {
+    CPool &pool = m_pools[jobClass];
+    CSingleLock lock(pool.m_section);
+
+    // check whether we have this job in the queue
+    for (unsigned int priority = CJob::PRIORITY_LOW; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      JobQueue::iterator i = find(pool.m_jobQueue[priority].begin(), pool.m_jobQueue[priority].end(), jobID);
+      if (i != pool.m_jobQueue[priority].end())
+      {
+        delete i->m_job;
+        pool.m_jobQueue[priority].erase(i);
+        pool.m_stats.queued--;
+        return;
+      }
+    }
+
+    // or in the queue of a worker, or if we're processing it
+    for (Workers::iterator i = pool.m_workers.begin(); i != pool.m_workers.end(); ++i)
+    {
+      CSingleLock workerLock((*i)->m_section);
+      JobQueue::iterator it = find((*i)->m_local.begin(), (*i)->m_local.end(), jobID);
+      if (it != (*i)->m_local.end())
+      {
+        delete it->m_job;
+        (*i)->m_local.erase(it);
+        pool.m_stats.queued--;
+        return;
+      }
+      if ((*i)->m_current.m_job && (*i)->m_current == jobID)
+      {
+        (*i)->m_current.Cancel(); // job is in progress, so only thing to do is to remove callback
+        return;
+      }
+    }
+  }
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+void CJobManager::StartWorkers(CPool &pool, CJob::CLASS jobClass, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
+  CSingleLock lock(pool.m_section);
 
   // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (pool.m_busy >= GetMaxWorkers(jobClass, priority))
     return;
 
   // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  if (pool.m_busy < pool.m_workers.size())
   {
-    m_jobEvent.Set();
+    pool.m_jobEvent.Set();
     return;
   }
 
   // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+  pool.m_workers.push_back(new CJobWorker(this, jobClass));
 }
 
-CJob *CJobManager::PopJob()
+void CJobManager::StartJob(CPool &pool, CJobWorker *worker, const CWorkItem &item)
 {
-  CSingleLock lock(m_section);
+  unsigned int waitTime = XbmcThreads::SystemClockMillis() - item.m_queued;
+  pool.m_stats.queued--;
+  pool.m_stats.jobs++;
+  pool.m_stats.waitTime += waitTime;
+  pool.m_stats.maxWaitTime = std::max(pool.m_stats.maxWaitTime, waitTime);
+  pool.m_busy++;
+
+  CSingleLock lock(worker->m_section);
+  worker->m_current = item;
+  item.m_job->m_callback = this;
+}
+
+CJob *CJobManager::PopJob(CJobWorker *worker)
+{
+  CPool &pool = m_pools[worker->m_class];
+  CSingleLock lock(pool.m_section);
+
+  // by priority, and within a priority our own queue first, newest first, as those jobs
+  // were added by the jobs we ran
   for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW; --priority)
   {
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    if (pool.m_busy >= GetMaxWorkers(worker->m_class, CJob::PRIORITY(priority)))
+      continue;
+
+    CSingleLock workerLock(worker->m_section);
+    if (worker->m_local.size() && worker->m_local.back().m_priority == priority)
+    {
+      CWorkItem job = worker->m_local.back();
+      worker->m_local.pop_back();
+      workerLock.Leave();
+      StartJob(pool, worker, job);
+      return job.m_job;
+    }
+    workerLock.Leave();
+
+    if (pool.m_jobQueue[priority].size())
+    {
+      CWorkItem job = pool.m_jobQueue[priority].front();
+      pool.m_jobQueue[priority].pop_front();
+      StartJob(pool, worker, job);
+      return job.m_job;
+    }
+  }
+
+  // then the oldest job in the queue of another worker
+  for (Workers::iterator i = pool.m_workers.begin(); i != pool.m_workers.end(); ++i)
+  {
+    if (*i == worker)
+      continue;
+    CSingleLock otherLock((*i)->m_section);
+    if ((*i)->m_local.size() && pool.m_busy < GetMaxWorkers(worker->m_class, (*i)->m_local.front().m_priority))
     {
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
-      // add to the processing vector
-      m_processing.push_back(job);
-      job.m_job->m_callback = this;
+      CWorkItem job = (*i)->m_local.front();
+      (*i)->m_local.pop_front();
+      otherLock.Leave();
+      pool.m_stats.stolen++;
+      StartJob(pool, worker, job);
       return job.m_job;
     }
   }
   return NULL;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  CPool &pool = m_pools[worker->m_class];
+  CSingleLock lock(pool.m_section);
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopJob(worker);
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
     lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
+    bool newJob = pool.m_jobEvent.WaitMSec(30000);
     lock.Enter();
     if (!newJob)
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CJob *job = PopJob(worker);
   if (job)
     return job;
   // have no jobs
@@ -267,14 +567,28 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
   return NULL;
 }
 
+CJobWorker *CJobManager::FindProcessing(const CPool &pool, const CJob *job) const
+{
+  for (Workers::const_iterator i = pool.m_workers.begin(); i != pool.m_workers.end(); ++i)
+  {
+    CSingleLock lock((*i)->m_section);
+    if ((*i)->m_current.m_job && (*i)->m_current == job)
+      return *i;
+  }
+  return NULL;
+}
+
 bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  const CPool &pool = m_pools[job->GetClass()];
+  CSingleLock lock(pool.m_section);
+  // find the job being processed, and check whether it's cancelled (no callback)
+  CJobWorker *worker = FindProcessing(pool, job);
+  if (worker)
   {
-    CWorkItem item(*i);
+    CSingleLock workerLock(worker->m_section);
+    CWorkItem item(worker->m_current);
+    workerLock.Leave();
     lock.Leave(); // leave section prior to call
     if (item.m_callback)
     {
@@ -287,36 +601,82 @@ bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const
 
 void CJobManager::OnJobComplete(bool success, CJob *job)
 {
-  CSingleLock lock(m_section);
-  // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  CPool &pool = m_pools[job->GetClass()];
+  CSingleLock lock(pool.m_section);
+  // find the worker that processed the job
+  CJobWorker *worker = FindProcessing(pool, job);
+  if (worker)
   {
     // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
+    CSingleLock workerLock(worker->m_section);
+    CWorkItem item(worker->m_current);
+    workerLock.Leave();
     lock.Leave();
     if (item.m_callback)
       item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
     lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
+    workerLock.Enter();
+    bool cancelled = worker->m_current.m_cancelled;
+    worker->m_current = CWorkItem(NULL, 0, NULL);
+    workerLock.Leave();
+    pool.m_busy--;
     lock.Leave();
+    // the job is no longer pending, so any dependent added from here on won't wait on it
+    if (m_dependencyCount)
+    {
+      if (cancelled)
+      { // dependents added while it was running after being cancelled
+        CSingleLock dependencyLock(m_dependencySection);
+        CancelDependents(item.m_id);
+      }
+      else
+        OnPrerequisiteComplete(item.m_id, success, item.m_job);
+    }
     item.FreeJob();
   }
 }
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  CPool &pool = m_pools[worker->m_class];
+  CSingleLock lock(pool.m_section);
   // remove our worker
-  Workers::iterator i = find(m_workers.begin(), m_workers.end(), worker);
-  if (i != m_workers.end())
-    m_workers.erase(i); // workers auto-delete
+  Workers::iterator i = find(pool.m_workers.begin(), pool.m_workers.end(), worker);
+  if (i != pool.m_workers.end())
+    pool.m_workers.erase(i); // workers auto-delete
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority) const
+unsigned int CJobManager::GetMaxWorkers(CJob::CLASS jobClass, CJob::PRIORITY priority) const
 {
-  static const unsigned int max_workers = 5;
+  // concurrent transfers beyond which the network or disk, rather than us, is the bottleneck
+  static const unsigned int max_io_workers = 8;
+  static const int max_compute_workers = 16;
+
+  // for compute jobs, one worker per core is kept for low priority jobs, with a spare
+  // worker for each priority above.  I/O jobs share the same number of spare workers.
+  unsigned int max_workers = max_io_workers;
+  if (jobClass == CJob::CLASS_COMPUTE)
+    max_workers = std::min(std::max(GetCPUCount(), 1), max_compute_workers) + CJob::PRIORITY_HIGH;
   return max_workers - (CJob::PRIORITY_HIGH - priority);
 }
+
+void CJobManager::GetStats(CJob::CLASS jobClass, Stats &stats)
+{
+  CPool &pool = m_pools[jobClass];
+  CSingleLock lock(pool.m_section);
+  stats = pool.m_stats;
+  stats.workers = pool.m_workers.size();
+  stats.maxWorkers = GetMaxWorkers(jobClass, CJob::PRIORITY_HIGH);
+}
+
+void CJobManager::LogStats()
+{
+  for (unsigned int jobClass = CJob::CLASS_IO; jobClass <= CJob::CLASS_COMPUTE; ++jobClass)
+  {
+    Stats stats;
+    GetStats((CJob::CLASS)jobClass, stats);
+    CLog::Log(LOGDEBUG, "CJobManager - %s pool: %u jobs (%u stolen), waited %u ms on average and %u ms at most, at most %u queued, %u of %u workers running",
+              jobClass == CJob::CLASS_COMPUTE ? "compute" : "I/O", stats.jobs, stats.stolen,
+              stats.jobs ? stats.waitTime / stats.jobs : 0, stats.maxWaitTime, stats.maxQueued, stats.workers, stats.maxWorkers);
+  }
+}
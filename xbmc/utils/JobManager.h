@@ -20,25 +20,19 @@
  *
  */
 
+#include <string.h>
 #include <queue>
 #include <vector>
+#include <map>
 #include <string>
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/Thread.h"
+#include "threads/ThreadLocal.h"
 #include "Job.h"
 
 class CJobManager;
-
-class CJobWorker : public CThread
-{
-public:
-  CJobWorker(CJobManager *manager);
-  virtual ~CJobWorker();
-
-  void Process();
-private:
-  CJobManager  *m_jobManager;
-};
+class CJobWorker;
 
 /*!
  \ingroup jobs
@@ -103,6 +97,16 @@ public:
    */
   void AddJob(CJob *job);
 
+  /*!
+   \brief Add a job to be run once the given job has finished successfully, see CJobManager::AddContinuation()
+   The continuation is kept with the jobs of the queue, so a copy of it isn't added again and CancelJobs()
+   cancels it, but it doesn't count towards the jobs processed at once.
+   \param jobID the id of the job to continue, such as the job passed to OnJobComplete()
+   \param job a pointer to the job to add. The job should be subclassed from CJob.
+   \sa AddJob()
+   */
+  void AddContinuation(unsigned int jobID, CJob *job);
+
   /*!
    \brief Cancel all jobs in the queue
    Removes all jobs from the queue. Any job currently being processed may complete after this
@@ -133,6 +137,7 @@ private:
   typedef std::vector<CJobPointer> Processing;
   Queue m_jobQueue;
   Processing m_processing;
+  Processing m_continuations;
 
   unsigned int m_jobsAtOnce;
   CJob::PRIORITY m_priority;
@@ -145,9 +150,21 @@ private:
  \brief Job Manager class for scheduling asynchronous jobs.
 
  Controls asynchronous job execution, by allowing clients to add and cancel jobs.
- Should be accessed via CJobManager::GetInstance().  Jobs are allocated based on
- priority levels.  Lower priority jobs are executed only if there are sufficient
- spare worker threads free to allow for higher priority jobs that may arise.
+ Should be accessed via CJobManager::GetInstance().
+
+ Each class of job (see CJob::GetClass()) has its own pool of workers, so jobs waiting on the
+ network don't hold up jobs that need a core, and vice versa. The I/O pool is sized by how many
+ concurrent transfers are sensible, the compute pool by the number of cores.
+
+ Within a pool jobs are allocated based on priority levels.  Lower priority jobs are executed
+ only if there are sufficient spare worker threads free to allow for higher priority jobs that
+ may arise.  Jobs added from within a job of the same class are kept on the adding worker's own
+ queue, where the worker picks them up newest first and idle workers steal them oldest first.
+
+ Jobs may be added with prerequisites, or as continuations of another job, in which case they are
+ held back until those jobs have finished, and then queued from the thread that finished the last of
+ them - a worker of the same class runs it next.  A job whose prerequisite fails or is cancelled
+ isn't run: on failure its callback is told it failed, on cancellation it's dropped silently.
 
  \sa CJob and IJobCallback
  */
@@ -156,11 +173,14 @@ class CJobManager
   class CWorkItem
   {
   public:
-    CWorkItem(CJob *job, unsigned int id, IJobCallback *callback)
+    CWorkItem(CJob *job, unsigned int id, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW)
     {
       m_job = job;
       m_id = id;
       m_callback = callback;
+      m_priority = priority;
+      m_queued = 0;
+      m_cancelled = false;
     }
     bool operator==(unsigned int jobID) const
     {
@@ -178,13 +198,33 @@ class CJobManager
     void Cancel()
     {
       m_callback = NULL;
+      m_cancelled = true;
     };
-    CJob         *m_job;
-    unsigned int  m_id;
-    IJobCallback *m_callback;
+    CJob          *m_job;
+    unsigned int   m_id;
+    IJobCallback  *m_callback;
+    CJob::PRIORITY m_priority;
+    unsigned int   m_queued;   ///< time the job was added, for the queue latency
+    bool           m_cancelled;
   };
 
 public:
+  /*!
+   \brief Statistics of a pool of workers, since startup.
+   \sa GetStats()
+   */
+  struct Stats
+  {
+    unsigned int workers;      ///< workers currently running
+    unsigned int maxWorkers;   ///< most workers allowed at once
+    unsigned int queued;       ///< jobs currently waiting
+    unsigned int maxQueued;    ///< most jobs waiting at once
+    unsigned int jobs;         ///< jobs started
+    unsigned int stolen;       ///< jobs taken from another worker's queue
+    unsigned int waitTime;     ///< total ms jobs waited before being started
+    unsigned int maxWaitTime;  ///< longest ms a job waited before being started
+  };
+
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
    \return the global instance.
@@ -202,7 +242,33 @@ public:
   unsigned int AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
 
   /*!
-   \brief Cancel a job with the given id.
+   \brief Add a job to be run once all of the given jobs have finished.
+
+   Each prerequisite is passed to CJob::OnPrerequisite() of the job as it finishes.  If any of them
+   fail the job is not run, and the callback is told it failed.  Cancelling a prerequisite cancels
+   the job, and so on down to its own dependents.
+
+   Prerequisites that have already finished are taken as satisfied, whatever their result, so a
+   dependent that needs the result should be added before its prerequisite can finish - from the
+   prerequisite's own callback or DoWork(), or with a prerequisite that is still held back itself.
+
+   \param job a pointer to the job to add. The job should be subclassed from CJob
+   \param callback a pointer to an IJobCallback instance to receive job progress and completion notices.
+   \param priority the priority that this job should run at.
+   \param prerequisites ids of the jobs that should finish first, retrieved previously from AddJob()
+   \return a unique identifier for this job, to be used with other interaction
+   \sa CJob::OnPrerequisite(), AddContinuation(), CancelJob()
+   */
+  unsigned int AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority, const std::vector<unsigned int> &prerequisites);
+
+  /*!
+   \brief Add a job to be run once the given job has finished successfully.
+   \sa AddJob()
+   */
+  unsigned int AddContinuation(unsigned int jobID, CJob *job, IJobCallback *callback, CJob::PRIORITY priority = CJob::PRIORITY_LOW);
+
+  /*!
+   \brief Cancel a job with the given id, along with the jobs that depend on it.
    \param jobID the id of the job to cancel, retrieved previously from AddJob()
    \sa AddJob()
    */
@@ -215,6 +281,18 @@ public:
    */
   void CancelJobs();
 
+  /*!
+   \brief Get the statistics of the pool running the given class of jobs.
+   \sa LogStats()
+   */
+  void GetStats(CJob::CLASS jobClass, Stats &stats);
+
+  /*!
+   \brief Log the statistics of all pools.
+   \sa GetStats()
+   */
+  void LogStats();
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -224,7 +302,7 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
@@ -253,26 +331,95 @@ private:
   CJobManager const& operator=(CJobManager const&);
   virtual ~CJobManager();
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CJobWorker*> Workers;
+
+  /*! \brief A job held back until its prerequisites have finished.
+   */
+  struct CWaiting
+  {
+    CWaiting() : m_item(NULL, 0, NULL), m_pending(0) {};
+    CWorkItem    m_item;
+    unsigned int m_pending;   ///< prerequisites yet to finish
+  };
+
+  /*! \brief Workers and queues for one class of jobs.
+   Lock order is the pool's m_section before any worker's m_section.
+   */
+  class CPool
+  {
+  public:
+    CPool() : m_busy(0) { memset(&m_stats, 0, sizeof(m_stats)); };
+
+    JobQueue         m_jobQueue[CJob::PRIORITY_HIGH+1];  ///< jobs added from outside the pool's workers
+    Workers          m_workers;
+    unsigned int     m_busy;                             ///< workers running a job
+    Stats            m_stats;
+    CCriticalSection m_section;
+    CEvent           m_jobEvent;
+  };
+
+  /*! \brief Pop a job off the queues of the worker's pool, or its own queue, and mark the worker as running it.
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopJob(CJobWorker *worker);
+
+  /*! \brief Find the worker running the given job. The pool's m_section must be held.
+   */
+  CJobWorker *FindProcessing(const CPool &pool, const CJob *job) const;
 
-  void StartWorkers(CJob::PRIORITY priority);
+  void StartWorkers(CPool &pool, CJob::CLASS jobClass, CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
+  unsigned int GetMaxWorkers(CJob::CLASS jobClass, CJob::PRIORITY priority) const;
+  void StartJob(CPool &pool, CJobWorker *worker, const CWorkItem &item);
 
-  unsigned int m_jobCounter;
+  /*! \brief Queue a job that is ready to run on the pool of its class.
+   */
+  void QueueJob(CWorkItem &work);
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  /*! \brief Whether the given job is still to finish, be it held back, queued or running.
+   m_dependencySection must be held, and no pool's m_section.
+   */
+  bool IsPending(unsigned int jobID);
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_HIGH+1];
-  Processing m_processing;
-  Workers    m_workers;
+  /*! \brief Pass the result of a finished job on to the jobs that depend on it, queueing those that are ready.
+   */
+  void OnPrerequisiteComplete(unsigned int jobID, bool success, const CJob *job);
 
-  CCriticalSection m_section;
-  CEvent           m_jobEvent;
+  /*! \brief Drop the jobs held back on the given job, and theirs in turn. m_dependencySection must be held.
+   */
+  void CancelDependents(unsigned int jobID);
+
+  volatile long m_jobCounter;
+
+  /*! Lock order is m_dependencySection before any pool's m_section.
+   m_dependencyCount is the number of entries in m_dependents plus the number of AddJob() calls
+   busy adding to it, so that finishing jobs need only take m_dependencySection when it's nonzero.
+   */
+  CCriticalSection                          m_dependencySection;
+  std::map<unsigned int, CWaiting>          m_waiting;     ///< jobs held back, by id
+  std::multimap<unsigned int, unsigned int> m_dependents;  ///< ids of the jobs held back on each job
+  volatile long                             m_dependencyCount;
+
+  CPool            m_pools[CJob::CLASS_COMPUTE+1];
   bool             m_running;
+
+  XbmcThreads::ThreadLocal<CJobWorker> m_worker;  ///< the worker of the current thread, if any
+};
+
+class CJobWorker : public CThread
+{
+public:
+  CJobWorker(CJobManager *manager, CJob::CLASS jobClass);
+  virtual ~CJobWorker();
+
+  void Process();
+private:
+  friend class CJobManager;
+
+  CJobManager              *m_jobManager;
+  CJob::CLASS               m_class;
+  CJobManager::JobQueue     m_local;     ///< jobs added by the jobs this worker ran
+  CJobManager::CWorkItem    m_current;   ///< the job being run, with no m_job when idle
+  CCriticalSection          m_section;   ///< guards m_local and m_current
 };
@@ -30,6 +30,7 @@ using namespace PCRE;
 CRegExp::CRegExp(bool caseless)
 {
   m_re          = NULL;
+  m_sd          = NULL;
   m_iOptions    = PCRE_DOTALL;
   if(caseless)
     m_iOptions |= PCRE_CASELESS;
@@ -41,6 +42,7 @@ CRegExp::CRegExp(bool caseless)
 CRegExp::CRegExp(const CRegExp& re)
 {
   m_re = NULL;
+  m_sd = NULL;
   m_iOptions = re.m_iOptions;
   *this = re;
 }
@@ -62,6 +64,9 @@ const CRegExp& CRegExp::operator=(const CRegExp& re)
         m_bMatched = re.m_bMatched;
         m_subject = re.m_subject;
         m_iOptions = re.m_iOptions;
+        // study data isn't relocatable, so redo it for our copy
+        if (re.m_sd)
+          Study();
       }
     }
   }
@@ -73,6 +78,46 @@ CRegExp::~CRegExp()
   Cleanup();
 }
 
+void CRegExp::Cleanup()
+{
+  if (m_sd)
+  {
+#ifdef PCRE_STUDY_JIT_COMPILE
+    pcre_free_study(m_sd);
+#else
+    pcre_free(m_sd);
+#endif
+    m_sd = NULL;
+  }
+  if (m_re)
+  {
+    pcre_free(m_re);
+    m_re = NULL;
+  }
+}
+
+bool CRegExp::Study()
+{
+  if (!m_re)
+    return false;
+  if (m_sd)
+    return true;
+
+  const char *errMsg = NULL;
+  int options = 0;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  options |= PCRE_STUDY_JIT_COMPILE;
+#endif
+  m_sd = pcre_study(m_re, options, &errMsg);
+  if (errMsg)
+  {
+    CLog::Log(LOGERROR, "PCRE: %s. Study failed for expression '%s'", errMsg, m_pattern.c_str());
+    return false;
+  }
+  // NULL without an error just means there was nothing to gain
+  return true;
+}
+
 CRegExp* CRegExp::RegComp(const char *re)
 {
   if (!re)
@@ -117,7 +162,16 @@ int CRegExp::RegFind(const char* str, int startoffset)
   }
 
   m_subject = str;
-  int rc = pcre_exec(m_re, NULL, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+  int rc = pcre_exec(m_re, m_sd, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+#ifdef PCRE_ERROR_JITSTACKLIMIT
+  if (rc == PCRE_ERROR_JITSTACKLIMIT)
+  { // the JIT's default stack is small, so a long subject can outgrow it. match it without the JIT instead.
+    CLog::Log(LOGDEBUG, "PCRE: JIT stack limit reached for expression '%s', matching without the JIT", m_pattern.c_str());
+    pcre_extra extra = *m_sd;
+    extra.flags &= ~PCRE_EXTRA_EXECUTABLE_JIT;
+    rc = pcre_exec(m_re, &extra, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+  }
+#endif
 
   if (rc<1)
   {
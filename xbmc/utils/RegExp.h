@@ -48,6 +48,11 @@ public:
 
   CRegExp* RegComp(const char *re);
   CRegExp* RegComp(const std::string& re) { return RegComp(re.c_str()); }
+  /*! \brief Analyse the compiled expression to speed up matching, using the JIT where PCRE supports it.
+   Only worthwhile for expressions that are matched many times. A match that outgrows the
+   JIT's stack is retried without the JIT.
+   */
+  bool Study();
   int RegFind(const char *str, int startoffset = 0);
   int RegFind(const std::string& str, int startoffset = 0) { return RegFind(str.c_str(), startoffset); }
   char* GetReplaceString( const char* sReplaceExp );
@@ -69,10 +74,11 @@ public:
   const CRegExp& operator= (const CRegExp& re);
 
 private:
-  void Cleanup() { if (m_re) { PCRE::pcre_free(m_re); m_re = NULL; } }
+  void Cleanup();
 
 private:
   PCRE::pcre* m_re;
+  PCRE::pcre_extra* m_sd;
   int         m_iOvector[OVECCOUNT];
   int         m_iMatchCount;
   int         m_iOptions;
@@ -37,17 +37,56 @@ using namespace std;
 using namespace ADDON;
 using namespace XFILE;
 
+#define MAX_CACHED_REGEXPS 64
+
+CScraperParser::CRegExpProgram::CRegExpProgram()
+{
+  dest = 1;
+  append = false;
+  hasInput = false;
+  inputBuffers = false;
+  hasConditional = false;
+  inverse = false;
+  hasExpression = false;
+  expressionBuffers = false;
+  outputBuffers = false;
+  regexp = NULL;
+  caseless = true;
+  repeat = false;
+  clear = false;
+  optional = -1;
+  compare = -1;
+}
+
+CScraperParser::CRegExpProgram::~CRegExpProgram()
+{
+  delete regexp;
+  for (vector<CRegExpProgram *>::iterator i = children.begin(); i != children.end(); ++i)
+    delete *i;
+}
+
 CScraperParser::CScraperParser()
 {
   m_pRootElement = NULL;
   m_document = NULL;
   m_SearchStringEncoding = "UTF-8";
+  m_scraper = NULL;
+  m_compiled = false;
+  m_optionalRegExp = NULL;
+  m_unicodeRegExp = NULL;
+  m_hexRegExp = NULL;
 }
 
 CScraperParser::CScraperParser(const CScraperParser& parser)
 {
+  m_pRootElement = NULL;
   m_document = NULL;
   m_SearchStringEncoding = "UTF-8";
+  m_scraper = NULL;
+  m_compiled = false;
+  m_optionalRegExp = NULL;
+  m_unicodeRegExp = NULL;
+  m_hexRegExp = NULL;
   *this = parser;
 }
 
@@ -73,6 +112,7 @@ CScraperParser::~CScraperParser()
 
 void CScraperParser::Clear()
 {
+  ClearPrograms();
   m_pRootElement = NULL;
   delete m_document;
 
@@ -137,6 +177,199 @@ bool CScraperParser::LoadFromXML()
   return false;
 }
 
+void CScraperParser::ClearPrograms()
+{
+  for (map<CStdString, CFunctionProgram>::iterator i = m_functions.begin(); i != m_functions.end(); ++i)
+  {
+    for (vector<CRegExpProgram *>::iterator j = i->second.regexps.begin(); j != i->second.regexps.end(); ++j)
+      delete *j;
+  }
+  m_functions.clear();
+  for (map<CStdString, CRegExp *>::iterator i = m_regexpCache.begin(); i != m_regexpCache.end(); ++i)
+    delete i->second;
+  m_regexpCache.clear();
+
+  delete m_optionalRegExp;
+  delete m_unicodeRegExp;
+  delete m_hexRegExp;
+  m_optionalRegExp = NULL;
+  m_unicodeRegExp = NULL;
+  m_hexRegExp = NULL;
+  m_compiled = false;
+}
+
+void CScraperParser::Compile()
+{
+  ClearPrograms();
+  if (!m_pRootElement)
+    return;
+
+  for (TiXmlElement* pFunction = m_pRootElement->FirstChildElement(); pFunction; pFunction = pFunction->NextSiblingElement())
+  {
+    // the first function of a name wins, as with FirstChildElement()
+    if (m_functions.find(pFunction->Value()) != m_functions.end())
+      continue;
+
+    CFunctionProgram &function = m_functions[pFunction->Value()];
+    function.dest = 1; // default to param 1
+    pFunction->QueryIntAttribute("dest",&function.dest);
+    const char* szClearBuffers = pFunction->Attribute("clearbuffers");
+    function.clearBuffers = !szClearBuffers || stricmp(szClearBuffers,"no") != 0;
+    CompileChain(pFunction->FirstChildElement("RegExp"), function.regexps);
+  }
+
+  m_optionalRegExp = new CRegExp;
+  m_optionalRegExp->RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
+  m_unicodeRegExp = new CRegExp;
+  m_unicodeRegExp->RegComp("\\\\u([0-f]{4})");
+  m_hexRegExp = new CRegExp;
+  m_hexRegExp->RegComp("\\\\x([0-9]{2})([^\\\\]+;)");
+
+  m_compiled = true;
+}
+
+void CScraperParser::CompileChain(TiXmlElement* element, vector<CRegExpProgram *> &chain)
+{
+  for (TiXmlElement* pReg = element; pReg; pReg = pReg->NextSiblingElement("RegExp"))
+    chain.push_back(CompileRegExp(pReg));
+}
+
+CScraperParser::CRegExpProgram *CScraperParser::CompileRegExp(TiXmlElement* element)
+{
+  CRegExpProgram *program = new CRegExpProgram;
+
+  TiXmlElement* pChildReg = element->FirstChildElement("RegExp");
+  if (!pChildReg)
+    pChildReg = element->FirstChildElement("clear");
+  CompileChain(pChildReg, program->children);
+
+  const char* szDest = element->Attribute("dest");
+  if (szDest && strlen(szDest))
+  {
+    if (szDest[strlen(szDest)-1] == '+')
+      program->append = true;
+
+    program->dest = atoi(szDest);
+  }
+
+  const char *szInput = element->Attribute("input");
+  if (szInput)
+  {
+    program->hasInput = true;
+    program->input = szInput;
+    program->inputBuffers = HasBufferReferences(program->input);
+    if (!program->inputBuffers)
+      ReplaceBuffers(program->input);
+  }
+
+  const char* szConditional = element->Attribute("conditional");
+  if (szConditional)
+  {
+    program->hasConditional = true;
+    if (szConditional[0] == '!')
+    {
+      program->inverse = true;
+      szConditional++;
+    }
+    program->conditional = szConditional;
+  }
+
+  TiXmlElement* pExpression = element->FirstChildElement("expression");
+  if (!pExpression)
+    return program;
+
+  program->hasExpression = true;
+  const char* sensitive = pExpression->Attribute("cs");
+  if (sensitive && stricmp(sensitive,"yes") == 0)
+    program->caseless = false; // match case sensitive
+
+  if (pExpression->FirstChild())
+    program->expression = pExpression->FirstChild()->Value();
+  else
+    program->expression = "(.*)";
+  const char* szOutput = element->Attribute("output");
+  if (szOutput)
+    program->output = szOutput;
+
+  const char* szRepeat = pExpression->Attribute("repeat");
+  program->repeat = szRepeat && stricmp(szRepeat,"yes") == 0;
+  const char* szClear = pExpression->Attribute("clear");
+  program->clear = szClear && stricmp(szClear,"yes") == 0;
+
+  GetBufferParams(program->clean,pExpression->Attribute("noclean"),true);
+  GetBufferParams(program->trim,pExpression->Attribute("trim"),false);
+  GetBufferParams(program->fixChars,pExpression->Attribute("fixchars"),false);
+  GetBufferParams(program->encode,pExpression->Attribute("encode"),false);
+  pExpression->QueryIntAttribute("optional",&program->optional);
+  pExpression->QueryIntAttribute("compare",&program->compare);
+
+  program->expressionBuffers = HasBufferReferences(program->expression);
+  if (!program->expressionBuffers)
+  {
+    ReplaceBuffers(program->expression);
+    program->regexp = new CRegExp(program->caseless);
+    if (program->regexp->RegComp(program->expression.c_str()))
+      program->regexp->Study();
+    else
+    { // the expression is skipped, as it always was
+      delete program->regexp;
+      program->regexp = NULL;
+    }
+  }
+
+  program->outputBuffers = HasBufferReferences(program->output);
+  if (!program->outputBuffers)
+  {
+    ReplaceBuffers(program->output);
+    InsertTokens(program->output, *program);
+  }
+  return program;
+}
+
+bool CScraperParser::HasBufferReferences(const CStdString &str)
+{
+  return str.find("$$") != CStdString::npos || str.find("$INFO[") != CStdString::npos;
+}
+
+CRegExp *CScraperParser::GetRegExp(const CStdString &expression, bool caseless)
+{
+  CStdString key = (caseless ? "i" : "s") + expression;
+  map<CStdString, CRegExp *>::iterator i = m_regexpCache.find(key);
+  if (i != m_regexpCache.end())
+    return i->second;
+
+  CRegExp *reg = new CRegExp(caseless);
+  if (!reg->RegComp(expression.c_str()))
+  {
+    delete reg;
+    return NULL;
+  }
+
+  if (m_regexpCache.size() >= MAX_CACHED_REGEXPS)
+  {
+    for (i = m_regexpCache.begin(); i != m_regexpCache.end(); ++i)
+      delete i->second;
+    m_regexpCache.clear();
+  }
+  m_regexpCache.insert(make_pair(key, reg));
+  return reg;
+}
+
+void CScraperParser::InsertTokens(CStdString& strOutput, const CRegExpProgram &program)
+{
+  for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
+  {
+    if (program.clean[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
+    if (program.trim[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
+    if (program.fixChars[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
+    if (program.encode[iBuf])
+      InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
+  }
+}
+
 void CScraperParser::ReplaceBuffers(CStdString& strDest)
 {
   // insert buffers
@@ -169,76 +402,38 @@ void CScraperParser::ReplaceBuffers(CStdString& strDest)
     strDest.replace(strDest.begin()+iIndex,strDest.begin()+iIndex+2,"\n");
 }
 
-void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest, TiXmlElement* element, bool bAppend)
+void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest, const CRegExpProgram &program, bool bAppend)
 {
-  CStdString strOutput = element->Attribute("output");
-
-  TiXmlElement* pExpression = element->FirstChildElement("expression");
-  if (pExpression)
+  if (program.hasExpression)
   {
-    bool bInsensitive=true;
-    const char* sensitive = pExpression->Attribute("cs");
-    if (sensitive)
-      if (stricmp(sensitive,"yes") == 0)
-        bInsensitive=false; // match case sensitive
-
-    CRegExp reg(bInsensitive);
-    CStdString strExpression;
-    if (pExpression->FirstChild())
-      strExpression = pExpression->FirstChild()->Value();
-    else
-      strExpression = "(.*)";
-    ReplaceBuffers(strExpression);
-    ReplaceBuffers(strOutput);
-
-    if (!reg.RegComp(strExpression.c_str()))
+    CRegExp *reg = program.regexp;
+    if (program.expressionBuffers)
+    {
+      CStdString strExpression = program.expression;
+      ReplaceBuffers(strExpression);
+      reg = GetRegExp(strExpression, program.caseless);
+    }
+    if (!reg)
     {
       return;
     }
 
-    bool bRepeat = false;
-    const char* szRepeat = pExpression->Attribute("repeat");
-    if (szRepeat)
-      if (stricmp(szRepeat,"yes") == 0)
-        bRepeat = true;
-
-    const char* szClear = pExpression->Attribute("clear");
-    if (szClear)
-      if (stricmp(szClear,"yes") == 0)
-        dest=""; // clear no matter if regexp fails
-
-    bool bClean[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bClean,pExpression->Attribute("noclean"),true);
-
-    bool bTrim[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bTrim,pExpression->Attribute("trim"),false);
-
-    bool bFixChars[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bFixChars,pExpression->Attribute("fixchars"),false);
-
-    bool bEncode[MAX_SCRAPER_BUFFERS];
-    GetBufferParams(bEncode,pExpression->Attribute("encode"),false);
+    CStdString strOutput = program.output;
+    if (program.outputBuffers)
+    {
+      ReplaceBuffers(strOutput);
+      InsertTokens(strOutput, program);
+    }
 
-    int iOptional = -1;
-    pExpression->QueryIntAttribute("optional",&iOptional);
+    if (program.clear)
+      dest=""; // clear no matter if regexp fails
 
-    int iCompare = -1;
-    pExpression->QueryIntAttribute("compare",&iCompare);
+    int iOptional = program.optional;
+    int iCompare = program.compare;
     if (iCompare > -1)
       m_param[iCompare-1].ToLower();
     CStdString curInput = input;
-    for (int iBuf=0;iBuf<MAX_SCRAPER_BUFFERS;++iBuf)
-    {
-      if (bClean[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!CLEAN!!!");
-      if (bTrim[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!TRIM!!!");
-      if (bFixChars[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!FIXCHARS!!!");
-      if (bEncode[iBuf])
-        InsertToken(strOutput,iBuf+1,"!!!ENCODE!!!");
-    }
-    int i = reg.RegFind(curInput.c_str());
+    int i = reg->RegFind(curInput.c_str());
     while (i > -1 && (i < (int)curInput.size() || curInput.size() == 0))
     {
       if (!bAppend)
@@ -252,9 +447,8 @@ void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest,
       {
         char temp[4];
         sprintf(temp,"\\%i",iOptional);
-        char* szParam = reg.GetReplaceString(temp);
-        CRegExp reg2;
-        reg2.RegComp("(.*)(\\\\\\(.*\\\\2.*)\\\\\\)(.*)");
+        char* szParam = reg->GetReplaceString(temp);
+        CRegExp &reg2 = *m_optionalRegExp;
         int i2=reg2.RegFind(strCurOutput.c_str());
         while (i2 > -1)
         {
@@ -276,10 +470,10 @@ void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest,
         free(szParam);
       }
 
-      int iLen = reg.GetFindLen();
+      int iLen = reg->GetFindLen();
       // nasty hack #1 - & means \0 in a replace string
       strCurOutput.Replace("&","!!!AMPAMP!!!");
-      char* result = reg.GetReplaceString(strCurOutput.c_str());
+      char* result = reg->GetReplaceString(strCurOutput.c_str());
       if (result && strlen(result))
       {
         CStdString strResult(result);
@@ -298,10 +492,10 @@ void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest,
 
         free(result);
       }
-      if (bRepeat && iLen > 0)
+      if (program.repeat && iLen > 0)
       {
         curInput.erase(0,i+iLen>(int)curInput.size()?curInput.size():i+iLen);
-        i = reg.RegFind(curInput.c_str());
+        i = reg->RegFind(curInput.c_str());
       }
       else
         i = -1;
@@ -309,90 +503,60 @@ void CScraperParser::ParseExpression(const CStdString& input, CStdString& dest,
   }
 }
 
-void CScraperParser::ParseNext(TiXmlElement* element)
+void CScraperParser::ParseNext(const vector<CRegExpProgram *> &chain)
 {
-  TiXmlElement* pReg = element;
-  while (pReg)
+  for (vector<CRegExpProgram *>::const_iterator it = chain.begin(); it != chain.end(); ++it)
   {
-    TiXmlElement* pChildReg = pReg->FirstChildElement("RegExp");
-    if (pChildReg)
-      ParseNext(pChildReg);
-    else
+    const CRegExpProgram &reg = **it;
+    ParseNext(reg.children);
+
+    CStdString strInput;
+    if (reg.hasInput)
     {
-      TiXmlElement* pChildReg = pReg->FirstChildElement("clear");
-      if (pChildReg)
-        ParseNext(pChildReg);
+      strInput = reg.input;
+      if (reg.inputBuffers)
+        ReplaceBuffers(strInput);
     }
+    else
+      strInput = m_param[0];
 
-    int iDest = 1;
-    bool bAppend = false;
-    const char* szDest = pReg->Attribute("dest");
-    if (szDest)
-      if (strlen(szDest))
-      {
-        if (szDest[strlen(szDest)-1] == '+')
-          bAppend = true;
-
-        iDest = atoi(szDest);
-      }
+    bool bExecute = true;
+    if (reg.hasConditional)
+    {
+      CStdString strSetting;
+      if (m_scraper && m_scraper->HasSettings())
+         strSetting = m_scraper->GetSetting(reg.conditional);
+      bExecute = reg.inverse != strSetting.Equals("true");
+    }
 
-      const char *szInput = pReg->Attribute("input");
-      CStdString strInput;
-      if (szInput)
-      {
-        strInput = szInput;
-        ReplaceBuffers(strInput);
-      }
+    if (bExecute)
+    {
+      if (reg.dest-1 < MAX_SCRAPER_BUFFERS && reg.dest-1 > -1)
+        ParseExpression(strInput, m_param[reg.dest-1], reg, reg.append);
       else
-        strInput = m_param[0];
-
-      const char* szConditional = pReg->Attribute("conditional");
-      bool bExecute = true;
-      if (szConditional)
-      {
-        bool bInverse=false;
-        if (szConditional[0] == '!')
-        {
-          bInverse = true;
-          szConditional++;
-        }
-        CStdString strSetting;
-        if (m_scraper && m_scraper->HasSettings())
-           strSetting = m_scraper->GetSetting(szConditional);
-        bExecute = bInverse != strSetting.Equals("true");
-      }
-
-      if (bExecute)
-      {
-        if (iDest-1 < MAX_SCRAPER_BUFFERS && iDest-1 > -1)
-          ParseExpression(strInput, m_param[iDest-1],pReg,bAppend);
-        else
-          CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
-                             "out of bounds, skipping expression");
-      }
-
-      pReg = pReg->NextSiblingElement("RegExp");
+        CLog::Log(LOGERROR,"CScraperParser::ParseNext: destination buffer "
+                           "out of bounds, skipping expression");
+    }
   }
 }
 
 const CStdString CScraperParser::Parse(const CStdString& strTag,
                                        CScraper* scraper)
 {
-  TiXmlElement* pChildElement = m_pRootElement->FirstChildElement(strTag.c_str());
-  if(pChildElement == NULL)
+  if (!m_compiled)
+    Compile();
+
+  map<CStdString, CFunctionProgram>::const_iterator function = m_functions.find(strTag);
+  if (function == m_functions.end())
   {
     CLog::Log(LOGERROR,"%s: Could not find scraper function %s",__FUNCTION__,strTag.c_str());
     return "";
   }
-  int iResult = 1; // default to param 1
-  pChildElement->QueryIntAttribute("dest",&iResult);
-  TiXmlElement* pChildStart = pChildElement->FirstChildElement("RegExp");
   m_scraper = scraper;
-  ParseNext(pChildStart);
-  CStdString tmp = m_param[iResult-1];
+  ParseNext(function->second.regexps);
+  CStdString tmp = m_param[function->second.dest-1];
 
-  const char* szClearBuffers = pChildElement->Attribute("clearbuffers");
-  if (!szClearBuffers || stricmp(szClearBuffers,"no") != 0)
+  if (function->second.clearBuffers)
     ClearBuffers();
 
   return tmp;
@@ -479,8 +643,7 @@ void CScraperParser::RemoveWhiteSpace(CStdString &string)
 
 void CScraperParser::ConvertJSON(CStdString &string)
 {
-  CRegExp reg;
-  reg.RegComp("\\\\u([0-f]{4})");
+  CRegExp &reg = *m_unicodeRegExp;
   while (reg.RegFind(string.c_str()) > -1)
   {
     int pos = reg.GetSubStart(1);
@@ -493,8 +656,7 @@ void CScraperParser::ConvertJSON(CStdString &string)
     free(szReplace);
   }
 
-  CRegExp reg2;
-  reg2.RegComp("\\\\x([0-9]{2})([^\\\\]+;)");
+  CRegExp &reg2 = *m_hexRegExp;
   while (reg2.RegFind(string.c_str()) > -1)
   {
     int pos1 = reg2.GetSubStart(1);
@@ -557,5 +719,6 @@ void CScraperParser::AddDocument(const TiXmlDocument* doc)
     m_pRootElement->InsertEndChild(*node);
     node = node->NextSibling();
   }
+  ClearPrograms();
 }
 
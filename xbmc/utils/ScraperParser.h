@@ -23,6 +23,7 @@
  */
 
 #include <vector>
+#include <map>
 #include "StdString.h"
 #include "addons/IAddon.h"
 
@@ -37,6 +38,7 @@ class TiXmlElement;
 class TiXmlDocument;
 
 class CScraperSettings;
+class CRegExp;
 
 class CScraperParser
 {
@@ -56,13 +58,67 @@ public:
 
   void AddDocument(const TiXmlDocument* doc);
 
+  /*! \brief Compile the scraper functions of the loaded documents into programs run by Parse().
+   Attributes are parsed and expressions without buffer or setting references are compiled
+   up front, so Parse() no longer walks the XML. Called by CScraper once its dependencies
+   have been added - Parse() compiles on first use otherwise.
+   */
+  void Compile();
+
   CStdString m_param[MAX_SCRAPER_BUFFERS];
 
 private:
+  /*! \brief A compiled <RegExp> element along with the <RegExp> elements nested within it.
+   */
+  struct CRegExpProgram
+  {
+    CRegExpProgram();
+    ~CRegExpProgram();
+
+    std::vector<CRegExpProgram *> children; ///< run before this one
+    int         dest;
+    bool        append;
+    bool        hasInput;
+    bool        inputBuffers;        ///< input has buffer or setting references to replace
+    CStdString  input;
+    bool        hasConditional;
+    bool        inverse;
+    CStdString  conditional;
+
+    bool        hasExpression;
+    bool        expressionBuffers;
+    bool        outputBuffers;
+    CStdString  expression;
+    CStdString  output;              ///< with the clean/trim/fixchars/encode tokens inserted if outputBuffers is false
+    CRegExp    *regexp;              ///< compiled when expressionBuffers is false
+    bool        caseless;
+    bool        repeat;
+    bool        clear;
+    bool        clean[MAX_SCRAPER_BUFFERS];
+    bool        trim[MAX_SCRAPER_BUFFERS];
+    bool        fixChars[MAX_SCRAPER_BUFFERS];
+    bool        encode[MAX_SCRAPER_BUFFERS];
+    int         optional;
+    int         compare;
+  };
+
+  struct CFunctionProgram
+  {
+    int dest;
+    bool clearBuffers;
+    std::vector<CRegExpProgram *> regexps;
+  };
+
   bool LoadFromXML();
+  void ClearPrograms();
+  void CompileChain(TiXmlElement* element, std::vector<CRegExpProgram *> &chain);
+  CRegExpProgram *CompileRegExp(TiXmlElement* element);
+  static bool HasBufferReferences(const CStdString &str);
+  CRegExp *GetRegExp(const CStdString &expression, bool caseless);
+  void InsertTokens(CStdString& strOutput, const CRegExpProgram &program);
   void ReplaceBuffers(CStdString& strDest);
-  void ParseExpression(const CStdString& input, CStdString& dest, TiXmlElement* element, bool bAppend);
-  void ParseNext(TiXmlElement* element);
+  void ParseExpression(const CStdString& input, CStdString& dest, const CRegExpProgram &program, bool bAppend);
+  void ParseNext(const std::vector<CRegExpProgram *> &chain);
   void Clean(CStdString& strDirty);
   /*! \brief Remove spaces, tabs, and newlines from a string
    \param string the string in question, which will be modified.
@@ -80,6 +136,13 @@ private:
 
   CStdString m_strFile;
   ADDON::CScraper* m_scraper;
+
+  bool m_compiled;
+  std::map<CStdString, CFunctionProgram> m_functions;
+  std::map<CStdString, CRegExp *> m_regexpCache; ///< expressions built from buffers, keyed by case sensitivity and pattern
+  CRegExp *m_optionalRegExp;
+  CRegExp *m_unicodeRegExp;
+  CRegExp *m_hexRegExp;
 };
 
 #endif
@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "StringPool.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <string.h>
+
+using namespace std;
+
+CStringPool::CStringPool()
+{
+  m_generation = 0;
+  m_trimAt = TRIM_STRINGS;
+  memset(&m_stats, 0, sizeof(m_stats));
+}
+
+CStringPool &CStringPool::Get()
+{
+  static CStringPool pool;
+  return pool;
+}
+
+CStdString CStringPool::Intern(const CStdString &str)
+{
+  if (str.IsEmpty())
+    return str;
+
+  CStringPool &pool = Get();
+  CSingleLock lock(pool.m_section);
+  pool.m_stats.lookups++;
+  if (pool.m_strings.size() >= pool.m_trimAt)
+    pool.TrimLocked();
+
+  pair<Strings::iterator, bool> result = pool.m_strings.insert(make_pair(str, pool.m_generation));
+  if (result.second)
+  {
+    pool.m_stats.strings++;
+    pool.m_stats.bytes += str.size();
+  }
+  else
+    result.first->second = pool.m_generation;
+  return result.first->first;
+}
+
+void CStringPool::Trim()
+{
+  CStringPool &pool = Get();
+  CSingleLock lock(pool.m_section);
+  pool.TrimLocked();
+}
+
+void CStringPool::TrimLocked()
+{
+  unsigned int trimmed = 0;
+  for (Strings::iterator i = m_strings.begin(); i != m_strings.end();)
+  {
+    if (i->second != m_generation)
+    {
+      m_stats.bytes -= i->first.size();
+      m_strings.erase(i++);
+      trimmed++;
+    }
+    else
+      ++i;
+  }
+  m_stats.strings -= trimmed;
+  m_stats.trimmed += trimmed;
+  m_generation++;
+  m_trimAt = 2 * m_strings.size();
+  if (m_trimAt < TRIM_STRINGS)
+    m_trimAt = TRIM_STRINGS;
+  CLog::Log(LOGDEBUG, "CStringPool - trimmed %u strings, %u left", trimmed, (unsigned int)m_strings.size());
+}
+
+void CStringPool::GetStats(Stats &stats)
+{
+  CStringPool &pool = Get();
+  CSingleLock lock(pool.m_section);
+  stats = pool.m_stats;
+}
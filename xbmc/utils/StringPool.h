@@ -0,0 +1,77 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <map>
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+/*! \brief A pool of strings that are repeated across many items, such as icons, genres and artists.
+
+ Assigning the string returned by Intern() rather than the original lets every copy share the
+ pooled string's buffer where the string implementation is reference counted, so 100k songs by
+ the same artist hold one copy of the name rather than 100k.
+
+ Strings that haven't been looked up since the previous Trim() are dropped by the next one, which
+ is done after a library scan and whenever the pool has doubled in size. Items keep their own copies,
+ so a dropped string is only no longer shared with the items interned after it. Still, only values
+ with few distinct values should be interned - not labels, paths or thumbs that are mostly unique
+ to an item.
+ */
+class CStringPool
+{
+public:
+  struct Stats
+  {
+    unsigned int strings;  ///< distinct strings held
+    unsigned int bytes;    ///< characters held
+    unsigned int lookups;
+    unsigned int trimmed;  ///< strings dropped by Trim()
+  };
+
+  /*! \brief Get the pooled copy of a string, adding it to the pool if it isn't there already.
+   \param str the string to intern.
+   \return a copy of the pooled string, equal to str, taken under the pool's lock as a Trim() on
+   another thread may drop the pooled string once it's released.
+   */
+  static CStdString Intern(const CStdString &str);
+
+  /*! \brief Drop the strings that haven't been looked up since the previous trim.
+   */
+  static void Trim();
+
+  static void GetStats(Stats &stats);
+
+private:
+  CStringPool();
+  static CStringPool &Get();
+  void TrimLocked();
+
+  static const unsigned int TRIM_STRINGS = 65536; ///< the least number of strings that triggers a trim
+
+  typedef std::map<CStdString, unsigned int> Strings;
+
+  Strings              m_strings;    ///< each with the trim generation it was last looked up in
+  unsigned int         m_generation;
+  unsigned int         m_trimAt;     ///< trim when the pool holds this many strings
+  CCriticalSection     m_section;
+  Stats                m_stats;
+};
@@ -57,7 +57,10 @@ public:
   class CLogGlobals
   {
   public:
-    CLogGlobals() : m_file(NULL), m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG) {}
+    CLogGlobals() : m_file(NULL), m_repeatCount(0), m_repeatLogLevel(-1), m_logLevel(LOG_LEVEL_DEBUG)
+    {
+      critSec.set_name("CLog");
+    }
     FILE*       m_file;
     int         m_repeatCount;
     int         m_repeatLogLevel;
@@ -0,0 +1,230 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils/JobManager.h"
+#include "threads/Event.h"
+#include "threads/Atomics.h"
+
+#include <vector>
+
+//=============================================================================
+// Helper classes
+//=============================================================================
+
+static volatile long jobsRun = 0;
+static volatile long jobsDestroyed = 0;
+
+class counted_job : public CJob
+{
+public:
+  counted_job(CJob::CLASS jobClass = CJob::CLASS_COMPUTE, bool result = true, CEvent *gate = NULL)
+    : m_class(jobClass), m_result(result), m_gate(gate), m_prerequisites(0), m_ran(false) {}
+  virtual ~counted_job() { AtomicIncrement(&jobsDestroyed); }
+
+  virtual CLASS GetClass() const { return m_class; }
+  virtual bool operator==(const CJob *job) const { return job == this; } // CJobQueue finds its jobs by comparison
+  virtual bool DoWork()
+  {
+    if (m_gate)
+      m_gate->Wait();
+    m_ran = true;
+    AtomicIncrement(&jobsRun);
+    return m_result;
+  }
+  virtual bool OnPrerequisite(unsigned int jobID, bool success, const CJob *job)
+  {
+    // every prerequisite must have run before we hear of it
+    const counted_job *prerequisite = dynamic_cast<const counted_job *>(job);
+    if (!prerequisite || !prerequisite->m_ran)
+      return false;
+    m_prerequisites++;
+    return success;
+  }
+
+  CJob::CLASS  m_class;
+  bool         m_result;
+  CEvent      *m_gate;
+  unsigned int m_prerequisites;
+  bool         m_ran;
+};
+
+class completion_counter : public IJobCallback
+{
+public:
+  completion_counter(long expected) : succeeded(0), failed(0), prerequisites(0), pending(expected) {}
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    AtomicAdd(&prerequisites, ((counted_job *)job)->m_prerequisites);
+    AtomicIncrement(success ? &succeeded : &failed);
+    if (AtomicDecrement(&pending) == 0)
+      done.Set();
+  }
+
+  volatile long succeeded;
+  volatile long failed;
+  volatile long prerequisites;
+  volatile long pending;
+  CEvent done;
+};
+
+// continues each I/O job it runs with a compute job, as CTextureCache does
+class continuing_queue : public CJobQueue
+{
+public:
+  continuing_queue() : continued(0) {}
+  virtual ~continuing_queue() { CancelJobs(); }
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    if (((counted_job *)job)->m_class == CJob::CLASS_IO)
+      AddContinuation(jobID, new counted_job);
+    else if (AtomicIncrement(&continued) == 1)
+      done.Set();
+    CJobQueue::OnJobComplete(jobID, success, job);
+  }
+
+  volatile long continued;
+  CEvent done;
+};
+
+static void resetCounts()
+{
+  jobsRun = 0;
+  jobsDestroyed = 0;
+}
+
+static bool waitForDestroyed(long count, int milliseconds)
+{
+  CEvent never;
+  for (int i = 0; i < milliseconds && jobsDestroyed != count; i++)
+    never.WaitMSec(1);
+  return jobsDestroyed == count;
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestContinuation)
+{
+  resetCounts();
+  CJobManager &manager = CJobManager::GetInstance();
+  CEvent gate(true);
+  completion_counter callback(2);
+
+  // the gate holds the parent back, so the continuation is added while it's pending
+  unsigned int parent = manager.AddJob(new counted_job(CJob::CLASS_IO, true, &gate), &callback);
+  manager.AddContinuation(parent, new counted_job, &callback);
+  BOOST_CHECK_EQUAL(jobsRun, 0);
+
+  gate.Set();
+  BOOST_CHECK(callback.done.WaitMSec(10000));
+  BOOST_CHECK_EQUAL(callback.succeeded, 2);
+  BOOST_CHECK_EQUAL(callback.prerequisites, 1);
+  BOOST_CHECK(waitForDestroyed(2, 10000));
+}
+
+BOOST_AUTO_TEST_CASE(TestQueueContinuation)
+{
+  resetCounts();
+  continuing_queue queue;
+
+  queue.AddJob(new counted_job(CJob::CLASS_IO));
+  BOOST_CHECK(queue.done.WaitMSec(10000));
+  BOOST_CHECK_EQUAL(queue.continued, 1);
+  BOOST_CHECK_EQUAL(jobsRun, 2);
+  BOOST_CHECK(waitForDestroyed(2, 10000));
+}
+
+BOOST_AUTO_TEST_CASE(TestFailedPrerequisite)
+{
+  resetCounts();
+  CJobManager &manager = CJobManager::GetInstance();
+  CEvent gate(true);
+  completion_counter callback(3);
+
+  unsigned int parent = manager.AddJob(new counted_job(CJob::CLASS_IO, false, &gate), &callback);
+  unsigned int child = manager.AddContinuation(parent, new counted_job, &callback);
+  manager.AddContinuation(child, new counted_job, &callback);
+
+  gate.Set();
+  BOOST_CHECK(callback.done.WaitMSec(10000));
+  // only the parent ran, and the failure went down the chain
+  BOOST_CHECK_EQUAL(jobsRun, 1);
+  BOOST_CHECK_EQUAL(callback.failed, 3);
+  BOOST_CHECK(waitForDestroyed(3, 10000));
+}
+
+BOOST_AUTO_TEST_CASE(TestCancelParent)
+{
+  resetCounts();
+  CJobManager &manager = CJobManager::GetInstance();
+  CEvent gate(true);
+  completion_counter callback(1);
+
+  unsigned int parent = manager.AddJob(new counted_job(CJob::CLASS_IO, true, &gate), &callback);
+  std::vector<unsigned int> children;
+  for (int i = 0; i < 4; i++)
+    children.push_back(manager.AddContinuation(parent, new counted_job, &callback));
+  manager.AddJob(new counted_job, &callback, CJob::PRIORITY_LOW, children);
+
+  manager.CancelJob(parent);
+  gate.Set();
+
+  // the parent may have got as far as running, but nothing hears of it, and its dependents never run
+  BOOST_CHECK(waitForDestroyed(6, 10000));
+  BOOST_CHECK(jobsRun <= 1);
+  BOOST_CHECK_EQUAL(callback.succeeded + callback.failed, 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestFanOutFanInUnderLoad)
+{
+  static const int graphs = 50;
+  static const int width = 20;
+
+  resetCounts();
+  CJobManager &manager = CJobManager::GetInstance();
+  CEvent gate(true);
+  completion_counter callback(graphs * (width + 2));
+
+  // each graph is a root on the I/O pool fanning out to mostly compute jobs that all feed a join.
+  // The roots are held at the gate until every graph is in place.
+  for (int graph = 0; graph < graphs; graph++)
+  {
+    unsigned int root = manager.AddJob(new counted_job(CJob::CLASS_IO, true, &gate), &callback);
+    std::vector<unsigned int> branches;
+    for (int i = 0; i < width; i++)
+    {
+      CJob::CLASS jobClass = (i % 4) ? CJob::CLASS_COMPUTE : CJob::CLASS_IO;
+      branches.push_back(manager.AddContinuation(root, new counted_job(jobClass), &callback, CJob::PRIORITY(i % 3)));
+    }
+    manager.AddJob(new counted_job, &callback, CJob::PRIORITY_NORMAL, branches);
+  }
+
+  gate.Set();
+  BOOST_CHECK(callback.done.WaitMSec(30000));
+  BOOST_CHECK_EQUAL(callback.succeeded, graphs * (width + 2));
+  BOOST_CHECK_EQUAL(callback.failed, 0);
+  BOOST_CHECK_EQUAL(callback.prerequisites, graphs * width * 2);
+  BOOST_CHECK_EQUAL(jobsRun, graphs * (width + 2));
+  BOOST_CHECK(waitForDestroyed(graphs * (width + 2), 10000));
+}
@@ -0,0 +1,142 @@
+/*
+ *      Copyright (C) 2005-2012 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include "utils/StringPool.h"
+
+#include <set>
+#include <vector>
+
+//=============================================================================
+// Helpers
+//=============================================================================
+
+struct song
+{
+  CStdString artist;
+  CStdString album;
+  CStdString genre;
+};
+
+// a synthetic library of 100k songs by 2000 artists, 10 albums each, in 20 genres.
+// Every string is formatted afresh, as it would be when read from the database.
+static void buildLibrary(std::vector<song> &songs, bool intern)
+{
+  songs.resize(100000);
+  for (unsigned int i = 0; i < songs.size(); i++)
+  {
+    CStdString artist, album, genre;
+    artist.Format("Artist number %u", i % 2000);
+    album.Format("Album number %u by artist number %u", (i / 2000) % 10, i % 2000);
+    genre.Format("Genre %u", i % 20);
+    songs[i].artist = intern ? CStringPool::Intern(artist) : artist;
+    songs[i].album  = intern ? CStringPool::Intern(album) : album;
+    songs[i].genre  = intern ? CStringPool::Intern(genre) : genre;
+  }
+}
+
+// the characters held by the distinct buffers of the library's strings
+static unsigned int libraryBytes(const std::vector<song> &songs)
+{
+  std::set<const char *> buffers;
+  unsigned int bytes = 0;
+  for (unsigned int i = 0; i < songs.size(); i++)
+  {
+    const CStdString *strings[] = { &songs[i].artist, &songs[i].album, &songs[i].genre };
+    for (unsigned int j = 0; j < 3; j++)
+    {
+      if (buffers.insert(strings[j]->c_str()).second)
+        bytes += strings[j]->capacity();
+    }
+  }
+  return bytes;
+}
+
+static bool copiesShareBuffers()
+{
+  CStdString original("shared?");
+  CStdString copy(original);
+  return original.c_str() == copy.c_str();
+}
+
+//=============================================================================
+
+BOOST_AUTO_TEST_CASE(TestInternReturnsPooledString)
+{
+  CStdString first("DefaultFolder.png");
+  CStdString second("DefaultFolder.png");
+  CStdString a = CStringPool::Intern(first);
+  CStdString b = CStringPool::Intern(second);
+  BOOST_CHECK(a == first);
+  BOOST_CHECK(b == second);
+  // where copies share their buffer both are copies of the pooled string
+  if (copiesShareBuffers())
+  {
+    BOOST_CHECK(a.c_str() == b.c_str());
+    BOOST_CHECK(a.c_str() != first.c_str());
+  }
+  BOOST_CHECK(CStringPool::Intern("").IsEmpty());
+  BOOST_CHECK(CStringPool::Intern("DefaultFile.png") != a);
+}
+
+BOOST_AUTO_TEST_CASE(TestLibraryMemory)
+{
+  std::vector<song> songs;
+  buildLibrary(songs, false);
+  unsigned int plain = libraryBytes(songs);
+
+  buildLibrary(songs, true);
+  unsigned int interned = libraryBytes(songs);
+
+  CStringPool::Stats stats;
+  CStringPool::GetStats(stats);
+  BOOST_TEST_MESSAGE("100k songs hold " << plain << " bytes of strings, " << interned << " when interned ("
+                     << stats.strings << " strings, " << stats.bytes << " bytes in the pool)");
+
+  BOOST_CHECK_EQUAL(songs[4321].artist, "Artist number 321");
+  BOOST_CHECK_EQUAL(songs[4321].genre, "Genre 1");
+  // where copies share their buffer the library holds only the distinct strings
+  if (copiesShareBuffers())
+    BOOST_CHECK(interned * 10 < plain);
+}
+
+BOOST_AUTO_TEST_CASE(TestTrim)
+{
+  CStdString kept = CStringPool::Intern("Trim kept");
+  CStdString dropped = CStringPool::Intern("Trim dropped");
+  CStringPool::Trim(); // everything was looked up since the last trim
+
+  CStringPool::Stats before;
+  CStringPool::GetStats(before);
+  BOOST_CHECK(before.strings >= 2);
+
+  // only the string looked up again survives the next trim
+  CStringPool::Intern(kept);
+  CStringPool::Trim();
+
+  CStringPool::Stats after;
+  CStringPool::GetStats(after);
+  BOOST_CHECK(after.trimmed > before.trimmed);
+  BOOST_CHECK_EQUAL(after.strings + (after.trimmed - before.trimmed), before.strings);
+  BOOST_CHECK_EQUAL(after.bytes, (unsigned int)kept.size());
+  BOOST_CHECK_EQUAL(dropped, "Trim dropped"); // the copy is unaffected
+}
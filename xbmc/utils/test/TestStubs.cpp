@@ -0,0 +1,45 @@
+/*
+ *      Copyright (C) 2005-2011 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+
+// Stand-ins for the parts of the platform layer the tests pull in that would otherwise
+// drag the settings and the rest of xbmc along with them: logging, and the two time
+// functions of linux/XTimeUtils.cpp (whose local time conversions need g_timezone).
+
+#include "system.h"
+#include "utils/log.h"
+#include "linux/XTimeUtils.h"
+
+#include <unistd.h>
+
+void CLog::Log(int loglevel, const char *format, ...)
+{
+}
+
+void WINAPI Sleep(DWORD dwMilliSeconds)
+{
+  usleep(dwMilliSeconds * 1000);
+}
+
+BOOL TimeTToFileTime(time_t timeT, FILETIME* lpLocalFileTime)
+{
+  return FALSE;
+}
@@ -308,6 +308,8 @@ bool CVideoDatabase::CreateTables()
     m_pDS->exec("CREATE INDEX ixEpisodeBasePath ON episode ( c19(12) )");
     m_pDS->exec("CREATE INDEX ixTVShowBasePath on tvshow ( c17(12) )");
 
+    CreateTvShowCounts();
+
     // we create views last to ensure all indexes are rolled in
     CreateViews();
   }
@@ -336,24 +338,18 @@ void CVideoDatabase::CreateViews()
 
   CLog::Log(LOGINFO, "create tvshowview");
   m_pDS->exec("DROP VIEW IF EXISTS tvshowview");
+  // the counts are maintained in tvshowcounts rather than aggregated over the episodes on every query
   CStdString tvshowview = PrepareSQL("CREATE VIEW tvshowview AS SELECT "
                                      "tvshow.*,"
                                      "path.strPath AS strPath,"
-                                     "  NULLIF(COUNT(episode.c12), 0) AS totalCount,"
-                                     "  COUNT(files.playCount) AS watchedcount,"
-                                     "  NULLIF(COUNT(DISTINCT(episode.c12)), 0) AS totalSeasons "
+                                     "  NULLIF(tvshowcounts.totalCount, 0) AS totalCount,"
+                                     "  COALESCE(tvshowcounts.watchedCount, 0) AS watchedcount,"
+                                     "  NULLIF(tvshowcounts.totalSeasons, 0) AS totalSeasons "
                                      "FROM tvshow"
-                                     "  LEFT JOIN tvshowlinkpath ON"
-                                     "    tvshowlinkpath.idShow=tvshow.idShow"
+                                     "  LEFT JOIN tvshowcounts ON"
+                                     "    tvshowcounts.idShow=tvshow.idShow"
                                      "  LEFT JOIN path ON"
-                                     "    path.idPath=tvshowlinkpath.idPath"
-                                     "  LEFT JOIN tvshowlinkepisode ON"
-                                     "    tvshowlinkepisode.idShow=tvshow.idShow"
-                                     "  LEFT JOIN episode ON"
-                                     "    episode.idEpisode=tvshowlinkepisode.idEpisode"
-                                     "  LEFT JOIN files ON"
-                                     "    files.idFile=episode.idFile "
-                                     "GROUP BY tvshow.idShow;");
+                                     "    path.idPath=(SELECT MIN(idPath) FROM tvshowlinkpath WHERE tvshowlinkpath.idShow=tvshow.idShow)");
   m_pDS->exec(tvshowview.c_str());
 
   CLog::Log(LOGINFO, "create musicvideoview");
@@ -380,6 +376,115 @@ void CVideoDatabase::CreateViews()
   m_pDS->exec(movieview.c_str());
 }
 
+CStdString CVideoDatabase::GetTvShowCountsSQL(const CStdString &where) const
+{
+  CStdString sql = PrepareSQL("SELECT tvshow.idShow, COUNT(episode.c%02d), COUNT(files.playCount), COUNT(DISTINCT episode.c%02d) "
+                              "FROM tvshow"
+                              "  LEFT JOIN tvshowlinkepisode ON"
+                              "    tvshowlinkepisode.idShow=tvshow.idShow"
+                              "  LEFT JOIN episode ON"
+                              "    episode.idEpisode=tvshowlinkepisode.idEpisode"
+                              "  LEFT JOIN files ON"
+                              "    files.idFile=episode.idFile ", VIDEODB_ID_EPISODE_SEASON, VIDEODB_ID_EPISODE_SEASON);
+  if (!where.IsEmpty())
+    sql += "WHERE " + where + " ";
+  sql += "GROUP BY tvshow.idShow";
+  return sql;
+}
+
+void CVideoDatabase::CreateTvShowCounts()
+{
+  CLog::Log(LOGINFO, "create tvshowcounts table");
+  m_pDS->exec("CREATE TABLE tvshowcounts ( idShow integer primary key, totalCount integer, watchedCount integer, totalSeasons integer)\n");
+
+  // each trigger is a single statement recomputing the counts of the affected shows, as mysql doesn't take BEGIN/END blocks
+  CStdString replace = "REPLACE INTO tvshowcounts (idShow, totalCount, watchedCount, totalSeasons) ";
+  CLog::Log(LOGINFO, "create tvshowcounts triggers");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsShowInsert AFTER insert ON tvshow FOR EACH ROW BEGIN "
+              "REPLACE INTO tvshowcounts (idShow, totalCount, watchedCount, totalSeasons) VALUES (new.idShow, 0, 0, 0); END");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsShowDelete AFTER delete ON tvshow FOR EACH ROW BEGIN "
+              "delete from tvshowcounts where idShow=old.idShow; END");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsLinkInsert AFTER insert ON tvshowlinkepisode FOR EACH ROW BEGIN " +
+              replace + GetTvShowCountsSQL("tvshow.idShow=new.idShow") + "; END");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsLinkDelete AFTER delete ON tvshowlinkepisode FOR EACH ROW BEGIN " +
+              replace + GetTvShowCountsSQL("tvshow.idShow=old.idShow") + "; END");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsEpisodeUpdate AFTER update ON episode FOR EACH ROW BEGIN " +
+              replace + GetTvShowCountsSQL("tvshow.idShow IN (SELECT idShow FROM tvshowlinkepisode WHERE idEpisode=new.idEpisode)") + "; END");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsEpisodeDelete AFTER delete ON episode FOR EACH ROW BEGIN " +
+              replace + GetTvShowCountsSQL("tvshow.idShow IN (SELECT idShow FROM tvshowlinkepisode WHERE idEpisode=old.idEpisode)") + "; END");
+  m_pDS->exec("CREATE TRIGGER tgrTvShowCountsFileUpdate AFTER update ON files FOR EACH ROW BEGIN " +
+              replace + GetTvShowCountsSQL("tvshow.idShow IN (SELECT tvshowlinkepisode.idShow FROM tvshowlinkepisode JOIN episode ON episode.idEpisode=tvshowlinkepisode.idEpisode WHERE episode.idFile=new.idFile)") + "; END");
+}
+
+bool CVideoDatabase::CheckTvShowCounts()
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    map<int, vector<int> > counts;
+    m_pDS->query("SELECT idShow, totalCount, watchedCount, totalSeasons FROM tvshowcounts");
+    while (!m_pDS->eof())
+    {
+      vector<int> &count = counts[m_pDS->fv(0).get_asInt()];
+      for (int i = 1; i <= 3; i++)
+        count.push_back(m_pDS->fv(i).get_asInt());
+      m_pDS->next();
+    }
+    m_pDS->close();
+
+    int inconsistent = 0;
+    m_pDS->query(GetTvShowCountsSQL("").c_str());
+    while (!m_pDS->eof())
+    {
+      map<int, vector<int> >::iterator count = counts.find(m_pDS->fv(0).get_asInt());
+      if (count == counts.end() ||
+          count->second[0] != m_pDS->fv(1).get_asInt() ||
+          count->second[1] != m_pDS->fv(2).get_asInt() ||
+          count->second[2] != m_pDS->fv(3).get_asInt())
+        inconsistent++;
+      if (count != counts.end())
+        counts.erase(count);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    inconsistent += counts.size(); // counts of shows that no longer exist
+
+    if (inconsistent == 0)
+      return true;
+
+    CLog::Log(LOGWARNING, "%s: counts of %i tvshows are inconsistent, rebuilding", __FUNCTION__, inconsistent);
+    RebuildTvShowCounts();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+void CVideoDatabase::RebuildTvShowCounts()
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return;
+    if (NULL == m_pDS.get()) return;
+
+    unsigned int time = XbmcThreads::SystemClockMillis();
+    BeginTransaction();
+    m_pDS->exec("DELETE FROM tvshowcounts");
+    m_pDS->exec(("INSERT INTO tvshowcounts (idShow, totalCount, watchedCount, totalSeasons) " + GetTvShowCountsSQL("")).c_str());
+    CommitTransaction();
+    CLog::Log(LOGDEBUG, "%s took %d ms", __FUNCTION__, XbmcThreads::SystemClockMillis() - time);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+    RollbackTransaction();
+  }
+}
+
 //********************************************************************************************************************************
 int CVideoDatabase::GetPathId(const CStdString& strPath)
 {
@@ -2696,6 +2801,83 @@ CVideoInfoTag CVideoDatabase::GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, i
   return details;
 }
 
+// reads the current row of a "SELECT * FROM streamdetails" query
+static bool AddStreamDetail(Dataset *pDS, CStreamDetails &details)
+{
+  CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
+  switch (e)
+  {
+  case CStreamDetail::VIDEO:
+    {
+      CStreamDetailVideo *p = new CStreamDetailVideo();
+      p->m_strCodec = pDS->fv(2).get_asString();
+      p->m_fAspect = pDS->fv(3).get_asFloat();
+      p->m_iWidth = pDS->fv(4).get_asInt();
+      p->m_iHeight = pDS->fv(5).get_asInt();
+      p->m_iDuration = pDS->fv(10).get_asInt();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::AUDIO:
+    {
+      CStreamDetailAudio *p = new CStreamDetailAudio();
+      p->m_strCodec = pDS->fv(6).get_asString();
+      if (pDS->fv(7).get_isNull())
+        p->m_iChannels = -1;
+      else
+        p->m_iChannels = pDS->fv(7).get_asInt();
+      p->m_strLanguage = pDS->fv(8).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  case CStreamDetail::SUBTITLE:
+    {
+      CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
+      p->m_strLanguage = pDS->fv(9).get_asString();
+      details.AddStream(p);
+      return true;
+    }
+  }
+  return false;
+}
+
+static void FinishStreamDetails(CVideoInfoTag& tag)
+{
+  tag.m_streamDetails.DetermineBestStreams();
+
+  if (tag.m_streamDetails.GetVideoDuration() > 0)
+    tag.m_strRuntime.Format("%i", tag.m_streamDetails.GetVideoDuration() / 60 );
+}
+
+// number of files queried at once by the batch loaders
+#define FILE_DETAILS_CHUNK 500
+
+typedef map<int, vector<CVideoInfoTag *> > FileTagMap;
+
+static void GetFileTags(CFileItemList& items, int start, FileTagMap &tags)
+{
+  for (int i = start; i < items.Size(); i++)
+  {
+    CVideoInfoTag *tag = items[i]->GetVideoInfoTag();
+    if (tag->m_iFileId >= 0)
+      tags[tag->m_iFileId].push_back(tag);
+  }
+}
+
+// builds "idFile IN (...)" for the next chunk of files, advancing it
+static CStdString GetFileChunk(FileTagMap::const_iterator &it, const FileTagMap::const_iterator &end)
+{
+  CStdString where = "idFile IN (";
+  for (int count = 0; it != end && count < FILE_DETAILS_CHUNK; ++it, ++count)
+  {
+    if (count)
+      where += ",";
+    where.AppendFormat("%i", it->first);
+  }
+  where += ")";
+  return where;
+}
+
 bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
 {
   if (tag.m_iFileId < 0)
@@ -2711,54 +2893,103 @@ bool CVideoDatabase::GetStreamDetails(CVideoInfoTag& tag) const
   details.Reset();
   while (!pDS->eof())
   {
-    CStreamDetail::StreamType e = (CStreamDetail::StreamType)pDS->fv(1).get_asInt();
-    switch (e)
+    if (AddStreamDetail(pDS.get(), details))
+      retVal = true;
+
+    pDS->next();
+  }
+
+  pDS->close();
+  FinishStreamDetails(tag);
+
+  return retVal;
+}
+
+void CVideoDatabase::GetStreamDetails(CFileItemList& items, int start /* = 0 */) const
+{
+  FileTagMap tags;
+  GetFileTags(items, start, tags);
+  if (tags.empty())
+    return;
+
+  try
+  {
+    auto_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    for (FileTagMap::const_iterator it = tags.begin(); it != tags.end(); )
     {
-    case CStreamDetail::VIDEO:
+      FileTagMap::const_iterator chunk = it;
+      CStdString strSQL = "SELECT * FROM streamdetails WHERE " + GetFileChunk(it, tags.end());
+      for (; chunk != it; ++chunk)
       {
-        CStreamDetailVideo *p = new CStreamDetailVideo();
-        p->m_strCodec = pDS->fv(2).get_asString();
-        p->m_fAspect = pDS->fv(3).get_asFloat();
-        p->m_iWidth = pDS->fv(4).get_asInt();
-        p->m_iHeight = pDS->fv(5).get_asInt();
-        p->m_iDuration = pDS->fv(10).get_asInt();
-        details.AddStream(p);
-        retVal = true;
-        break;
+        for (vector<CVideoInfoTag *>::const_iterator tag = chunk->second.begin(); tag != chunk->second.end(); ++tag)
+          (*tag)->m_streamDetails.Reset();
       }
-    case CStreamDetail::AUDIO:
-      {
-        CStreamDetailAudio *p = new CStreamDetailAudio();
-        p->m_strCodec = pDS->fv(6).get_asString();
-        if (pDS->fv(7).get_isNull())
-          p->m_iChannels = -1;
-        else
-          p->m_iChannels = pDS->fv(7).get_asInt();
-        p->m_strLanguage = pDS->fv(8).get_asString();
-        details.AddStream(p);
-        retVal = true;
-        break;
-      }
-    case CStreamDetail::SUBTITLE:
+      pDS->query(strSQL.c_str());
+      while (!pDS->eof())
       {
-        CStreamDetailSubtitle *p = new CStreamDetailSubtitle();
-        p->m_strLanguage = pDS->fv(9).get_asString();
-        details.AddStream(p);
-        retVal = true;
-        break;
+        FileTagMap::const_iterator file = tags.find(pDS->fv(0).get_asInt());
+        if (file != tags.end())
+        {
+          for (vector<CVideoInfoTag *>::const_iterator tag = file->second.begin(); tag != file->second.end(); ++tag)
+            AddStreamDetail(pDS.get(), (*tag)->m_streamDetails);
+        }
+        pDS->next();
       }
+      pDS->close();
     }
-
-    pDS->next();
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
   }
 
-  pDS->close();
-  details.DetermineBestStreams();
+  for (FileTagMap::const_iterator file = tags.begin(); file != tags.end(); ++file)
+  {
+    for (vector<CVideoInfoTag *>::const_iterator tag = file->second.begin(); tag != file->second.end(); ++tag)
+      FinishStreamDetails(**tag);
+  }
+}
 
-  if (details.GetVideoDuration() > 0)
-    tag.m_strRuntime.Format("%i", details.GetVideoDuration() / 60 );
+void CVideoDatabase::GetResumePoints(CFileItemList& items, int start /* = 0 */) const
+{
+  FileTagMap tags;
+  GetFileTags(items, start, tags);
+  if (tags.empty())
+    return;
 
-  return retVal;
+  try
+  {
+    auto_ptr<Dataset> pDS(m_pDB->CreateDataset());
+    for (FileTagMap::const_iterator it = tags.begin(); it != tags.end(); )
+    {
+      CStdString strSQL = PrepareSQL("select idFile, timeInSeconds, totalTimeInSeconds from bookmark where type=%i and ", CBookmark::RESUME);
+      strSQL += GetFileChunk(it, tags.end()) + " order by idFile, timeInSeconds";
+      pDS->query(strSQL.c_str());
+      int lastFile = -1;
+      while (!pDS->eof())
+      {
+        // the first (earliest) resume point of each file is the one that's used
+        int idFile = pDS->fv(0).get_asInt();
+        FileTagMap::const_iterator file = tags.find(idFile);
+        if (idFile != lastFile && file != tags.end())
+        {
+          for (vector<CVideoInfoTag *>::const_iterator tag = file->second.begin(); tag != file->second.end(); ++tag)
+          {
+            (*tag)->m_resumePoint.timeInSeconds = pDS->fv(1).get_asDouble();
+            (*tag)->m_resumePoint.totalTimeInSeconds = pDS->fv(2).get_asDouble();
+            (*tag)->m_resumePoint.type = CBookmark::RESUME;
+          }
+        }
+        lastFile = idFile;
+        pDS->next();
+      }
+      pDS->close();
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
 }
  
 bool CVideoDatabase::GetResumePoint(CVideoInfoTag& tag) const
@@ -2787,7 +3018,7 @@ bool CVideoDatabase::GetResumePoint(CVideoInfoTag& tag) const
   return match;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool needsCast /* = false */)
+CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool needsCast /* = false */, bool needsFileDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2801,7 +3032,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMovie(auto_ptr<Dataset> &pDS, bool ne
   GetCommonDetails(pDS, details);
   movieTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
 
-  GetStreamDetails(details);
+  if (needsFileDetails)
+    GetStreamDetails(details);
 
   if (needsCast)
   {
@@ -2891,7 +3123,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForTvShow(auto_ptr<Dataset> &pDS, bool n
   return details;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool needsCast /* = false */)
+CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool needsCast /* = false */, bool needsFileDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2911,7 +3143,8 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool
   details.m_iIdShow = pDS->fv(VIDEODB_DETAILS_EPISODE_TVSHOW_ID).get_asInt();
   details.m_strShowPath = pDS->fv(VIDEODB_DETAILS_EPISODE_TVSHOW_PATH).get_asString();
 
-  GetStreamDetails(details);
+  if (needsFileDetails)
+    GetStreamDetails(details);
 
   if (needsCast)
   {
@@ -2964,7 +3197,7 @@ CVideoInfoTag CVideoDatabase::GetDetailsForEpisode(auto_ptr<Dataset> &pDS, bool
   return details;
 }
 
-CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(auto_ptr<Dataset> &pDS)
+CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(auto_ptr<Dataset> &pDS, bool needsFileDetails /* = true */)
 {
   CVideoInfoTag details;
   details.Reset();
@@ -2977,8 +3210,11 @@ CVideoInfoTag CVideoDatabase::GetDetailsForMusicVideo(auto_ptr<Dataset> &pDS)
   GetCommonDetails(pDS, details);
   movieTime += XbmcThreads::SystemClockMillis() - time; time = XbmcThreads::SystemClockMillis();
 
-  GetStreamDetails(details);
-  GetResumePoint(details);
+  if (needsFileDetails)
+  {
+    GetStreamDetails(details);
+    GetResumePoint(details);
+  }
 
   details.m_strPictureURL.Parse();
   return details;
@@ -3484,6 +3720,11 @@ bool CVideoDatabase::UpdateOldVersion(int iVersion)
       m_pDS->exec("UPDATE settings SET DeinterlaceMode = 1 WHERE Deinterlace = 1"); // method auto => mode auto
       m_pDS->exec("UPDATE settings SET DeinterlaceMode = 0, Deinterlace = 1 WHERE Deinterlace = 0"); // method none => mode off, method auto
     }
+    if (iVersion < 59)
+    {
+      CreateTvShowCounts();
+      m_pDS->exec(("INSERT INTO tvshowcounts (idShow, totalCount, watchedCount, totalSeasons) " + GetTvShowCountsSQL("")).c_str());
+    }
 
     // always recreate the view after any table change
     CreateViews();
@@ -4728,10 +4969,11 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const CStdSt
       return iRowsFound == 0;
 
     // get data from returned rows
-    items.Reserve(iRowsFound);
+    int start = items.Size();
+    items.Reserve(start + iRowsFound);
     while (!m_pDS->eof())
     {
-      CVideoInfoTag movie = GetDetailsForMovie(m_pDS);
+      CVideoInfoTag movie = GetDetailsForMovie(m_pDS, false, false);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                   ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, g_settings.m_videoSources))
@@ -4747,6 +4989,7 @@ bool CVideoDatabase::GetMoviesByWhere(const CStdString& strBaseDir, const CStdSt
 
     // cleanup
     m_pDS->close();
+    GetStreamDetails(items, start);
     return true;
   }
   catch (...)
@@ -5068,13 +5311,14 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
       return iRowsFound == 0;
 
     // get data from returned rows
-    items.Reserve(iRowsFound);
+    int start = items.Size();
+    items.Reserve(start + iRowsFound);
     while (!m_pDS->eof())
     {
       int idEpisode = m_pDS->fv("idEpisode").get_asInt();
       int idShow = m_pDS->fv("idShow").get_asInt();
 
-      CVideoInfoTag movie = GetDetailsForEpisode(m_pDS);
+      CVideoInfoTag movie = GetDetailsForEpisode(m_pDS, false, false);
       if (g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE ||
           g_passwordManager.bMasterUser                                     ||
           g_passwordManager.IsDatabasePathUnlocked(movie.m_strPath, g_settings.m_videoSources))
@@ -5096,6 +5340,7 @@ bool CVideoDatabase::GetEpisodesByWhere(const CStdString& strBaseDir, const CStd
 
     // cleanup
     m_pDS->close();
+    GetStreamDetails(items, start);
     return true;
   }
   catch (...)
@@ -5881,12 +6126,13 @@ bool CVideoDatabase::GetMusicVideosByWhere(const CStdString &baseDir, const CStd
     }
 
     // get data from returned rows
-    items.Reserve(iRowsFound);
+    int start = items.Size();
+    items.Reserve(start + iRowsFound);
     // get songs from returned subtable
     while (!m_pDS->eof())
     {
       int idMVideo = m_pDS->fv("idMVideo").get_asInt();
-      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(m_pDS);
+      CVideoInfoTag musicvideo = GetDetailsForMusicVideo(m_pDS, false);
       if (!checkLocks || g_settings.GetMasterProfile().getLockMode() == LOCK_MODE_EVERYONE || g_passwordManager.bMasterUser ||
           g_passwordManager.IsDatabasePathUnlocked(musicvideo.m_strPath,g_settings.m_videoSources))
       {
@@ -5903,6 +6149,9 @@ bool CVideoDatabase::GetMusicVideosByWhere(const CStdString &baseDir, const CStd
 
     // cleanup
     m_pDS->close();
+    GetStreamDetails(items, start);
+    GetResumePoints(items, start);
+    CLog::Log(LOGDEBUG, "%s time to retrieve stream details and resume points = %d", __FUNCTION__, XbmcThreads::SystemClockMillis() - time);
     return true;
   }
   catch (...)
@@ -6793,6 +7042,8 @@ void CVideoDatabase::CleanDatabase(IVideoInfoScannerObserver* pObserver, const v
 
     CommitTransaction();
 
+    CheckTvShowCounts();
+
     if (pObserver)
       pObserver->OnStateChanged(COMPRESSING_DATABASE);
 
@@ -550,6 +550,17 @@ public:
 
   void CleanDatabase(VIDEO::IVideoInfoScannerObserver* pObserver=NULL, const std::vector<int>* paths=NULL);
 
+  /*! \brief Check the materialized per tvshow episode, watched and season counts against the episodes.
+   The counts are kept up to date by triggers, so this should only find anything after the database
+   was modified externally. Inconsistent counts are rebuilt.
+   \return true if the counts were consistent.
+   */
+  bool CheckTvShowCounts();
+
+  /*! \brief Recompute the materialized counts of all tvshows.
+   */
+  void RebuildTvShowCounts();
+
   /*! \brief Add a file to the database, if necessary
    If the file is already in the database, we simply return its id.
    \param url - full path of the file to add.
@@ -669,10 +680,14 @@ protected:
 
   void DeleteStreamDetails(int idFile);
   CVideoInfoTag GetDetailsByTypeAndId(VIDEODB_CONTENT_TYPE type, int id);
-  CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
+  /*! \brief Fill in the details of the current row of a movie, episode or music video view.
+   \param needsFileDetails whether to query the stream details (and resume point for music videos) of the file.
+   Listings pass false and fetch them for all items at once with GetStreamDetails(CFileItemList&) and GetResumePoints().
+   */
+  CVideoInfoTag GetDetailsForMovie(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false, bool needsFileDetails = true);
   CVideoInfoTag GetDetailsForTvShow(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
-  CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false);
-  CVideoInfoTag GetDetailsForMusicVideo(std::auto_ptr<dbiplus::Dataset> &pDS);
+  CVideoInfoTag GetDetailsForEpisode(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsCast = false, bool needsFileDetails = true);
+  CVideoInfoTag GetDetailsForMusicVideo(std::auto_ptr<dbiplus::Dataset> &pDS, bool needsFileDetails = true);
   void GetCommonDetails(std::auto_ptr<dbiplus::Dataset> &pDS, CVideoInfoTag &details);
   bool GetPeopleNav(const CStdString& strBaseDir, CFileItemList& items, const CStdString& type, int idContent=-1);
   bool GetNavCommon(const CStdString& strBaseDir, CFileItemList& items, const CStdString& type, int idContent=-1);
@@ -681,6 +696,14 @@ protected:
   CStdString GetValueString(const CVideoInfoTag &details, int min, int max, const SDbTableOffsets *offsets) const;
   bool GetStreamDetails(CVideoInfoTag& tag) const;
 
+  /*! \brief Batch loaders for the per-file tables of a listing.
+   Each runs one query per chunk of files rather than one per item.
+   \param items the listing to fill in.
+   \param start the index of the first item to fill in, earlier items are left alone.
+   */
+  void GetStreamDetails(CFileItemList& items, int start = 0) const;
+  void GetResumePoints(CFileItemList& items, int start = 0) const;
+
 private:
   virtual bool CreateTables();
   virtual bool UpdateOldVersion(int version);
@@ -690,6 +713,15 @@ private:
    */
   virtual void CreateViews();
 
+  /*! \brief Create the tvshowcounts table along with the triggers keeping it up to date
+   */
+  void CreateTvShowCounts();
+
+  /*! \brief Build the query computing the tvshowcounts rows of some tvshows from their episodes
+   \param where the tvshows to compute, eg "tvshow.idShow=new.idShow". Empty for all of them.
+   */
+  CStdString GetTvShowCountsSQL(const CStdString &where) const;
+
   /*! \brief Run a query on the main dataset and return the number of rows
    If no rows are found we close the dataset and return 0.
    \param sql the sql query to run
@@ -721,7 +753,7 @@ private:
    */
   bool LookupByFolders(const CStdString &path, bool shows = false);
 
-  virtual int GetMinVersion() const { return 58; };
+  virtual int GetMinVersion() const { return 59; };
   virtual int GetExportVersion() const { return 1; };
   const char *GetBaseDBName() const { return "MyVideos"; };
 
@@ -24,6 +24,7 @@
 #include "VideoInfoScanner.h"
 #include "addons/AddonManager.h"
 #include "filesystem/DirectoryCache.h"
+#include "filesystem/FileStatCache.h"
 #include "Util.h"
 #include "NfoFile.h"
 #include "utils/RegExp.h"
@@ -41,6 +42,7 @@
 #include "settings/GUISettings.h"
 #include "settings/Settings.h"
 #include "utils/StringUtils.h"
+#include "utils/StringPool.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
@@ -74,6 +76,7 @@ namespace VIDEO
     try
     {
       unsigned int tick = XbmcThreads::SystemClockMillis();
+      g_fileStatCache.ResetStats();
 
       m_database.Open();
 
@@ -125,6 +128,8 @@ namespace VIDEO
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Finished scan. Scanning for video info took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      g_fileStatCache.LogStats("VideoInfoScanner");
+      CStringPool::Trim();
 
       m_bRunning = false;
       if (m_pObserver)
@@ -1595,6 +1600,7 @@ namespace VIDEO
     // used for checking for a season[ ._-](number).tbn
     CFileItemList tbnItems;
     CDirectory::GetDirectory(showDir, tbnItems, ".tbn");
+    vector< pair<CStdString, CStdString> > downloads;
     for (int i=0;i<items.Size();++i)
     {
       if (overwrite || !items[i]->HasThumbnail())
@@ -1624,14 +1630,16 @@ namespace VIDEO
           }
         }
         if (bDownload)
-          DownloadImage(CScraperUrl::GetThumbURL(movie.m_strPictureURL.GetSeasonThumb(items[i]->GetVideoInfoTag()->m_iSeason)), items[i]->GetCachedSeasonThumb());
+          downloads.push_back(make_pair(CScraperUrl::GetThumbURL(movie.m_strPictureURL.GetSeasonThumb(items[i]->GetVideoInfoTag()->m_iSeason)), items[i]->GetCachedSeasonThumb()));
       }
     }
+    CPicture::CacheThumbs(downloads);
     m_database.Close();
   }
 
   void CVideoInfoScanner::FetchActorThumbs(const vector<SActorInfo>& actors, const CStdString& strPath)
   {
+    vector< pair<CStdString, CStdString> > downloads;
     for (unsigned int i=0;i<actors.size();++i)
     {
       CFileItem item;
@@ -1646,9 +1654,10 @@ namespace VIDEO
         if (CFile::Exists(strLocal))
           CPicture::CreateThumbnail(strLocal, strThumb);
         else if (!actors[i].thumbUrl.GetFirstThumb().m_url.IsEmpty())
-          DownloadImage(CScraperUrl::GetThumbURL(actors[i].thumbUrl.GetFirstThumb()), strThumb);
+          downloads.push_back(make_pair(CScraperUrl::GetThumbURL(actors[i].thumbUrl.GetFirstThumb()), strThumb));
       }
     }
+    CPicture::CacheThumbs(downloads);
   }
 
   CNfoFile::NFOResult CVideoInfoScanner::CheckForNFOFile(CFileItem* pItem, bool bGrabAny, ScraperPtr& info, CScraperUrl& scrUrl)
@@ -2016,3 +2016,8 @@ void CGUIWindowVideoBase::OnAssignContent(const CStdString &path, int iFound, AD
     }
   }
 }
+
+void CGUIWindowVideoBase::OnVisibleRange(int first, int count)
+{
+  m_thumbLoader.SetVisibleRange(*m_vecItems, first, count);
+}
@@ -69,6 +69,7 @@ public:
   static CStdString GetResumeString(CFileItem item);
 
 protected:
+  virtual void OnVisibleRange(int first, int count);
   void OnScan(const CStdString& strPath, bool scanAll = false);
   virtual void UpdateButtons();
   virtual bool Update(const CStdString &strDirectory);
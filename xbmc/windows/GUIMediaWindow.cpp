@@ -141,6 +141,14 @@ void CGUIMediaWindow::OnWindowUnload()
   m_viewControl.Reset();
 }
 
+void CGUIMediaWindow::FrameMove()
+{
+  int first, count;
+  if (m_viewControl.GetVisibleRange(first, count))
+    OnVisibleRange(first, count);
+  CGUIWindow::FrameMove();
+}
+
 CFileItemPtr CGUIMediaWindow::GetCurrentListItem(int offset)
 {
   int item = m_viewControl.GetSelectedItem();
@@ -41,6 +41,7 @@ public:
   virtual void OnWindowLoaded();
   virtual void OnWindowUnload();
   virtual void OnInitWindow();
+  virtual void FrameMove();
   virtual bool IsMediaWindow() const { return true; };
   const CFileItemList &CurrentDirectory() const;
   int GetViewContainerID() const { return m_viewControl.GetCurrentControl(); };
@@ -71,6 +72,13 @@ protected:
   virtual void OnPrepareFileItems(CFileItemList &items);
   virtual void OnFinalizeFileItems(CFileItemList &items);
 
+  /*! \brief Called each frame with the items on screen, so that background loaders can start with those
+   \param first index of the first visible item in m_vecItems
+   \param count number of visible items
+   \sa CBackgroundInfoLoader::SetVisibleRange
+   */
+  virtual void OnVisibleRange(int first, int count) {};
+
   void ClearFileItems();
   virtual void SortItems(CFileItemList &items);
 
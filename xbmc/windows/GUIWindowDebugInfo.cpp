@@ -30,8 +30,10 @@
 #include "guilib/GUIControlFactory.h"
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUITextLayout.h"
+#include "guilib/GUITexture.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/GUIControlProfiler.h"
+#include "guilib/GUIFrameProfiler.h"
 #include "GUIInfoManager.h"
 #include "utils/Variant.h"
 
@@ -40,6 +42,7 @@ CGUIWindowDebugInfo::CGUIWindowDebugInfo(void)
 {
   m_needsScaling = false;
   m_layout = NULL;
+  m_layoutHits = m_layoutMisses = 0;
   m_renderOrder = INT_MAX - 2;
 }
 
@@ -57,10 +60,17 @@ void CGUIWindowDebugInfo::UpdateVisibility()
 
 bool CGUIWindowDebugInfo::OnMessage(CGUIMessage &message)
 {
-  if (message.GetMessage() == GUI_MSG_WINDOW_DEINIT)
+  if (message.GetMessage() == GUI_MSG_WINDOW_INIT)
+  { // record subsystem timings while we're shown, unless a capture is already running
+    if (!CGUIFrameProfiler::IsRunning())
+      CGUIFrameProfiler::Instance().Start();
+  }
+  else if (message.GetMessage() == GUI_MSG_WINDOW_DEINIT)
   {
     delete m_layout;
     m_layout = NULL;
+    if (CGUIFrameProfiler::Instance().GetMaxFrameCount() == 0)
+      CGUIFrameProfiler::Instance().Stop();
   }
   return CGUIDialog::OnMessage(message);
 }
@@ -110,6 +120,23 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
     info.Format("LOG: %sxbmc.log\nMEM: %"PRIu64"/%"PRIu64" KB - FPS: %2.1f fps\nCPU: %s (CPU-XBMC %4.2f%%%s)", g_settings.m_logFolder.c_str(),
                 stat.ullAvailPhys/1024, stat.ullTotalPhys/1024, g_infoManager.GetFPS(), strCores.c_str(), dCPU, profiling.c_str());
 #endif
+
+    // text layout cache usage over the last frame
+    unsigned int hits, misses;
+    CGUITextLayout::GetCacheStats(hits, misses);
+    unsigned int frameHits = hits - m_layoutHits, frameMisses = misses - m_layoutMisses;
+    m_layoutHits = hits;
+    m_layoutMisses = misses;
+    if (frameHits + frameMisses)
+      info.AppendFormat("\nTEXT: %u/%u layouts cached (%2.0f%%)", frameHits, frameHits + frameMisses, 100.0f * frameHits / (frameHits + frameMisses));
+
+    float p50, p95, p99;
+    if (CGUIFrameProfiler::Instance().GetFramePercentiles(p50, p95, p99))
+      info.AppendFormat("\nFRAME: p50 %.2f ms - p95 %.2f ms - p99 %.2f ms", p50, p95, p99);
+    CGUIFrameProfiler::SubsystemTimes times;
+    CGUIFrameProfiler::Instance().GetLastFrameTimes(times);
+    for (CGUIFrameProfiler::SubsystemTimes::const_iterator i = times.begin(); i != times.end(); ++i)
+      info.AppendFormat("\n  %s: %.2f ms", i->first.c_str(), i->second);
   }
 
   // render the skin debug info
@@ -143,6 +170,10 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       if (control)
         info.AppendFormat("Focused: %i (%s)", control->GetID(), CGUIControlFactory::TranslateControlType(control->GetControlType()).c_str());
     }
+#if defined(HAS_GL)
+    const GUITextureBatchStats &stats = CGUITextureGL::GetBatchStats();
+    info.AppendFormat("\nTextures: %u quads in %u draw calls (%u texture changes)", stats.quads, stats.drawCalls, stats.stateChanges);
+#endif
   }
 
   float w, h;
@@ -41,6 +41,8 @@ protected:
   virtual void UpdateVisibility();
 private:
   CGUITextLayout *m_layout;
+  unsigned int m_layoutHits;     // text layout cache counters at the previous frame
+  unsigned int m_layoutMisses;
 #ifdef _LINUX
   CLinuxResourceCounter m_resourceCounter;
 #endif
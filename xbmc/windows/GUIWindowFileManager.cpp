@@ -710,7 +710,11 @@ void CGUIWindowFileManager::OnCopy(int iList)
   m_errorHeading = 16201;
   m_errorLine    = 16202;
 
-  CJobManager::GetInstance().AddJob(new CFileOperationJob(CFileOperationJob::ActionCopy, *m_vecItems[iList], m_Directory[1 - iList]->GetPath()), this);
+  CFileOperationJob *job = new CFileOperationJob(CFileOperationJob::ActionCopy, *m_vecItems[iList], m_Directory[1 - iList]->GetPath());
+  // transfers over the network are mostly latency bound, so overlap a few of them
+  if (!URIUtils::IsHD(m_Directory[iList]->GetPath()) || !URIUtils::IsHD(m_Directory[1 - iList]->GetPath()))
+    job->SetConcurrentCopies(3);
+  CJobManager::GetInstance().AddJob(job, this);
 }
 
 void CGUIWindowFileManager::OnMove(int iList)
@@ -723,7 +727,11 @@ void CGUIWindowFileManager::OnMove(int iList)
   m_errorHeading = 16203;
   m_errorLine    = 16204;
 
-  CJobManager::GetInstance().AddJob(new CFileOperationJob(CFileOperationJob::ActionMove, *m_vecItems[iList], m_Directory[1 - iList]->GetPath()), this);
+  CFileOperationJob *job = new CFileOperationJob(CFileOperationJob::ActionMove, *m_vecItems[iList], m_Directory[1 - iList]->GetPath());
+  // transfers over the network are mostly latency bound, so overlap a few of them
+  if (!URIUtils::IsHD(m_Directory[iList]->GetPath()) || !URIUtils::IsHD(m_Directory[1 - iList]->GetPath()))
+    job->SetConcurrentCopies(3);
+  CJobManager::GetInstance().AddJob(job, this);
 }
 
 void CGUIWindowFileManager::OnDelete(int iList)